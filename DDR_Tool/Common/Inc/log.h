@@ -46,7 +46,10 @@
   * @{
   */
 #if defined (__LOG_TRACE_IO_)
-#define SYSTEM_TRACE_BUF_SZ 2048
+#define SYSTEM_TRACE_BUF_SZ 2048              /*!< power of 2, in bytes */
+#define LOG_TRACE_MAGIC     0x4C4F4754U       /*!< "TGOL" */
+#define LOG_TRACE_FMT_MASK  0x00FFFFFFU       /*!< format offset in .log_fmt */
+#define LOG_TRACE_MAX_ARGS  8U
 #endif
 
 #define LOGQUIET 0
@@ -68,7 +71,27 @@
   * @{
   */
 #if defined (__LOG_TRACE_IO_)
-extern char system_log_buf[SYSTEM_TRACE_BUF_SZ]; /*!< buffer for debug traces */
+/*
+ * Binary trace buffer: the log_* macros do not format the message on the
+ * target but record one entry per call:
+ *   word 0 : format offset in .log_fmt [23:0], nb args [27:24], level [31:28]
+ *   word 1 : HAL_GetTick()
+ *   then each argument as a 64-bit value (low word first).
+ * The format strings are kept in the .log_fmt section of the elf file only.
+ * Entries are written in a circular buffer, the oldest ones being dropped.
+ * Scripts/logtrace/log_trace.py rebuilds the messages from a dump of
+ * system_log_trace and from the elf file.
+ */
+typedef struct
+{
+  uint32_t magic;         /*!< LOG_TRACE_MAGIC */
+  uint32_t size;          /*!< buffer size in words */
+  volatile uint32_t head; /*!< next word to write, free running */
+  volatile uint32_t tail; /*!< first word of the oldest entry, free running */
+  uint32_t buf[SYSTEM_TRACE_BUF_SZ / 4]; /*!< buffer for debug traces */
+} log_trace_t;
+
+extern log_trace_t system_log_trace;
 #endif /* __LOG_TRACE_IO_ */
 /**
   * @}
@@ -77,7 +100,71 @@ extern char system_log_buf[SYSTEM_TRACE_BUF_SZ]; /*!< buffer for debug traces */
 /** @addtogroup STM32MP1xx_Log_Exported_Macros
   * @{
   */
-#if defined (__LOG_TRACE_IO_) || defined(__LOG_UART_IO_)
+#if defined (__LOG_TRACE_IO_)
+#define LOG_TRACE_CAT_(a, b)    a##b
+#define LOG_TRACE_CAT(a, b)     LOG_TRACE_CAT_(a, b)
+/* Counts up to 16 arguments, log_trace() accepts LOG_TRACE_MAX_ARGS */
+#define LOG_TRACE_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, \
+                         _12, _13, _14, _15, _16, n, ...) n
+#define LOG_TRACE_NARGS(...) \
+  LOG_TRACE_NARGS_(0, ##__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, \
+                   8, 7, 6, 5, 4, 3, 2, 1, 0)
+
+/* Each argument stored as a 64-bit raw value, floating point not supported */
+#define LOG_TRACE_ARG(x)        , (uint64_t)(uintptr_t)(x)
+#define LOG_TRACE_MAP_0(...)
+#define LOG_TRACE_MAP_1(a)      LOG_TRACE_ARG(a)
+#define LOG_TRACE_MAP_2(a, ...) LOG_TRACE_ARG(a) LOG_TRACE_MAP_1(__VA_ARGS__)
+#define LOG_TRACE_MAP_3(a, ...) LOG_TRACE_ARG(a) LOG_TRACE_MAP_2(__VA_ARGS__)
+#define LOG_TRACE_MAP_4(a, ...) LOG_TRACE_ARG(a) LOG_TRACE_MAP_3(__VA_ARGS__)
+#define LOG_TRACE_MAP_5(a, ...) LOG_TRACE_ARG(a) LOG_TRACE_MAP_4(__VA_ARGS__)
+#define LOG_TRACE_MAP_6(a, ...) LOG_TRACE_ARG(a) LOG_TRACE_MAP_5(__VA_ARGS__)
+#define LOG_TRACE_MAP_7(a, ...) LOG_TRACE_ARG(a) LOG_TRACE_MAP_6(__VA_ARGS__)
+#define LOG_TRACE_MAP_8(a, ...) LOG_TRACE_ARG(a) LOG_TRACE_MAP_7(__VA_ARGS__)
+/* Too many arguments, only reported by the check of log_trace() */
+#define LOG_TRACE_MAP_9(...)
+#define LOG_TRACE_MAP_10(...)
+#define LOG_TRACE_MAP_11(...)
+#define LOG_TRACE_MAP_12(...)
+#define LOG_TRACE_MAP_13(...)
+#define LOG_TRACE_MAP_14(...)
+#define LOG_TRACE_MAP_15(...)
+#define LOG_TRACE_MAP_16(...)
+#define LOG_TRACE_MAP(...) \
+  LOG_TRACE_CAT(LOG_TRACE_MAP_, LOG_TRACE_NARGS(__VA_ARGS__))(__VA_ARGS__)
+
+#define log_trace(level, fmt, ...) \
+  do { \
+    _Static_assert(LOG_TRACE_NARGS(__VA_ARGS__) <= LOG_TRACE_MAX_ARGS, \
+                   "too many log_trace arguments"); \
+    static const char log_fmt[] __attribute__((section(".log_fmt"), used)) = fmt; \
+    log_trace_write(((uint32_t)(uintptr_t)log_fmt & LOG_TRACE_FMT_MASK) | \
+                    ((uint32_t)LOG_TRACE_NARGS(__VA_ARGS__) << 24) | \
+                    ((uint32_t)(level) << 28), \
+                    (const uint64_t []){ 0U LOG_TRACE_MAP(__VA_ARGS__) } + 1); \
+  } while (0)
+
+#if LOGLEVEL >= LOGDBG
+#define log_dbg(fmt, ...)  log_trace(LOGDBG, fmt, ##__VA_ARGS__)
+#else
+#define log_dbg(fmt, ...)
+#endif
+#if LOGLEVEL >= LOGINFO
+#define log_info(fmt, ...) log_trace(LOGINFO, fmt, ##__VA_ARGS__)
+#else
+#define log_info(fmt, ...)
+#endif
+#if LOGLEVEL >= LOGWARN
+#define log_warn(fmt, ...) log_trace(LOGWARN, fmt, ##__VA_ARGS__)
+#else
+#define log_warn(fmt, ...)
+#endif
+#if LOGLEVEL >= LOGERR
+#define log_err(fmt, ...)  log_trace(LOGERR, fmt, ##__VA_ARGS__)
+#else
+#define log_err(fmt, ...)
+#endif
+#elif defined(__LOG_UART_IO_)
 #if LOGLEVEL >= LOGDBG
 #define log_dbg(fmt, ...)  printf("[%05ld.%03ld][DBG  ]" fmt, HAL_GetTick()/1000, HAL_GetTick() % 1000, ##__VA_ARGS__)
 #else
@@ -111,6 +198,9 @@ extern char system_log_buf[SYSTEM_TRACE_BUF_SZ]; /*!< buffer for debug traces */
 /** @addtogroup STM32MP1xx_Log_Exported_Functions
   * @{
   */
+#if defined (__LOG_TRACE_IO_)
+void log_trace_write(uint32_t header, const uint64_t *args);
+#endif /* __LOG_TRACE_IO_ */
 
 /**
   * @}
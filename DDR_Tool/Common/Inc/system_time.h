@@ -33,8 +33,8 @@
 /* Exported functions ------------------------------------------------------- */
 
 void delay_us(unsigned long delay_us);
-__IO uint32_t timeout_init_us(unsigned long timeout_us);
-bool timeout_elapsed(__IO uint32_t timeout);
+uint64_t timeout_init_us(unsigned long timeout_us);
+bool timeout_elapsed(uint64_t timeout);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,80 @@
+/**
+  ******************************************************************************
+  * @file    log_trace.c
+  * @author  MCD Application Team
+  * @brief   Binary trace backend of the logging services.
+  *          The log_* macros record the format string offset, the tick and the
+  *          raw arguments in a circular buffer; the messages are formatted on
+  *          host side (Scripts/logtrace/log_trace.py).
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "log.h"
+
+#if defined (__LOG_TRACE_IO_)
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define LOG_TRACE_SIZE      (SYSTEM_TRACE_BUF_SZ / 4U)
+#define LOG_TRACE_MASK      (LOG_TRACE_SIZE - 1U)
+
+/* Private macro -------------------------------------------------------------*/
+#define LOG_TRACE_LEN(header) (2U + (2U * (((header) >> 24) & 0xFU)))
+
+/* Private variables ---------------------------------------------------------*/
+log_trace_t system_log_trace =
+{
+  .magic = LOG_TRACE_MAGIC,
+  .size = LOG_TRACE_SIZE,
+};
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Records a log entry in the trace buffer.
+  *         Not reentrant: not to be used from an interrupt handler.
+  * @param  header format offset, number of arguments and level
+  * @param  args arguments, as 64-bit values
+  * @retval None
+  */
+void log_trace_write(uint32_t header, const uint64_t *args)
+{
+  log_trace_t *trace = &system_log_trace;
+  uint32_t len = LOG_TRACE_LEN(header);
+  uint32_t head = trace->head;
+  uint32_t tail = trace->tail;
+  uint32_t i;
+
+  /* Drop the oldest entries to make room */
+  while ((head + len - tail) > LOG_TRACE_SIZE)
+  {
+    tail += LOG_TRACE_LEN(trace->buf[tail & LOG_TRACE_MASK]);
+  }
+  trace->tail = tail;
+
+  trace->buf[head++ & LOG_TRACE_MASK] = header;
+  trace->buf[head++ & LOG_TRACE_MASK] = HAL_GetTick();
+
+  for (i = 2U; i < len; i += 2U)
+  {
+    trace->buf[head++ & LOG_TRACE_MASK] = (uint32_t)*args;
+    trace->buf[head++ & LOG_TRACE_MASK] = (uint32_t)(*args >> 32);
+    args++;
+  }
+
+  trace->head = head;
+}
+
+#endif /* __LOG_TRACE_IO_ */
@@ -19,6 +19,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "system_time.h"
+#include "stm32mp2xx_hal_ddr_timer.h"
 
 /** @addtogroup STM32MP1xx_HAL_Examples
   * @{
@@ -42,43 +43,27 @@
   */
 void delay_us(unsigned long delay_us)
 {
-  __IO uint32_t wait_loop_index = 0U;
-
-  wait_loop_index = (delay_us * (SystemCoreClock / (1000000UL * 2UL)));
-
-  while(wait_loop_index != 0UL)
-  {
-    wait_loop_index--;
-  }
+  ddr_timer_delay_us((uint32_t)delay_us);
 }
 
 /**
   * @brief  This function handles timeout initialization service.
-  * @param  delay_us: timeout in microseconds
-  * @retval None
+  * @param  timeout_us: timeout in microseconds
+  * @retval Deadline to be checked with timeout_elapsed()
   */
-__IO uint32_t timeout_init_us(unsigned long timeout_us)
+uint64_t timeout_init_us(unsigned long timeout_us)
 {
-  __IO uint32_t wait_loop_index = 0U;
-
-  wait_loop_index = timeout_us * (SystemCoreClock / (1000000UL * 2UL));
-
-  return wait_loop_index;
+  return ddr_timer_timeout_init_us((uint32_t)timeout_us);
 }
 
 /**
   * @brief  This function handles timeout elapsed checking service.
-  * @param  delay_us: timeout in microseconds
-  * @retval None
+  * @param  timeout: deadline returned by timeout_init_us()
+  * @retval true if timeout has elapsed
   */
-bool timeout_elapsed(__IO uint32_t timeout)
+bool timeout_elapsed(uint64_t timeout)
 {
-  if (timeout == 0U)
-  {
-    return true;
-  }
-
-  return false;
+  return ddr_timer_timeout_elapsed(timeout);
 }
 
 /**
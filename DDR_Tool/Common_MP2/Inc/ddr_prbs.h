@@ -0,0 +1,61 @@
+/**
+  ******************************************************************************
+  * @file    ddr_prbs.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_prbs.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_PRBS_H
+#define __DDR_PRBS_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+/*
+ * PRBS generator, one 64-bit data word at a time:
+ * - whole bus (lanes = 0): the word holds the next 64 bits of the sequence,
+ * - per lane (lanes = data bus width): the word holds 64 / lanes beats, bit
+ *   <l> of each beat being the next bit of the sequence of the DQ lane <l>,
+ *   phase shifted by PRBS_LANE_SHIFT bits from the lane <l - 1>.
+ */
+typedef struct {
+  uint8_t tap[32];      /* exponents e of the x^e terms of the recurrence */
+  uint32_t nb_taps;
+  uint64_t history;     /* whole bus: next 64 bits of the sequence */
+  uint32_t chunk;       /* whole bus: bits computed per step */
+  uint32_t degree;
+  uint32_t lanes;
+  uint32_t index;       /* per lane: next beat */
+  uint32_t beat[64];    /* per lane: last beats, indexed modulo 64 */
+} prbs_gen;
+
+/* Exported constants --------------------------------------------------------*/
+/*
+ * Polynomial argument: 7, 15, 23 or 31 for the ITU-T O.150 PRBS7 (x^7+x^6+1),
+ * PRBS15 (x^15+x^14+1), PRBS23 (x^23+x^18+1) or PRBS31 (x^31+x^28+1), 0 for
+ * PRBS31, any other value being a polynomial given by its terms (bit e for
+ * x^e, the constant term being implicit), for example 0xC0 for PRBS7.
+ * Seed: the first <degree> bits of the sequence, 0 for all ones.
+ */
+#define PRBS_DEFAULT_POLY 31U
+#define PRBS_LANE_SHIFT   17U
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+int32_t Prbs_Init(prbs_gen *prbs, uint32_t poly, uint32_t seed, uint32_t lanes);
+uint64_t Prbs_Next(prbs_gen *prbs);
+
+#endif /* __DDR_PRBS_H */
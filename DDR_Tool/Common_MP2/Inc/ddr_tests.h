@@ -53,10 +53,21 @@ uint32_t DDR_Test_WalkingZeroes(unsigned long size, unsigned long loop_in,
                                 unsigned long addr_in);
 uint32_t DDR_Test_WalkingOnes(unsigned long size, unsigned long loop_in,
                               unsigned long addr_in);
+uint32_t DDR_Test_Prbs(unsigned long size, unsigned long poly,
+                       unsigned long seed);
+uint32_t DDR_Test_PrbsLane(unsigned long size, unsigned long poly,
+                           unsigned long seed);
+uint32_t DDR_Test_Crosstalk(unsigned long size, unsigned long loop_in,
+                            unsigned long addr_in);
+uint32_t DDR_Test_Soak(unsigned long size, unsigned long time_s,
+                       unsigned long bits_exp);
 #ifdef TEST_INFINITE_ENABLE
 uint32_t DDR_Test_Infinite_write(unsigned long pattern_in,
                                  unsigned long addr_in);
 uint32_t DDR_Test_Infinite_read(unsigned long pattern_in,
                                 unsigned long addr_in);
+uint32_t DDR_Test_Infinite_burst(unsigned long config_in,
+                                 unsigned long pattern_in,
+                                 unsigned long addr_in);
 #endif
 #endif /* __DDR_TESTS_H */
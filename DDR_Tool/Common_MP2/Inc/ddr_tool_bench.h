@@ -0,0 +1,84 @@
+/**
+  ******************************************************************************
+  * @file    ddr_tool_bench.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_tool_bench.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_TOOL_BENCH_H
+#define __DDR_TOOL_BENCH_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/*
+ * Refresh benchmark, in DDR_READY step: the refresh configurations below are
+ * applied in turn (RFSHCTL0, RFSHCTL3, RFSHTMG, and MR3 for DDR4):
+ * - current: as configured,
+ * - refi/2: refresh interval halved (rate of the extended temperature range),
+ * - refi*2: refresh interval doubled, out of the JEDEC specification,
+ * - burst8: up to 8 refreshes postponed and issued in a burst,
+ * - DDR4 fgr2x/fgr4x: fine granularity refresh, tREFI/2 (4), tRFC2 (4)
+ *   estimated as 3/4 (9/16) of tRFC1, which covers all the densities,
+ * - LPDDR4 allbank/perbank: the other refresh command type, tREFIab =
+ *   8 x tREFIpb, tRFCab = 2 x tRFCpb.
+ * For each one are measured:
+ * - the sustained read then write bandwidth of the CPU (64-bit sequential
+ *   accesses over BENCH_BW_SIZE bytes, best of 3),
+ * - the latency of BENCH_NB_HOPS dependent loads (pointer chase over a
+ *   random cycle of 64-byte lines): median, 99th and 99.9th percentiles and
+ *   maximum, refresh showing in the tail,
+ * - a retention check: a PRBS31 pattern is written, kept <wait> seconds
+ *   while the DDR is read elsewhere (no self-refresh), then checked.
+ * The report gives the bandwidth gain against the current settings beside
+ * the risk: JEDEC compliance and retention errors. The initial settings are
+ * restored at the end, or when any key is received on the console.
+ * The first 3 x 16MB of the DDR are overwritten.
+ */
+#define BENCH_BW_SIZE        0x1000000U
+#define BENCH_NB_HOPS        0x10000U
+#define BENCH_DEFAULT_WAIT   1U /* s */
+
+/*
+ * Low-power benchmark, in DDR_READY step: the low-power settings below are
+ * applied in turn (PWRCTL, PWRTMG, HWLPCTL, DFILPCFG0), from the least to
+ * the most aggressive, after the current ones:
+ * - off: no power-down, no self-refresh, no hardware low-power interface,
+ * - pdN: power-down after N x 32 idle DFI cycles, pd1dfi: with the PHY in
+ *   DFI low power during power-down,
+ * - srN: self-refresh after N x 32 idle DFI cycles (power-down after 32),
+ *   sr1dfi: with the PHY in DFI low power, sr1clk: DRAM clock stopped too.
+ * For each one are measured:
+ * - the first-access latency: one load after an idle gap of 0 (back to
+ *   back), 1, 10, 100 and 1000 us, median and maximum of BENCH_LP_SAMPLES,
+ * - the bursty throughput: BENCH_LP_BURST bytes read after each idle gap
+ *   of 2 and 20 us, in MB/s during the bursts.
+ * The most aggressive setting whose median first-access latencies all fit
+ * in the latency budget (ns) is recommended. DFILPCFG1 (DDR4 maximum power
+ * saving mode) is not swept. The initial settings are restored at the end,
+ * or when any key is received on the console.
+ */
+#define BENCH_LP_DEFAULT_BUDGET 1000U /* ns */
+#define BENCH_LP_SAMPLES        32U
+#define BENCH_LP_BURST          0x1000U
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+int32_t Bench_Refresh(uint32_t wait_s);
+int32_t Bench_LowPower(uint32_t budget_ns);
+
+#endif /* __DDR_TOOL_BENCH_H */
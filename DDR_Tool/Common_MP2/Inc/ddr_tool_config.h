@@ -0,0 +1,59 @@
+/**
+  ******************************************************************************
+  * @file    ddr_tool_config.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_tool_config.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_TOOL_CONFIG_H
+#define __DDR_TOOL_CONFIG_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+/*
+ * DDR configuration blob, all fields little endian:
+ *
+ *   offset  size
+ *        0     4  magic, DDR_CONFIG_MAGIC
+ *        4     2  version, DDR_CONFIG_VERSION
+ *        6     2  header size, DDR_CONFIG_HEADER_SIZE
+ *        8     4  number of 32-bit words of the body
+ *       12     4  speed in kHz (info.speed)
+ *       16     8  size in bytes (info.size)
+ *       24    36  name, NUL padded (info.name)
+ *       60     4  CRC-32 (IEEE 802.3, as zlib) of bytes 0..59 and of the body
+ *       64        body: the HAL_DDR_ConfigTypeDef fields from c_reg to p_pll,
+ *                 one 32-bit word per register or parameter, in declaration
+ *                 order
+ *
+ * The number of words of the body depends on the HAL configuration
+ * (STM32MP_DDR_DUAL_AXI_PORT), a blob built for another configuration is
+ * rejected. The blob is generated from a DDR settings header (template or
+ * "save" command output) by Scripts/ddrconfig/ddr_config_load.py.
+ */
+
+/* Exported constants --------------------------------------------------------*/
+#define DDR_CONFIG_MAGIC       0x43524444U /* "DDRC" */
+#define DDR_CONFIG_VERSION     1U
+#define DDR_CONFIG_HEADER_SIZE 64U
+#define DDR_CONFIG_NAME_SIZE   36U
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+int32_t DDR_Config_Load(void);
+
+#endif /* __DDR_TOOL_CONFIG_H */
@@ -0,0 +1,57 @@
+/**
+  ******************************************************************************
+  * @file    ddr_tool_jedec.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_tool_jedec.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_TOOL_JEDEC_H
+#define __DDR_TOOL_JEDEC_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/*
+ * JEDEC timing calculator: from the DRAM type (ddr3, ddr4 or lpddr4), the
+ * density (Gbits per x16 device, per channel for LPDDR4), the data bus width
+ * (16 or 32), the speed bin (MT/s) and the target frequency (MHz, at most
+ * half the speed bin), the JEDEC timings of the slowest bin of this data rate
+ * are rounded to clock cycles (0.025 tCK guard) and programmed in:
+ * - the controller timings: MSTR, RFSHTMG, RFSHTMG1, INIT3/4/6/7, RANKCTL1,
+ *   DRAMTMG0 to 9, 13 and 14, ZQCTL0, DFITMG0, DFITMG2 and ODTCFG,
+ * - the mode registers (latencies, write recovery) and the PHY settings
+ *   depending on them (frequency, LPDDR4 RL/WL/nWR),
+ * - the PLL2 settings and the DDR information (name, speed, size).
+ * The other settings (address map, QoS, PHY drive, ODT and swizzle) are kept
+ * from the current configuration; the mode register bits not depending on
+ * the frequency too, when the DRAM type is the built one, else the values of
+ * the ST reference configurations are used.
+ *
+ * The result is printed as a configuration template (#define block). It can
+ * also replace the current configuration, in step 0 and for the DRAM type
+ * of the build only, before the DDR initialization.
+ */
+#define JEDEC_MAX_FREQ  2133U /* MHz */
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+void Jedec_List(void);
+int32_t Jedec_Set(const char *param, const char *value);
+int32_t Jedec_Run(bool apply);
+
+#endif /* __DDR_TOOL_JEDEC_H */
@@ -0,0 +1,61 @@
+/**
+  ******************************************************************************
+  * @file    ddr_tool_record.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_tool_record.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_TOOL_RECORD_H
+#define __DDR_TOOL_RECORD_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+/*
+ * Record frame, interleaved with the console text:
+ *
+ *   | 0xA5 | 0x5A | type | seq (16-bit LE) | len (16-bit LE) | payload | crc |
+ *
+ * payload is a CBOR map (RFC 8949) of len bytes, crc is the CRC-16/CCITT
+ * (polynomial 0x1021, initial value 0xFFFF) of type, seq, len and payload,
+ * sent little endian. seq is incremented on each frame, so that the host can
+ * detect lost records.
+ */
+typedef enum {
+  RECORD_CMD   = 1, /* {"cmd": text, "step": uint} */
+  RECORD_TEST  = 2, /* {"id": uint, "name": text, "res": uint}, res 0 = pass */
+  RECORD_ERROR = 3, /* {"test": text, "addr": uint, "exp": uint, "act": uint} */
+  RECORD_REG   = 4, /* {"reg": text, "val": uint} */
+} record_type;
+
+/* Exported constants --------------------------------------------------------*/
+#define RECORD_SOF0        0xA5U
+#define RECORD_SOF1        0x5AU
+#define RECORD_MAX_PAYLOAD 256U
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+void Record_Enable(bool enable);
+bool Record_IsEnabled(void);
+void Record_Command(const char *cmd, uint32_t step, bool has_result,
+                    uint32_t result);
+void Record_TestResult(uint32_t id, const char *name, uint32_t result);
+void Record_TestMismatch(const char *test, uint64_t addr, uint64_t expected,
+                         uint64_t actual);
+void Record_Register(const char *name, uint32_t value);
+
+#endif /* __DDR_TOOL_RECORD_H */
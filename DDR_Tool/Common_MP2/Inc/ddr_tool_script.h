@@ -0,0 +1,73 @@
+/**
+  ******************************************************************************
+  * @file    ddr_tool_script.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_tool_script.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_TOOL_SCRIPT_H
+#define __DDR_TOOL_SCRIPT_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/*
+ * A script is a text of console commands, one per line, executed on target
+ * as if typed at the DDR> prompt, across the DDR steps. On top of the
+ * console commands, a script line can be:
+ *
+ *   # comment                   ignored, also at the end of a line
+ *   set <var> <value>           sets a variable, used as $var or ${var}
+ *   for <var> <item> [...]      executes the lines up to the matching "end"
+ *   end                         for each item, an item being a value or a
+ *                               range <first>..<last>
+ *   onfail stop|continue        policy on a failed test or command
+ *                               (default: stop)
+ *
+ * Example:
+ *   for f 1200000 1066000
+ *   step 0
+ *   freq $f
+ *   step 5
+ *   for t 1..3
+ *   test $t 0x10000 0x80000000
+ *   end
+ *   end
+ *
+ * A summary is printed at the end of the script: the executed commands with
+ * the failed ones (other than "test"), then the executed tests with the
+ * passed and failed ones.
+ * Any key received on the console aborts the script.
+ */
+#define SCRIPT_MAX_LINES      256U
+#define SCRIPT_LINE_LEN       128U
+#define SCRIPT_MAX_DEPTH      4U
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+int32_t Script_Load(void);
+void Script_List(void);
+int32_t Script_Run(void);
+bool Script_IsRunning(void);
+int32_t Script_GetLine(char *entry, uint32_t size);
+void Script_Result(uint32_t result);
+void Script_CommandResult(uint32_t result);
+bool Script_GetResult(uint32_t *result);
+void Script_Abort(const char *reason);
+
+#endif /* __DDR_TOOL_SCRIPT_H */
@@ -0,0 +1,57 @@
+/**
+  ******************************************************************************
+  * @file    ddr_tool_traffic.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_tool_traffic.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_TOOL_TRAFFIC_H
+#define __DDR_TOOL_TRAFFIC_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/*
+ * Concurrent traffic, in DDR_READY step: two masters access the DDR at the
+ * same time (the DDR controller port used by each master is not selected):
+ * - the CPU: 64-bit loads and stores, one every <cpu_stride> bytes, over the
+ *   first TRAFFIC_REGION_SIZE bytes of the DDR,
+ * - HPDMA1: linked list of TRAFFIC_DMA_NODES blocks, each one either read
+ *   from the DDR to the SYSRAM or written from the SYSRAM to the DDR, by
+ *   bursts of <dma_burst> 64-bit beats, one every <dma_stride> bytes (0 for
+ *   contiguous bursts), over the next TRAFFIC_REGION_SIZE bytes.
+ * The read percentage and the target rate (MB/s, 0 for no limit) are set per
+ * master. The achieved bandwidth of each master is reported at the end of
+ * the run, or when any key is received on the console.
+ * The host build (DDR_HOST_SIM) has no DMA: the CPU traffic runs alone.
+ *
+ * The HPDMA1 traffic alone (same parameters, without rate limit) is also
+ * the background load of the "qos" workload, see Traffic_LoadStart().
+ */
+#define TRAFFIC_REGION_SIZE   0x1000000U
+#define TRAFFIC_DMA_NODES     10U
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+void Traffic_List(void);
+int32_t Traffic_Set(const char *param, uint32_t value);
+int32_t Traffic_Run(uint32_t time_s);
+int32_t Traffic_LoadStart(void);
+int32_t Traffic_LoadPoll(uint64_t *bytes);
+int32_t Traffic_LoadStop(uint64_t *bytes);
+
+#endif /* __DDR_TOOL_TRAFFIC_H */
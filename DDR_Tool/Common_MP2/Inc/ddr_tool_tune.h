@@ -0,0 +1,68 @@
+/**
+  ******************************************************************************
+  * @file    ddr_tool_tune.h
+  * @author  MCD Application Team
+  * @brief   Header for ddr_tool_tune.c module
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DDR_TOOL_TUNE_H
+#define __DDR_TOOL_TUNE_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/*
+ * Timing tuning, in DDR_READY step: each DRAMTMGx, RFSHTMG and ODTCFG field
+ * of the list is lowered one step at a time, while the fast test set passes
+ * on the first <size> bytes of the DDR. The field is then set to its minimum
+ * passing value plus a guard band (in register steps), never above its
+ * initial value, and the next field is tuned with this value in place.
+ *
+ * The fast test set is: DataBusWalking0, DataBusWalking1, NoiseBurst and
+ * Random (1 loop). Only the timings exercised by this read/write traffic are
+ * tuned (no mode register, power-down or self-refresh timing).
+ * Any key received on the console stops the tuning, the field in progress
+ * being restored.
+ */
+#define TUNE_DEFAULT_GUARD   1U
+#define TUNE_DEFAULT_SIZE    0x100000U
+
+/*
+ * QoS and scheduler tuning, in DDR_READY step: coordinate descent over the
+ * SCHED, SCHED1, SCHED3, SCHED4, PERFHPR1, PERFLPR1, PERFWR1 fields and the
+ * PCFGR/PCFGW/PCFGQOSx/PCFGWQOSx fields of one AXI port, each field taking
+ * in turn the candidate value giving the best throughput of a synthetic
+ * workload, until no field improves it by 1%: CPU accesses (read percentage,
+ * stride) with the HPDMA1 traffic of ddr_tool_traffic.h in the background,
+ * so that the controller queues hold several transactions. The best
+ * configuration is kept and printed with its gain against the initial
+ * settings. A sweep measures all the candidate values of one field, a port
+ * field being named with its port (suffix _0 or _1).
+ * The workload overwrites the first 32MB of the DDR.
+ */
+#define TUNE_QOS_DEFAULT_READ    70U
+#define TUNE_QOS_DEFAULT_STRIDE  64U
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+void Tune_List(void);
+int32_t Tune_Run(const char *field, uint32_t guard, uint32_t size);
+void Tune_QosList(void);
+int32_t Tune_QosSweep(const char *field, uint32_t rd_pct, uint32_t stride);
+int32_t Tune_QosRun(uint32_t rd_pct, uint32_t stride, uint32_t port);
+
+#endif /* __DDR_TOOL_TUNE_H */
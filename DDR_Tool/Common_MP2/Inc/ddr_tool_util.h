@@ -22,15 +22,48 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include <stdio.h>
+#include <stdint.h>
 
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
+/* Confirmation sent by the host at the new baud rate after a baud switch */
+#define SERIAL_BAUD_SYNC "OK"
+
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
+/*
+ * CRC-16/CCITT (polynomial 0x1021, MSB first, no final XOR) of <len> bytes,
+ * from <init>: 0 for XMODEM, 0xFFFF for the record frames.
+ */
+static inline uint16_t util_crc16(const uint8_t *data, uint32_t len, uint16_t init)
+{
+  uint16_t crc = init;
+  uint32_t i;
+  uint8_t bit;
+
+  for (i = 0; i < len; i++)
+  {
+    crc ^= (uint16_t)data[i] << 8;
+
+    for (bit = 0; bit < 8U; bit++)
+    {
+      crc = ((crc & 0x8000U) != 0U) ? (uint16_t)((crc << 1) ^ 0x1021U) :
+                                       (uint16_t)(crc << 1);
+    }
+  }
+
+  return crc;
+}
+
 void UART_Config(void);
 uint32_t Serial_Scanf(uint32_t value);
+int32_t Serial_GetByte(uint8_t *data, uint32_t timeout_us);
 void Serial_Putchar(char value);
 void Serial_Printf(char *value, int len);
+void Serial_Flush(void);
+uint32_t Serial_GetBaudrate(void);
+int32_t Serial_SetBaudrate(uint32_t baudrate, uint32_t timeout_ms);
+void Serial_IRQHandler(void);
 void Error_Handler(void);
 void valid_delay_us(unsigned long delay_us);
 
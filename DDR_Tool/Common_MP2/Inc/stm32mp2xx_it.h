@@ -39,6 +39,7 @@ void SVC_Handler(void);
 void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
+void el3_curr_el_spx_irq_vector(void);
 
 #ifdef __cplusplus
 }
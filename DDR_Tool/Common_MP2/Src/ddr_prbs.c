@@ -0,0 +1,294 @@
+/**
+  ******************************************************************************
+  * @file    ddr_prbs.c
+  * @author  MCD Application Team
+  * @brief   PRBS data patterns for the DDR tests, see ddr_prbs.h.
+  *          The sequence of a polynomial p is b[t] = XOR(b[t - e]) over the
+  *          x^e terms of p. It is computed by words instead of bits:
+  *          - whole bus: p is squared (p(x)^2 = p(x^2) over GF(2), which the
+  *            sequence also satisfies) until its lowest term reaches 32, so
+  *            that 32 new bits only depend on the 64 previous ones: two steps
+  *            per 64-bit word,
+  *          - per lane: all the lanes follow the same recurrence, computed on
+  *            the beat vectors (one bit per lane): one step per beat.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "string.h"
+#include "ddr_prbs.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define PRBS7_TAPS   ((1UL << 7) | (1UL << 6))
+#define PRBS15_TAPS  ((1UL << 15) | (1UL << 14))
+#define PRBS23_TAPS  ((1UL << 23) | (1UL << 18))
+#define PRBS31_TAPS  ((1UL << 31) | (1UL << 28))
+
+/* Bits computed per step by the whole bus generator */
+#define PRBS_MAX_CHUNK 32U
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t prbs_msb(uint64_t value)
+{
+  uint32_t n = 0U;
+
+  while ((value >>= 1) != 0U)
+  {
+    n++;
+  }
+
+  return n;
+}
+
+static uint32_t prbs_lsb(uint64_t value)
+{
+  uint32_t n = 0U;
+
+  while ((value & 1U) == 0U)
+  {
+    value >>= 1;
+    n++;
+  }
+
+  return n;
+}
+
+static uint32_t prbs_parity(uint64_t value)
+{
+  value ^= value >> 32;
+  value ^= value >> 16;
+  value ^= value >> 8;
+  value ^= value >> 4;
+  value ^= value >> 2;
+  value ^= value >> 1;
+
+  return (uint32_t)(value & 1U);
+}
+
+/* p(x)^2 = p(x^2) over GF(2) */
+static uint64_t prbs_square(uint64_t taps)
+{
+  uint64_t square = 0U;
+  uint32_t e;
+
+  for (e = 1U; e < 32U; e++)
+  {
+    if ((taps & (1ULL << e)) != 0U)
+    {
+      square |= 1ULL << (2U * e);
+    }
+  }
+
+  return square;
+}
+
+static void prbs_set_taps(prbs_gen *prbs, uint64_t taps)
+{
+  uint32_t e;
+
+  prbs->nb_taps = 0U;
+  for (e = 1U; e < 64U; e++)
+  {
+    if ((taps & (1ULL << e)) != 0U)
+    {
+      prbs->tap[prbs->nb_taps++] = (uint8_t)e;
+    }
+  }
+}
+
+/**
+  * @brief  Initializes a PRBS generator.
+  * @param  prbs generator
+  * @param  poly 7, 15, 23, 31 (0 for 31) or polynomial terms, see ddr_prbs.h
+  * @param  seed first bits of the sequence, 0 for all ones
+  * @param  lanes 0 for the whole bus, else number of DQ lanes (8, 16 or 32)
+  * @retval 0 if success, -1 for an invalid polynomial, seed or lanes
+  */
+int32_t Prbs_Init(prbs_gen *prbs, uint32_t poly, uint32_t seed, uint32_t lanes)
+{
+  uint64_t taps;
+  uint64_t reg = 0U;    /* last bits, bit 0 the newest */
+  uint64_t mask;
+  uint32_t nb_bits;
+  uint32_t bit;
+  uint32_t t;
+  uint32_t l;
+
+  switch (poly)
+  {
+    case 0U:
+    case 31U:
+      taps = PRBS31_TAPS;
+      break;
+    case 7U:
+      taps = PRBS7_TAPS;
+      break;
+    case 15U:
+      taps = PRBS15_TAPS;
+      break;
+    case 23U:
+      taps = PRBS23_TAPS;
+      break;
+    default:
+      taps = poly & ~1UL;
+      break;
+  }
+
+  if ((taps == 0U) || (prbs_msb(taps) < 2U))
+  {
+    return -1;
+  }
+
+  if ((lanes > 32U) || ((lanes != 0U) && ((64U % lanes) != 0U)))
+  {
+    return -1;
+  }
+
+  memset(prbs, 0, sizeof(*prbs));
+  prbs->degree = prbs_msb(taps);
+  prbs->lanes = lanes;
+
+  mask = (1ULL << prbs->degree) - 1U;
+  if (seed == 0U)
+  {
+    seed = (uint32_t)mask;
+  }
+  if ((seed & mask) == 0U)
+  {
+    /* all zeros: locked sequence */
+    return -1;
+  }
+
+  /*
+   * First bits of the sequence, bit by bit: 64 for the whole bus, up to the
+   * first <degree> bits of the last lane otherwise.
+   */
+  nb_bits = (lanes == 0U) ? 64U : (((lanes - 1U) * PRBS_LANE_SHIFT) + prbs->degree);
+
+  for (t = 0U; t < nb_bits; t++)
+  {
+    if (t < prbs->degree)
+    {
+      bit = (seed >> t) & 1U;
+    }
+    else
+    {
+      bit = prbs_parity(reg & (taps >> 1));
+    }
+    reg = (reg << 1) | bit;
+
+    if (lanes == 0U)
+    {
+      prbs->history |= (uint64_t)bit << t;
+    }
+    else
+    {
+      for (l = 0U; l < lanes; l++)
+      {
+        if ((t >= (l * PRBS_LANE_SHIFT)) && ((t - (l * PRBS_LANE_SHIFT)) < prbs->degree))
+        {
+          prbs->beat[t - (l * PRBS_LANE_SHIFT)] |= bit << l;
+        }
+      }
+    }
+  }
+
+  if (lanes == 0U)
+  {
+    while ((prbs_lsb(taps) < PRBS_MAX_CHUNK) && ((2U * prbs_msb(taps)) < 64U))
+    {
+      taps = prbs_square(taps);
+    }
+    prbs->chunk = prbs_lsb(taps);
+    if (prbs->chunk > PRBS_MAX_CHUNK)
+    {
+      prbs->chunk = PRBS_MAX_CHUNK;
+    }
+  }
+
+  prbs_set_taps(prbs, taps);
+
+  return 0;
+}
+
+/**
+  * @brief  Computes the next data word of a PRBS generator.
+  * @param  prbs generator
+  * @retval 64-bit data word
+  */
+uint64_t Prbs_Next(prbs_gen *prbs)
+{
+  uint64_t data;
+  uint64_t bits;
+  uint32_t done;
+  uint32_t chunk;
+  uint32_t beat;
+  uint32_t value;
+  uint32_t i;
+
+  if (prbs->lanes == 0U)
+  {
+    /* history bit i = b[t + i]: b[t + 64 + j - e] = history bit (64 + j - e) */
+    data = prbs->history;
+
+    /* Standard polynomials: two terms, two steps of 32 bits */
+    if ((prbs->nb_taps == 2U) && (prbs->chunk == PRBS_MAX_CHUNK))
+    {
+      bits = ((data >> (64U - prbs->tap[0])) ^ (data >> (64U - prbs->tap[1]))) & 0xFFFFFFFFU;
+      bits = (data >> 32) | (bits << 32);
+      prbs->history = (bits >> 32) |
+                      (((bits >> (64U - prbs->tap[0])) ^ (bits >> (64U - prbs->tap[1]))) << 32);
+      return data;
+    }
+
+    for (done = 0U; done < 64U; done += chunk)
+    {
+      chunk = ((64U - done) < prbs->chunk) ? (64U - done) : prbs->chunk;
+
+      bits = 0U;
+      for (i = 0U; i < prbs->nb_taps; i++)
+      {
+        bits ^= prbs->history >> (64U - prbs->tap[i]);
+      }
+      bits &= (1ULL << chunk) - 1U;
+
+      prbs->history = (prbs->history >> chunk) | (bits << (64U - chunk));
+    }
+
+    return data;
+  }
+
+  data = 0U;
+  for (beat = 0U; beat < (64U / prbs->lanes); beat++)
+  {
+    if (prbs->index >= prbs->degree)
+    {
+      value = 0U;
+      for (i = 0U; i < prbs->nb_taps; i++)
+      {
+        value ^= prbs->beat[(prbs->index - prbs->tap[i]) & 63U];
+      }
+      prbs->beat[prbs->index & 63U] = value;
+    }
+
+    data |= (uint64_t)prbs->beat[prbs->index & 63U] << (beat * prbs->lanes);
+    prbs->index++;
+  }
+
+  return data;
+}
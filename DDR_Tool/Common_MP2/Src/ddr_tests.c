@@ -23,7 +23,11 @@
 #include "stdlib.h"
 #include "string.h"
 #include "log.h"
+#include "ddr_prbs.h"
 #include "ddr_tests.h"
+#include "ddr_tool_record.h"
+#include "ddr_tool_util.h"
+#include "stm32mp2xx_hal_ddr_timer.h"
 
 #include "stm32mp_util_conf.h"
 #include "stm32mp_util_ddr_conf.h"
@@ -32,8 +36,45 @@
 /* Private define ------------------------------------------------------------*/
 #define DDR_BASE_ADDR                        0x80000000
 
+/*
+ * Infinite burst test configuration word:
+ *   bits 31:24 write duty cycle in % of the bursts (0 = read only)
+ *   bits 23:16 log2 of the stride in bytes between bursts (0 = contiguous)
+ *   bits 15:12 pattern: 0 fixed, 1 pattern / ~pattern, 2 PRBS31 seeded by it
+ *   bits 11:0  burst length in 64-bit words, rounded up to 4
+ */
+#define INFINITE_BURST_DFLT_CONFIG           0x32001100UL
+#define INFINITE_BURST_DUTY_POS              24
+#define INFINITE_BURST_STRIDE_POS            16
+#define INFINITE_BURST_PATTERN_POS           12
+#define INFINITE_BURST_LEN_MASK              0xFFFUL
+#define INFINITE_BURST_MAX_LEN               1024U /* 64-bit words */
+#define INFINITE_BURST_NB_SLOTS              64U   /* bursts before wrapping */
+#define INFINITE_BURST_REPORT_US             1000000U
+
+#define SOAK_DFLT_TIME                       60U       /* s */
+#define SOAK_REPORT_US                       60000000U /* progress each minute */
+#define SOAK_MAX_BITS_EXP                    19U       /* 10^19 < 2^64 */
+#define SOAK_NB_MISMATCH                     8U        /* printed and recorded */
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+extern HAL_DDR_ConfigTypeDef static_ddr_config;
+
+/*
+ * Poisson 95% upper limit of the mean, in hundredths, for 0 to 20 observed
+ * errors; then E + 1.645 x sqrt(E + 1) + 1.55 (within 0.2%)
+ */
+static const uint16_t soak_upper_95[] = {
+  300, 474, 630, 775, 915, 1051, 1184, 1315, 1443, 1571, 1696,
+  1821, 1944, 2067, 2189, 2310, 2430, 2550, 2669, 2788, 2906
+};
+
+#ifdef TEST_INFINITE_ENABLE
+/* Data of one burst, prepared in internal memory */
+static uint64_t infinite_burst_data[INFINITE_BURST_MAX_LEN];
+#endif
+
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 static int get_addr(unsigned long addr_in, uintptr_t **addr)
@@ -183,6 +224,7 @@ uint32_t DDR_Test_Databus(unsigned long addr_in)
     if (*addr != pattern)
     {
       printf("  test_databus KO @ 0x%lx \n\r", (unsigned long)addr);
+      Record_TestMismatch("test_databus", (uintptr_t)addr, pattern, *addr);
       return 2;
     }
   }
@@ -225,6 +267,9 @@ static int test_databuswalk(uint8_t mode, unsigned long loop_in, unsigned long a
         error |= 1 << i;
         printf("  0x%lx: error 0x%lx expected 0x%lx => error:0x%lx\n\r",
                (unsigned long)(addr + sizeof(unsigned long) * i), data, pattern, error);
+        Record_TestMismatch("test_databuswalk",
+                            (uintptr_t)(addr + sizeof(unsigned long) * i),
+                            pattern, data);
       }
     }
 
@@ -412,6 +457,7 @@ uint32_t DDR_Test_AddressBus(unsigned long size_in, unsigned long addr_in)
     {
       printf("  test_addrbus KO @ 0x%lx \n\r", (unsigned long)(addr + offset));
       printf("  read 0x%lx instead of 0x%lx\n\r", data, pattern);
+      Record_TestMismatch("test_addrbus", (uintptr_t)(addr + offset), pattern, data);
       return 4;
     }
   }
@@ -431,6 +477,7 @@ uint32_t DDR_Test_AddressBus(unsigned long size_in, unsigned long addr_in)
     {
       printf("  test_addrbus KO @ 0x%lx \n\r", (unsigned long)(addr + testoffset));
       printf("  read 0x%lx instead of 0x%lx\n\r", data, pattern);
+      Record_TestMismatch("test_addrbus", (uintptr_t)(addr + testoffset), pattern, data);
       return 5;
     }
 
@@ -444,6 +491,7 @@ uint32_t DDR_Test_AddressBus(unsigned long size_in, unsigned long addr_in)
       {
         printf("  test_addrbus KO @ 0x%lx \n\r", (unsigned long)(addr + offset));
         printf("  read 0x%lx instead of 0x%lx\n\r", data, pattern);
+        Record_TestMismatch("test_addrbus", (uintptr_t)(addr + offset), pattern, data);
         return 6;
       }
     }
@@ -511,6 +559,8 @@ uint32_t DDR_Test_MemDevice(unsigned long size_in, unsigned long addr_in)
     if (*(addr + offset) != pattern)
     {
       printf("  test_memdevice KO @ 0x%lx \n\r", (unsigned long)(addr + offset));
+      Record_TestMismatch("test_memdevice", (uintptr_t)(addr + offset),
+                          pattern, *(addr + offset));
       return 3;
     }
 
@@ -526,6 +576,8 @@ uint32_t DDR_Test_MemDevice(unsigned long size_in, unsigned long addr_in)
     if (*(addr + offset) != antipattern)
     {
       printf("  test_memdevice KO @ 0x%lx \n\r", (unsigned long)(addr + offset));
+      Record_TestMismatch("test_memdevice", (uintptr_t)(addr + offset),
+                          antipattern, *(addr + offset));
       return 4;
     }
   }
@@ -613,6 +665,8 @@ uint32_t DDR_Test_SimultaneousSwitchingOutput(unsigned long size_in,
         if (*(addr + offset) != data)
         {
           printf("  test_sso KO @ 0x%lx \n\r", (unsigned long)(addr + offset));
+          Record_TestMismatch("test_sso", (uintptr_t)(addr + offset), data,
+                              *(addr + offset));
           return 3;
         }
       }
@@ -624,6 +678,23 @@ uint32_t DDR_Test_SimultaneousSwitchingOutput(unsigned long size_in,
   return 0;
 }
 
+#if defined(DDR_HOST_SIM)
+/* Host build: same accesses as the AArch64 sequence below */
+static void do_noise(unsigned long addr, unsigned long pattern,
+                     unsigned long *result)
+{
+  volatile unsigned long *ptr = (volatile unsigned long *)addr;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+  {
+    *ptr = pattern;
+    result[i] = *ptr;
+    *ptr = ~pattern;
+    result[i + 1] = *ptr;
+  }
+}
+#else /* DDR_HOST_SIM */
 static void do_noise(unsigned long addr, unsigned long pattern,
                      unsigned long *result)
 {
@@ -678,6 +749,7 @@ static void do_noise(unsigned long addr, unsigned long pattern,
                     [result]  "r" (result)
                   : "x0", "x1", "x12");
 }
+#endif /* DDR_HOST_SIM */
 
 
 /**
@@ -723,12 +795,14 @@ uint32_t DDR_Test_Noise(unsigned long pattern_in, unsigned long addr_in)
     if (*(&result[i++]) != pattern)
     {
       printf("  test_noise KO @ 0x%lx \n\r", result[i - 1]);
+      Record_TestMismatch("test_noise", (uintptr_t)addr, pattern, result[i - 1]);
       return 2;
     }
 
     if (*(&result[i++]) != ~pattern)
     {
       printf("  test_noise KO @ 0x%lx \n\r", result[i - 1]);
+      Record_TestMismatch("test_noise", (uintptr_t)addr, ~pattern, result[i - 1]);
       return 3;
     }
   }
@@ -736,6 +810,25 @@ uint32_t DDR_Test_Noise(unsigned long pattern_in, unsigned long addr_in)
   return 0;
 }
 
+#if defined(DDR_HOST_SIM)
+/* Host build: same accesses as the AArch64 sequence below */
+static void do_noiseburst(unsigned long addr, unsigned long pattern,
+                          unsigned long bufsize)
+{
+  volatile unsigned long *ptr = (volatile unsigned long *)addr;
+  long remaining = (long)bufsize;
+  int i;
+
+  do
+  {
+    for (i = 0; i < 32; i++)
+    {
+      *ptr++ = ((i & 1) == 0) ? pattern : ~pattern;
+    }
+    remaining -= 256;
+  } while (remaining >= 0);
+}
+#else /* DDR_HOST_SIM */
 static void do_noiseburst(unsigned long addr, unsigned long pattern,
                           unsigned long bufsize)
 {
@@ -797,6 +890,7 @@ static void do_noiseburst(unsigned long addr, unsigned long pattern,
                     [bufsize] "r" (bufsize)
                   : "x0", "x1", "x10");
 }
+#endif /* DDR_HOST_SIM */
 
 #define DDR_CHUNK_SIZE  0x08000000
 
@@ -868,6 +962,7 @@ uint32_t DDR_Test_NoiseBurst(unsigned long size_in, unsigned long pattern_in,
     {
       printf("  test_noiseburst KO @ 0x%lx\n\r", (unsigned long)(addr + i));
       printf("  read 0x%lx instead of 0x%lx\n\r", data, pattern);
+      Record_TestMismatch("test_noiseburst", (uintptr_t)(addr + i), pattern, data);
       return 3;
     }
 
@@ -878,6 +973,7 @@ uint32_t DDR_Test_NoiseBurst(unsigned long size_in, unsigned long pattern_in,
     {
       printf("  test_noiseburst KO @ 0x%lx\n\r", (unsigned long)(addr + i));
       printf("  read 0x%lx instead of 0x%lx\n\r", data, pattern);
+      Record_TestMismatch("test_noiseburst", (uintptr_t)(addr + i), ~pattern, data);
       return 4;
     }
 
@@ -967,6 +1063,8 @@ uint32_t DDR_Test_Random(unsigned long size_in, unsigned long loop_in,
         error++;
         printf("  loop %d: error @ 0x%lx: 0x%lx expected 0x%lx\n\r",
                loop, (unsigned long)(addr + offset), data, value);
+        Record_TestMismatch("test_random", (uintptr_t)(addr + offset), value,
+                            data);
         break;
       }
     }
@@ -989,6 +1087,25 @@ uint32_t DDR_Test_Random(unsigned long size_in, unsigned long loop_in,
 #define DDR_PATTERN_SIZE  8
 
 /* pattern test, optimized loop for read/write pattern (array of 8 u32) */
+#if defined(DDR_HOST_SIM)
+/* Host build: same accesses as the AArch64 sequence below */
+static void test_loop_in(const unsigned long *pattern, unsigned long offset,
+                         unsigned long testsize)
+{
+  volatile unsigned long *ptr = (volatile unsigned long *)offset;
+  long remaining = (long)testsize;
+  int i;
+
+  do
+  {
+    for (i = 0; i < 32; i++)
+    {
+      *ptr++ = pattern[i % DDR_PATTERN_SIZE];
+    }
+    remaining -= 256;
+  } while (remaining >= 0);
+}
+#else /* DDR_HOST_SIM */
 static void test_loop_in(const unsigned long *pattern, unsigned long offset,
                          unsigned long testsize)
 {
@@ -1048,6 +1165,7 @@ static void test_loop_in(const unsigned long *pattern, unsigned long offset,
                       [testsize] "r" (testsize)
                     : "x0", "x1", "x2");
 }
+#endif /* DDR_HOST_SIM */
 
 static int test_loop(const unsigned long *pattern, uintptr_t *address,
                      const unsigned long bufsize)
@@ -1080,6 +1198,8 @@ static int test_loop(const unsigned long *pattern, uintptr_t *address,
       if (*(address + offset) != pattern[j])
       {
         printf("  test_freqpattern KO @ 0x%lx\n\r", (unsigned long)(address + offset));
+        Record_TestMismatch("test_freqpattern", (uintptr_t)(address + offset),
+                            pattern[j], *(address + offset));
         return 1;
       }
     }
@@ -1132,6 +1252,19 @@ const unsigned long pattern_mostly_one_x32[DDR_PATTERN_SIZE] = {
 #define DDRCTRL_MSTR_DATA_BUS_WIDTH_HALF    DDRC_MSTR_DATA_BUS_WIDTH_0
 #define DDRCTRL_MSTR_DATA_BUS_WIDTH_QUARTER DDRC_MSTR_DATA_BUS_WIDTH_1
 
+/* Data bus width in bits, from the DDRC configuration */
+static int get_bus_width(void)
+{
+  switch (READ_REG(DDRC->MSTR) & DDRC_MSTR_DATA_BUS_WIDTH_Msk)
+  {
+    case DDRCTRL_MSTR_DATA_BUS_WIDTH_HALF:
+    case DDRCTRL_MSTR_DATA_BUS_WIDTH_QUARTER:
+      return 16;
+    default:
+      return 32;
+  }
+}
+
 /**
 * @brief test_freqpattern.
 * @par Test Description
@@ -1189,16 +1322,7 @@ uint32_t DDR_Test_FrequencySelectivePattern(unsigned long size,
     return 2;
   }
 
-  switch (READ_REG(DDRC->MSTR) & DDRC_MSTR_DATA_BUS_WIDTH_Msk)
-  {
-    case DDRCTRL_MSTR_DATA_BUS_WIDTH_HALF:
-    case DDRCTRL_MSTR_DATA_BUS_WIDTH_QUARTER:
-      bus_width = 16;
-      break;
-    default:
-      bus_width = 32;
-      break;
-  }
+  bus_width = get_bus_width();
 
   patterns = (const unsigned long **)(bus_width == 16 ? patterns_x16 : patterns_x32);
 
@@ -1241,6 +1365,7 @@ static int test_loop_size(const unsigned long *pattern, unsigned long size,
       if (*addr != pattern[j])
       {
         printf("  test KO @ 0x%lx\n\r", (unsigned long)addr);
+        Record_TestMismatch("test_loop", (uintptr_t)addr, pattern[j], *addr);
         return 1;
       }
     }
@@ -1684,6 +1809,639 @@ uint32_t DDR_Test_WalkingOnes(unsigned long size, unsigned long loop_in,
   return 0;
 }
 
+/*
+ * PRBS pattern written on the whole buffer then checked, all the errors
+ * being counted: the DQ lanes in error (bit % bus width) are reported.
+ */
+static uint32_t test_prbs(const char *name, unsigned long size,
+                          unsigned long poly, unsigned long seed, bool per_lane)
+{
+  volatile uint64_t *addr = (volatile uint64_t *)DDR_MEM_BASE;
+  unsigned long bufsize;
+  unsigned long nb_words;
+  unsigned long offset;
+  unsigned long error = 0U;
+  uint64_t diff;
+  uint64_t value;
+  uint32_t lanes_ko = 0U;
+  int bus_width;
+  int bit;
+  prbs_gen prbs;
+
+  if (get_buf_size(size, &bufsize, 4 * 1024, 8) != 0)
+  {
+    return 1;
+  }
+
+  bus_width = get_bus_width();
+
+  if ((poly > 0xFFFFFFFFUL) || (seed > 0xFFFFFFFFUL) ||
+      (Prbs_Init(&prbs, (uint32_t)poly, (uint32_t)seed,
+                 per_lane ? (uint32_t)bus_width : 0U) != 0))
+  {
+    printf("Invalid polynomial 0x%lx or seed 0x%lx\n\r", poly, seed);
+    return 2;
+  }
+
+  nb_words = bufsize / sizeof(uint64_t);
+
+  for (offset = 0; offset < nb_words; offset++)
+  {
+    addr[offset] = Prbs_Next(&prbs);
+  }
+
+  (void)Prbs_Init(&prbs, (uint32_t)poly, (uint32_t)seed,
+                  per_lane ? (uint32_t)bus_width : 0U);
+
+  for (offset = 0; offset < nb_words; offset++)
+  {
+    value = Prbs_Next(&prbs);
+    diff = addr[offset] ^ value;
+    if (diff != 0U)
+    {
+      if (error == 0U)
+      {
+        printf("  error @ 0x%lx: 0x%lx expected 0x%lx\n\r",
+               (unsigned long)&addr[offset], (unsigned long)addr[offset],
+               (unsigned long)value);
+        Record_TestMismatch(name, (uintptr_t)&addr[offset], value, value ^ diff);
+      }
+      error++;
+
+      for (bit = 0; bit < 64; bit++)
+      {
+        if ((diff & (1ULL << bit)) != 0U)
+        {
+          lanes_ko |= 1U << (bit % bus_width);
+        }
+      }
+    }
+  }
+
+  if (error != 0U)
+  {
+    printf("  %s KO: %lu words in error, DQ lanes 0x%x\n\r", name, error,
+           (unsigned int)lanes_ko);
+    return 3;
+  }
+
+  return 0;
+}
+
+/**
+* @brief test_prbs.
+* @par Test Description
+*   PRBS pattern on the whole data bus: each 64-bit word holds the next 64
+*   bits of the sequence (PRBS7, 15, 23, 31 or given polynomial), written
+*   from the DDR base address then checked.
+* @par Test Hardware Connection
+* - None
+* @par Required preconditions
+* - None
+* @par Expected result
+* - None
+* @par Called functions
+* - Prbs_Init, Prbs_Next
+* @par Used Peripherals
+* - None,...
+* @retval
+*  0: Test passed
+*  Value different from 0: Test failed
+*  None(0xFF): if the result is deduced by the user: waveform, event...
+*/
+uint32_t DDR_Test_Prbs(unsigned long size, unsigned long poly,
+                       unsigned long seed)
+{
+  return test_prbs("test_prbs", size, poly, seed, false);
+}
+
+/**
+* @brief test_prbs_lane.
+* @par Test Description
+*   PRBS pattern per DQ lane: each lane receives its own sequence, phase
+*   shifted from the previous lane, one bit per beat, written from the DDR
+*   base address then checked. The lanes in error are reported.
+* @par Test Hardware Connection
+* - None
+* @par Required preconditions
+* - None
+* @par Expected result
+* - None
+* @par Called functions
+* - Prbs_Init, Prbs_Next
+* @par Used Peripherals
+* - None,...
+* @retval
+*  0: Test passed
+*  Value different from 0: Test failed
+*  None(0xFF): if the result is deduced by the user: waveform, event...
+*/
+uint32_t DDR_Test_PrbsLane(unsigned long size, unsigned long poly,
+                           unsigned long seed)
+{
+  return test_prbs("test_prbs_lane", size, poly, seed, true);
+}
+
+#define XTALK_NB_MODES 3
+
+static const char * const xtalk_mode[XTALK_NB_MODES] = {
+  "low", "high", "opposite"
+};
+
+/*
+ * Physical order of the DQ pins: order[pin] = data bit driven on the pin,
+ * for 8 * byte + pin. With LPDDR4, the PHY swizzle settings uis
+ * swizzle[8 * byte + pin] give the DFI data bit of each DQ pin (DqnLnSel);
+ * an identity order is used for the other memory types, or when the
+ * settings of a byte are not a permutation.
+ */
+static void get_dq_order(int bus_width, uint8_t *order)
+{
+  int byte;
+  int pin;
+  uint32_t used;
+
+  for (byte = 0; byte < (bus_width / 8); byte++)
+  {
+    used = 0U;
+    for (pin = 0; pin < 8; pin++)
+    {
+#if STM32MP_LPDDR4_TYPE
+      order[(8 * byte) + pin] = (uint8_t)((8 * byte) +
+                                (static_ddr_config.p_uis.swizzle[(8 * byte) + pin] & 0x7));
+#else /* STM32MP_LPDDR4_TYPE */
+      order[(8 * byte) + pin] = (uint8_t)((8 * byte) + pin);
+#endif /* STM32MP_LPDDR4_TYPE */
+      used |= 1U << (order[(8 * byte) + pin] - (8 * byte));
+    }
+
+    if (used != 0xFFU)
+    {
+      printf("  byte %d: invalid swizzle, identity order used\n\r", byte);
+      for (pin = 0; pin < 8; pin++)
+      {
+        order[(8 * byte) + pin] = (uint8_t)((8 * byte) + pin);
+      }
+    }
+  }
+}
+
+/*
+ * 64-bit word of the crosstalk pattern: the aggressors toggle at each beat,
+ * the victim being held low, high or opposite to the aggressors, the other
+ * bits being held low.
+ */
+static unsigned long xtalk_word(int bus_width, uint32_t victim,
+                                uint32_t aggressors, int mode)
+{
+  unsigned long word = 0;
+  uint32_t value;
+  int beat;
+
+  for (beat = 0; beat < (64 / bus_width); beat++)
+  {
+    value = ((beat & 1) == 0) ? aggressors : 0U;
+    if ((mode == 1) || ((mode == 2) && (value == 0U)))
+    {
+      value |= victim;
+    }
+    word |= (unsigned long)value << (beat * bus_width);
+  }
+
+  return word;
+}
+
+/**
+* @brief test_crosstalk.
+* @par Test Description
+*   Aggressor/victim crosstalk: for each victim DQ bit, in the physical order
+*   of the pins given by the PHY swizzle settings, its physical neighbours
+*   (previous and next pins of the byte) toggle at each beat while the victim
+*   is held low, high, then opposite to them, the other bits being quiet.
+*   Each pattern is written in long bursts over the buffer then checked; the
+*   errors are counted per victim and mode.
+* @par Test Hardware Connection
+* - None
+* @par Required preconditions
+* - None
+* @par Expected result
+* - None
+* @par Called functions
+* - xxx
+* @par Used Peripherals
+* - None,...
+* @retval
+*  0: Test passed
+*  Value different from 0: Test failed
+*  None(0xFF): if the result is deduced by the user: waveform, event...
+*/
+uint32_t DDR_Test_Crosstalk(unsigned long size, unsigned long loop_in,
+                            unsigned long addr_in)
+{
+  unsigned long pattern[DDR_PATTERN_SIZE];
+  unsigned long errors[32][XTALK_NB_MODES];
+  unsigned long bufsize;
+  unsigned long offset;
+  unsigned long data;
+  unsigned long diff;
+  unsigned long total = 0U;
+  uint32_t nb_loop;
+  uint32_t loop = 0;
+  uint32_t victim;
+  uint32_t aggressors;
+  uint32_t mask;
+  uintptr_t *addr = NULL;
+  uint8_t order[32];
+  int bus_width;
+  int pin;
+  int mode;
+  int beat;
+  int i;
+
+  if (get_buf_size(size, &bufsize, 4 * 1024, 256) != 0)
+  {
+    return 1;
+  }
+
+  get_nb_loop(loop_in, &nb_loop, 1);
+
+  if (get_addr(addr_in, &addr) != 0)
+  {
+    return 2;
+  }
+
+  bus_width = get_bus_width();
+  mask = (bus_width == 32) ? 0xFFFFFFFFU : ((1U << bus_width) - 1U);
+  get_dq_order(bus_width, order);
+  memset(errors, 0, sizeof(errors));
+
+  while (1)
+  {
+    for (pin = 0; pin < bus_width; pin++)
+    {
+      victim = 1U << order[pin];
+      aggressors = 0U;
+      if ((pin % 8) != 0)
+      {
+        aggressors |= 1U << order[pin - 1];
+      }
+      if ((pin % 8) != 7)
+      {
+        aggressors |= 1U << order[pin + 1];
+      }
+
+      for (mode = 0; mode < XTALK_NB_MODES; mode++)
+      {
+        for (i = 0; i < DDR_PATTERN_SIZE; i++)
+        {
+          pattern[i] = xtalk_word(bus_width, victim, aggressors, mode);
+        }
+
+        /* test_loop_in() writes (testsize / 256 + 1) blocks of 256 bytes */
+        test_loop_in(pattern, (unsigned long)addr, bufsize - 256);
+
+        for (offset = 0; offset < (bufsize / sizeof(unsigned long)); offset++)
+        {
+          data = *(addr + offset);
+          diff = data ^ pattern[0];
+          if (diff == 0U)
+          {
+            continue;
+          }
+
+          if (total == 0U)
+          {
+            printf("  error @ 0x%lx: 0x%lx expected 0x%lx\n\r",
+                   (unsigned long)(addr + offset), data, pattern[0]);
+            Record_TestMismatch("test_crosstalk", (uintptr_t)(addr + offset),
+                                pattern[0], data);
+          }
+          total++;
+
+          for (beat = 0; beat < (64 / bus_width); beat++)
+          {
+            if (((diff >> (beat * bus_width)) & mask & victim) != 0U)
+            {
+              errors[pin][mode]++;
+            }
+          }
+        }
+      }
+    }
+
+    if (test_loop_end(&loop, nb_loop))
+    {
+      break;
+    }
+  }
+
+  if (total == 0U)
+  {
+    return 0;
+  }
+
+  printf("  victim      errors %8s %8s %8s\n\r", xtalk_mode[0], xtalk_mode[1],
+         xtalk_mode[2]);
+  for (pin = 0; pin < bus_width; pin++)
+  {
+    if ((errors[pin][0] + errors[pin][1] + errors[pin][2]) != 0U)
+    {
+      printf("  DQ%-2d (byte %d pin %d) %8lu %8lu %8lu\n\r", order[pin], pin / 8,
+             pin % 8, errors[pin][0], errors[pin][1], errors[pin][2]);
+    }
+  }
+  printf("  test_crosstalk KO: %lu words in error\n\r", total);
+
+  return 3;
+}
+
+static uint64_t soak_random(uint64_t *state)
+{
+  /* xorshift64 */
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+
+  return *state;
+}
+
+static uint32_t soak_popcount(uint64_t value)
+{
+  uint32_t n = 0U;
+
+  while (value != 0U)
+  {
+    value &= value - 1U;
+    n++;
+  }
+
+  return n;
+}
+
+static uint64_t soak_sqrt(uint64_t value)
+{
+  uint64_t root = 0U;
+  uint64_t bit = 1ULL << 62;
+
+  while (bit > value)
+  {
+    bit >>= 2;
+  }
+
+  while (bit != 0U)
+  {
+    if (value >= (root + bit))
+    {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+    {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  return root;
+}
+
+/*
+ * Prints num / den x 10^-scale as d.dde-xx without floating point, rounded
+ * up for a bound
+ */
+static void soak_print_ratio(uint64_t num, uint64_t den, int32_t scale, bool up)
+{
+  int32_t exp = scale;
+  uint64_t digit;
+  uint64_t rem;
+  uint64_t frac;
+
+  if ((den == 0U) || (num == 0U))
+  {
+    printf("0");
+    return;
+  }
+
+  while ((num / 10U) >= den)
+  {
+    num /= 10U;
+    exp--;
+  }
+
+  while (num < den)
+  {
+    if (num <= (UINT64_MAX / 100U))
+    {
+      num *= 10U;
+    }
+    else
+    {
+      den /= 10U;
+    }
+    exp++;
+  }
+
+  digit = num / den;
+  rem = (num % den) * 100U;
+  frac = rem / den;
+  if (up && ((rem % den) != 0U) && (++frac == 100U))
+  {
+    frac = 0U;
+    if (++digit == 10U)
+    {
+      digit = 1U;
+      exp--;
+    }
+  }
+
+  printf("%lu.%02lue%c%02ld", (unsigned long)digit, (unsigned long)frac,
+         (exp > 0) ? '-' : '+', (long)((exp > 0) ? exp : -exp));
+}
+
+static void soak_report(uint64_t bits, uint64_t errors, uint32_t elapsed_s)
+{
+  uint64_t upper;
+
+  if (errors < (sizeof(soak_upper_95) / sizeof(soak_upper_95[0])))
+  {
+    upper = soak_upper_95[errors];
+  }
+  else
+  {
+    upper = (errors * 100U) + ((1645U * soak_sqrt((errors + 1U) * 10000U)) / 1000U) + 155U;
+  }
+
+  printf("  %lu s: %lu Gbits, %lu bits in error, BER ", (unsigned long)elapsed_s,
+         (unsigned long)(bits / 1000000000U), (unsigned long)errors);
+  soak_print_ratio(errors, bits, 0, false);
+  printf(" < ");
+  soak_print_ratio(upper, bits, 2, true);
+  printf(" at 95%%\n\r");
+}
+
+/**
+* @brief test_soak.
+* @par Test Description
+*   Bit error rate soak: passes of PRBS31 (new seed per pass) and random
+*   (xorshift64) data written over the area from the DDR base address then
+*   checked, until the duration or the bit count is reached, or any key.
+*   The errored bits are counted and the BER is reported with its 95% upper
+*   bound (Poisson), e.g. "< 3.0e-15 at 95%" for 1e15 bits without error.
+* @par Test Hardware Connection
+* - None
+* @par Required preconditions
+* - None
+* @par Expected result
+* - None
+* @par Called functions
+* - Prbs_Init, Prbs_Next
+* @par Used Peripherals
+* - None,...
+* @retval
+*  0: Test passed
+*  Value different from 0: Test failed
+*  None(0xFF): if the result is deduced by the user: waveform, event...
+*/
+uint32_t DDR_Test_Soak(unsigned long size, unsigned long time_s,
+                       unsigned long bits_exp)
+{
+  volatile uint64_t *addr = (volatile uint64_t *)DDR_MEM_BASE;
+  unsigned long bufsize;
+  unsigned long nb_words;
+  unsigned long offset;
+  uint64_t max_bits = UINT64_MAX;
+  uint64_t bits = 0U;
+  uint64_t errors = 0U;
+  uint64_t words_ko = 0U;
+  uint64_t state;
+  uint64_t seed;
+  uint64_t value;
+  uint64_t diff;
+  uint64_t start;
+  uint64_t deadline;
+  uint64_t report;
+  uint32_t pass = 0U;
+  uint32_t elapsed_s = 0U;
+  uint32_t i;
+  bool prbs_pass;
+  bool stop = false;
+  uint8_t key;
+  prbs_gen prbs;
+
+  if (get_buf_size(size, &bufsize, (unsigned long)DDR_MEM_SIZE, 8) != 0)
+  {
+    return 1;
+  }
+
+  if (bits_exp > SOAK_MAX_BITS_EXP)
+  {
+    printf("Invalid bit count 10^%lu (max 10^%u)\n\r", bits_exp,
+           (unsigned int)SOAK_MAX_BITS_EXP);
+    return 1;
+  }
+
+  if (bits_exp != 0UL)
+  {
+    max_bits = 1U;
+    for (i = 0U; i < bits_exp; i++)
+    {
+      max_bits *= 10U;
+    }
+  }
+  else if (time_s == 0UL)
+  {
+    time_s = SOAK_DFLT_TIME;
+  }
+
+  nb_words = bufsize / sizeof(uint64_t);
+
+  printf("soak over 0x%lx bytes", bufsize);
+  if (time_s != 0UL)
+  {
+    printf(", %lu s", time_s);
+  }
+  if (bits_exp != 0UL)
+  {
+    printf(", 1e%lu bits", bits_exp);
+  }
+  printf(", any key to stop\n\r");
+
+  start = ddr_timer_get_count();
+  deadline = ddr_timer_timeout_init_us(0U) +
+             ((uint64_t)time_s * ddr_timer_get_freq());
+  report = ddr_timer_timeout_init_us(SOAK_REPORT_US);
+
+  while (!stop)
+  {
+    /* PRBS31 and random data in turn, seeds from the pass number */
+    prbs_pass = ((pass % 2U) == 0U);
+    seed = 0x9E3779B97F4A7C15ULL * (pass + 1U);
+    seed = ((seed >> 33) & 0x7FFFFFFFU) | 1U;
+
+    if (prbs_pass)
+    {
+      (void)Prbs_Init(&prbs, PRBS_DEFAULT_POLY, (uint32_t)seed, 0U);
+    }
+    state = seed;
+    for (offset = 0; offset < nb_words; offset++)
+    {
+      addr[offset] = prbs_pass ? Prbs_Next(&prbs) : soak_random(&state);
+    }
+
+    if (prbs_pass)
+    {
+      (void)Prbs_Init(&prbs, PRBS_DEFAULT_POLY, (uint32_t)seed, 0U);
+    }
+    state = seed;
+    for (offset = 0; offset < nb_words; offset++)
+    {
+      value = prbs_pass ? Prbs_Next(&prbs) : soak_random(&state);
+      diff = addr[offset] ^ value;
+      if (diff != 0U)
+      {
+        if (words_ko < SOAK_NB_MISMATCH)
+        {
+          printf("  error @ 0x%lx: 0x%lx expected 0x%lx\n\r",
+                 (unsigned long)&addr[offset], (unsigned long)(value ^ diff),
+                 (unsigned long)value);
+          Record_TestMismatch("test_soak", (uintptr_t)&addr[offset], value, value ^ diff);
+        }
+        words_ko++;
+        errors += soak_popcount(diff);
+      }
+    }
+
+    bits += (uint64_t)nb_words * 64U;
+    pass++;
+
+    elapsed_s = (uint32_t)((ddr_timer_get_count() - start) / ddr_timer_get_freq());
+
+    if ((bits >= max_bits) ||
+        ((time_s != 0UL) && (ddr_timer_get_count() >= deadline)) ||
+        (Serial_GetByte(&key, 0U) == 0))
+    {
+      stop = true;
+    }
+    else if (ddr_timer_timeout_elapsed(report))
+    {
+      soak_report(bits, errors, elapsed_s);
+      report = ddr_timer_timeout_init_us(SOAK_REPORT_US);
+    }
+  }
+
+  printf("  %lu passes\n\r", (unsigned long)pass);
+  soak_report(bits, errors, elapsed_s);
+
+  if (errors != 0U)
+  {
+    printf("  test_soak KO: %lu words, %lu bits in error\n\r",
+           (unsigned long)words_ko, (unsigned long)errors);
+    return 3;
+  }
+
+  return 0;
+}
+
 #ifdef TEST_INFINITE_ENABLE
 /**
 * @brief test infinite write access to DDR
@@ -1821,4 +2579,223 @@ uint32_t DDR_Test_Infinite_read(unsigned long pattern_in, unsigned long addr_in)
 
   return 0;
 }
+
+#if defined(DDR_HOST_SIM)
+/* Host build: same accesses as the AArch64 sequences below */
+static void do_infinite_burst_write(unsigned long dst, const uint64_t *src,
+                                    unsigned long len)
+{
+  volatile uint64_t *ptr = (volatile uint64_t *)dst;
+  unsigned long i;
+
+  for (i = 0; i < len; i++)
+  {
+    ptr[i] = src[i];
+  }
+}
+
+static void do_infinite_burst_read(unsigned long src, unsigned long len)
+{
+  volatile uint64_t *ptr = (volatile uint64_t *)src;
+  unsigned long i;
+
+  for (i = 0; i < len; i++)
+  {
+    (void)ptr[i];
+  }
+}
+#else /* DDR_HOST_SIM */
+/* len: number of 64-bit words, multiple of 4 */
+static void do_infinite_burst_write(unsigned long dst, const uint64_t *src,
+                                    unsigned long len)
+{
+  __asm volatile (
+                  "1:                       \n"
+                  "LDP x2, x3, [%[src]], #16\n"
+                  "LDP x4, x5, [%[src]], #16\n"
+                  "STP x2, x3, [%[dst]], #16\n"
+                  "STP x4, x5, [%[dst]], #16\n"
+                  "SUBS %[len], %[len], #4  \n"
+                  "B.NE 1b                  \n"
+                  :[dst] "+r" (dst),
+                   [src] "+r" (src),
+                   [len] "+r" (len)
+                  :
+                  : "x2", "x3", "x4", "x5", "cc", "memory");
+}
+
+static void do_infinite_burst_read(unsigned long src, unsigned long len)
+{
+  __asm volatile (
+                  "1:                       \n"
+                  "LDP x2, x3, [%[src]], #16\n"
+                  "LDP x4, x5, [%[src]], #16\n"
+                  "SUBS %[len], %[len], #4  \n"
+                  "B.NE 1b                  \n"
+                  :[src] "+r" (src),
+                   [len] "+r" (len)
+                  :
+                  : "x2", "x3", "x4", "x5", "cc", "memory");
+}
+#endif /* DDR_HOST_SIM */
+
+/**
+* @brief test infinite burst write/read access to DDR
+* @par Test Description
+*   Continuous bursts of 128-bit LDP/STP accesses, for the JEDEC compliance
+*   captures:
+*   each burst is a write or a read of the same data (pattern prepared in
+*   internal memory, written once in all the burst slots beforehand), the
+*   write bursts spread over the read ones per the duty cycle. The bursts
+*   follow each other at the stride on INFINITE_BURST_NB_SLOTS slots.
+*   The throughput is printed each second, measured on the timer counter
+*   outside of the print; a key on the console stops the test.
+* @par Test Hardware Connection
+* - None
+* @par Required preconditions
+* - None
+* @par Expected result
+* - None
+* @par Called functions
+* - Prbs_Init, Prbs_Next
+* @par Used Peripherals
+* - None,...
+* @retval
+*  0: Test passed
+*  Value different from 0: Test failed
+*  None(0xFF): if the result is deduced by the user: waveform, event...
+*/
+uint32_t DDR_Test_Infinite_burst(unsigned long config_in, unsigned long pattern_in,
+                                 unsigned long addr_in)
+{
+  uintptr_t *addr = NULL;
+  volatile uint64_t *dst;
+  unsigned long config;
+  unsigned long data;
+  unsigned long stride;
+  unsigned long burst_size;
+  uint32_t stride_log2;
+  uint32_t duty;
+  uint32_t kind;
+  uint32_t len;
+  uint32_t slot;
+  uint32_t acc = 0U;
+  uint32_t i;
+  uint64_t wr_bytes = 0U;
+  uint64_t rd_bytes = 0U;
+  uint64_t start;
+  uint64_t now;
+  uint64_t ticks;
+  uint32_t seconds = 0U;
+  uint8_t key;
+  volatile uint32_t go_loop = 1U;
+  unsigned long dflt_pattern = 0xA5A5AA55AAAA5555;
+  prbs_gen prbs;
+
+  if (get_addr(addr_in, &addr) != 0)
+  {
+    return 1;
+  }
+
+  get_pattern(pattern_in, &data, dflt_pattern);
+  config = (config_in != 0UL) ? config_in : INFINITE_BURST_DFLT_CONFIG;
+
+  duty = (uint32_t)(config >> INFINITE_BURST_DUTY_POS) & 0xFFU;
+  kind = (uint32_t)(config >> INFINITE_BURST_PATTERN_POS) & 0xFU;
+  len = (uint32_t)(config & INFINITE_BURST_LEN_MASK);
+  len = (len + 3U) & ~3U;
+  stride_log2 = (uint32_t)(config >> INFINITE_BURST_STRIDE_POS) & 0xFFU;
+  stride = 1UL << ((stride_log2 < 31U) ? stride_log2 : 31U);
+  burst_size = len * sizeof(uint64_t);
+  if (stride < burst_size)
+  {
+    stride = burst_size;
+  }
+
+  if ((duty > 100U) || (kind > 2U) || (len == 0U) || (len > INFINITE_BURST_MAX_LEN) ||
+      (stride_log2 > 30U) ||
+      ((stride * INFINITE_BURST_NB_SLOTS) > ((unsigned long)DDR_MEM_SIZE -
+                                             ((unsigned long)addr - DDR_MEM_BASE))))
+  {
+    printf("Invalid configuration 0x%lx\n\r", config);
+    return 1;
+  }
+
+  if ((kind == 2U) && (Prbs_Init(&prbs, PRBS_DEFAULT_POLY, (uint32_t)data, 0U) != 0))
+  {
+    printf("Invalid PRBS seed 0x%lx\n\r", data);
+    return 1;
+  }
+
+  for (i = 0U; i < len; i++)
+  {
+    switch (kind)
+    {
+      case 1U:
+        infinite_burst_data[i] = ((i & 1U) == 0U) ? data : ~data;
+        break;
+      case 2U:
+        infinite_burst_data[i] = Prbs_Next(&prbs);
+        break;
+      default:
+        infinite_burst_data[i] = data;
+        break;
+    }
+  }
+
+  /* The read bursts return the pattern too */
+  for (slot = 0U; slot < INFINITE_BURST_NB_SLOTS; slot++)
+  {
+    dst = (volatile uint64_t *)((unsigned long)addr + (slot * stride));
+    for (i = 0U; i < len; i++)
+    {
+      dst[i] = infinite_burst_data[i];
+    }
+  }
+
+  printf("running at 0x%lx: %lu%% write, bursts of %lu bytes every 0x%lx bytes, pattern %lu 0x%lx\n\r",
+         (unsigned long)addr, (unsigned long)duty, burst_size, stride,
+         (unsigned long)kind, data);
+
+  slot = 0U;
+  start = ddr_timer_get_count();
+  while (go_loop != 0U)
+  {
+    dst = (volatile uint64_t *)((unsigned long)addr + (slot * stride));
+    acc += duty;
+    if (acc >= 100U)
+    {
+      acc -= 100U;
+      do_infinite_burst_write((unsigned long)dst, infinite_burst_data, len);
+      wr_bytes += burst_size;
+    }
+    else
+    {
+      do_infinite_burst_read((unsigned long)dst, len);
+      rd_bytes += burst_size;
+    }
+
+    slot = (slot + 1U) % INFINITE_BURST_NB_SLOTS;
+
+    /* Timer counter only: no access on the DDR bus between the bursts */
+    now = ddr_timer_get_count();
+    ticks = now - start;
+    if (ticks >= ((uint64_t)ddr_timer_get_freq() * INFINITE_BURST_REPORT_US / 1000000U))
+    {
+      seconds++;
+      printf("%lu s: write %lu MB/s, read %lu MB/s\n\r", (unsigned long)seconds,
+             (unsigned long)(wr_bytes * ddr_timer_get_freq() / ticks / 1000000U),
+             (unsigned long)(rd_bytes * ddr_timer_get_freq() / ticks / 1000000U));
+      if (Serial_GetByte(&key, 0U) == 0)
+      {
+        break;
+      }
+      wr_bytes = 0U;
+      rd_bytes = 0U;
+      start = ddr_timer_get_count();
+    }
+  }
+
+  return 0;
+}
 #endif
@@ -22,7 +22,17 @@
 #include "string.h"
 #include "stdlib.h"
 #include "ddr_tool.h"
+#include "ddr_tool_bench.h"
+#include "ddr_tool_config.h"
+#include "ddr_tool_jedec.h"
+#include "ddr_tool_record.h"
+#include "ddr_tool_script.h"
+#include "ddr_tool_traffic.h"
+#include "ddr_tool_tune.h"
 #include "stm32mp_util_conf.h"
+#if (UTIL_USE_PMIC) && !defined(DDR_HOST_SIM)
+#include "main.h"
+#endif /* UTIL_USE_PMIC */
 
 /* Private typedef -----------------------------------------------------------*/
 typedef struct {
@@ -38,14 +48,25 @@ typedef enum {
   DDR_CMD_INFO,
   DDR_CMD_FREQ,
   DDR_CMD_RESET,
+  DDR_CMD_BAUD,
+  DDR_CMD_RECORD,
+  DDR_CMD_LOAD,
+  DDR_CMD_SCRIPT,
   DDR_CMD_PARAM,
   DDR_CMD_PRINT,
   DDR_CMD_EDIT,
   DDR_CMD_SAVE,
+  DDR_CMD_SNAP,
   DDR_CMD_STEP,
   DDR_CMD_NEXT,
   DDR_CMD_GO,
   DDR_CMD_TEST,
+  DDR_CMD_TUNE,
+  DDR_CMD_QOS,
+  DDR_CMD_TRAFFIC,
+  DDR_CMD_JEDEC,
+  DDR_CMD_BENCH,
+  DDR_CMD_VMARGIN,
   DDR_CMD_UNKNOWN,
   DDR_CMD_TEST_HELP,
   DDR_CMD_MAX,
@@ -65,7 +86,16 @@ typedef struct {
 /* Private define ------------------------------------------------------------*/
 #define CMD_MAX_LEN 1024
 #define CMD_MAX_ARG 5
+
+/*
+ * vmargin: default tests (bit n for test n) DataBus, AddressBus, SSO, PRBS,
+ * PRBS per lane and Crosstalk, and regulator steps in mV
+ */
+#define VMARGIN_DFLT_TESTS   0x000E0052UL
+#define VMARGIN_VDD1_STEP    100U
+#define VMARGIN_VDD2_STEP    10U
 #define DDR_NAME_MAX_LEN 128
+#define IHEX_RECORD_LEN 32U
 
 static uint32_t DDR_Test_All(uint32_t loop, uint32_t size, uint32_t addr);
 
@@ -106,11 +136,22 @@ const subcmd_desc test[] = {
    "test Walking Ones pattern", 3},
   {DDR_Test_WalkingOnes, "Test WalkingOnes", "[size] [loop] [addr]",
    "test Walking Zeroes pattern", 3},
+  {DDR_Test_Prbs, "Test PRBS", "[size] [poly] [seed]",
+   "PRBS on the whole bus, poly = 7, 15, 23, 31 (default) or terms", 3},
+  {DDR_Test_PrbsLane, "Test PRBS per lane", "[size] [poly] [seed]",
+   "PRBS per DQ lane, phase shifted, reports the lanes in error", 3},
+  {DDR_Test_Crosstalk, "Test Crosstalk", "[size] [loop] [addr]",
+   "victim DQ low/high/opposite while its physical neighbours toggle", 3},
+  {DDR_Test_Soak, "Test BER soak", "[size] [time] [bits]",
+   "PRBS31/random passes for time s or 10^bits bits, BER with 95% bound", 3},
 #ifdef TEST_INFINITE_ENABLE
   {DDR_Test_Infinite_write, "Test infinite write for JEDEC", "[pattern] [addr]",
    "test infinite write pattern", 2},
   {DDR_Test_Infinite_read, "Test infinite read for JEDEC", "[pattern] [addr]",
    "test infinite read pattern", 2},
+  {DDR_Test_Infinite_burst, "Test infinite burst for JEDEC",
+   "[config] [pattern] [addr]",
+   "bursts, config 0xDDSSPLLL: write duty %, log2 stride, pattern, length", 3},
 #endif
 };
 
@@ -129,14 +170,25 @@ const ddr_command ddr_cmd[DDR_CMD_MAX] = {
     [DDR_CMD_INFO]         = { "info"       , 0, CMD_MAX_ARG },
     [DDR_CMD_FREQ]         = { "freq"       , 0, 1 },
     [DDR_CMD_RESET]        = { "reset"      , 0, 0 },
+    [DDR_CMD_BAUD]         = { "baud"       , 0, 1 },
+    [DDR_CMD_RECORD]       = { "record"     , 0, 1 },
+    [DDR_CMD_LOAD]         = { "load"       , 0, 0 },
+    [DDR_CMD_SCRIPT]       = { "script"     , 0, 1 },
     [DDR_CMD_PARAM]        = { "param"      , 0, 2 },
     [DDR_CMD_PRINT]        = { "print"      , 0, 1 },
     [DDR_CMD_EDIT]         = { "edit"       , 2, 2 },
     [DDR_CMD_SAVE]         = { "save"       , 0, 0 },
+    [DDR_CMD_SNAP]         = { "snap"       , 0, 3 },
     [DDR_CMD_STEP]         = { "step"       , 0, 1 },
     [DDR_CMD_NEXT]         = { "next"       , 0, 0 },
     [DDR_CMD_GO]           = { "go"         , 0, 0 },
     [DDR_CMD_TEST]         = { "test"       , 0, CMD_MAX_ARG },
+    [DDR_CMD_TUNE]         = { "tune"       , 0, 3 },
+    [DDR_CMD_QOS]          = { "qos"        , 0, 4 },
+    [DDR_CMD_TRAFFIC]      = { "traffic"    , 0, 2 },
+    [DDR_CMD_JEDEC]        = { "jedec"      , 0, 2 },
+    [DDR_CMD_BENCH]        = { "bench"      , 1, 2 },
+    [DDR_CMD_VMARGIN]      = { "vmargin"    , 1, 3 },
     [DDR_CMD_TEST_HELP]    = { "test help"  , 0, 0 },
 };
 
@@ -153,11 +205,17 @@ static uint32_t DDR_Test_All(uint32_t loop, uint32_t size, uint32_t addr)
   int i;
 
 #ifdef TEST_INFINITE_ENABLE
-  for (i = 1; i < (int)test_nb - 2; i++)
+  for (i = 1; i < (int)test_nb - 3; i++)
 #else
   for (i = 1; i < (int)test_nb; i++)
 #endif
   {
+    /* duration driven, run on its own */
+    if (test[i].fct == DDR_Test_Soak)
+    {
+      continue;
+    }
+
     switch (test[i].max_args)
     {
       case 1:
@@ -183,6 +241,12 @@ static uint32_t DDR_Test_All(uint32_t loop, uint32_t size, uint32_t addr)
         {
           ret = test[i].fct(size, 0, addr);
         }
+        else if (   (test[i].fct == DDR_Test_Prbs)
+                 || (test[i].fct == DDR_Test_PrbsLane))
+        {
+          /* default polynomial and seed: these tests start at the DDR base */
+          ret = test[i].fct(size, 0, 0);
+        }
         else
         {
           ret = test[i].fct(size, loop, addr);
@@ -190,6 +254,8 @@ static uint32_t DDR_Test_All(uint32_t loop, uint32_t size, uint32_t addr)
         break;
     }
 
+    Record_TestResult(i, test[i].name, ret);
+
     if (ret != 0)
     {
       printf("%s failed [%d]\n\r", test[i].name, ret);
@@ -207,6 +273,7 @@ static void get_entry_string(char *entry)
   uint8_t user_entry_valid = 0;
   char user_entry_value = 0;
   int i = 0;
+  bool script_entry = (Script_GetLine(entry, CMD_MAX_LEN) == 0);
 
   Serial_Putchar(0xd);
   Serial_Putchar('D');
@@ -214,6 +281,13 @@ static void get_entry_string(char *entry)
   Serial_Putchar('R');
   Serial_Putchar('>');
 
+  /* Command of the script in progress, echoed as if typed */
+  if (script_entry)
+  {
+    printf("%s\n\r", entry);
+    return;
+  }
+
   while(user_entry_valid == 0)
   {
     /* Scan for user entry */
@@ -375,18 +449,65 @@ static void print_usage(void)
     "freq  <freq>               changes the DDR PHY frequency\n\r"
     "param [type|reg]           prints input parameters\n\r"
     "param <reg> <val>          edits parameters in step 0\n\r"
+    "load                       receives a configuration (XMODEM) in step 0\n\r"
+    "script                     lists the loaded script\n\r"
+    "script load                receives a script (text ended by Ctrl-D)\n\r"
+    "script run                 executes the script, prints a command/test summary\n\r"
     "print [type|reg]           dumps registers\n\r"
     "edit <reg> <val>           modifies one register\n\r"
     "save                       output formated DDR regs to be saved\n\r"
+    "snap                       lists the register snapshots, taken at each\n\r"
+    "                           step (0 to 3) or by user (4)\n\r"
+    "snap take                  takes the user snapshot\n\r"
+    "snap diff <a> [b]          prints the registers changed from a to b\n\r"
+    "                           (snapshot, cfg for configuration, now by default)\n\r"
+    "snap export                outputs all snapshots in Intel HEX format\n\r"
     "step                       lists the available step\n\r"
     "step <n>                   go to the step <n>\n\r"
     "next                       goes to the next step\n\r"
     "go                         continues the DDR TOOL execution\n\r"
     "reset                      reboots machine\n\r"
+    "baud                       displays the console baud rate\n\r"
+    "baud <rate>                switches the console baud rate, the host\n\r"
+    "                           confirms with \"" SERIAL_BAUD_SYNC "\" at the new rate\n\r"
+    "record [on|off]            displays or sets the output of binary records\n\r"
+    "                           (results, errors and dumps) along with the text\n\r"
     "test [help] | <n> [...]    lists (with help) or executes test <n>\n\r"
+    "tune                       lists the timing fields and their values\n\r"
+    "tune <field|all> [g] [sz]  lowers the timing field(s) down to the minimum\n\r"
+    "                           passing the fast tests on sz bytes (default 1MB),\n\r"
+    "                           plus g steps (default 1), prints the #define block\n\r"
+    "qos                        lists the QoS/scheduler fields and candidates\n\r"
+    "qos run [rd] [st] [port]   tunes the QoS fields for a workload of rd%% reads\n\r"
+    "                           (default 70), stride st (default 64) with HPDMA1\n\r"
+    "                           load, prints the gain and the #define block\n\r"
+    "qos sweep <f> [rd] [st]    measures each candidate value of the field f\n\r"
+    "                           (port fields named with their port: _0, _1)\n\r"
+    "traffic                    lists the concurrent traffic parameters\n\r"
+    "traffic <param> <val>      sets one traffic parameter\n\r"
+    "traffic run [s]            runs CPU and DMA traffic together, prints the\n\r"
+    "                           bandwidth of each master\n\r"
+    "jedec                      lists the JEDEC calculator parameters\n\r"
+    "jedec <param> <val>        sets one calculator parameter (type, density,\n\r"
+    "                           width, bin, freq)\n\r"
+    "jedec calc                 computes the timings, prints the #define block\n\r"
+    "jedec apply                step 0: computes and loads them in the\n\r"
+    "                           configuration (DRAM type of the build only)\n\r"
+    "bench refresh [s]          measures bandwidth, pointer chase latency and\n\r"
+    "                           retention over s seconds (default 1) for each\n\r"
+    "                           refresh configuration\n\r"
+    "bench lp [ns]              measures first-access latency after idle gaps\n\r"
+    "                           and bursty throughput for each low-power\n\r"
+    "                           setting, recommends the most aggressive one\n\r"
+    "                           within the latency budget (default 1000 ns)\n\r"
+    "vmargin <rail> [tests] [mV] steps the DDR rail (vdd1 or vdd2) down then\n\r"
+    "                           up from its voltage within the safe limits,\n\r"
+    "                           runs the tests (bit n for test n) at each\n\r"
+    "                           step, prints the passing voltage window\n\r"
     "\n\rwith for [type|reg]:\n\r"
     "  all registers if absent\n\r"
     "  <type> = ctl, uib, uia, uim, uis\n\r"
+    "           csr (print only: PHY CSRs programmed by PHY init)\n\r"
     "  <reg> = name of the register\n\r"
   };
 
@@ -589,6 +710,254 @@ static bool do_freq(int argc, char *argv[])
   return ret_code;
 }
 
+static void do_baud(int argc, char *argv[])
+{
+  unsigned long prev_baudrate = Serial_GetBaudrate();
+  int64_t value;
+
+  if (argc == 2)
+  {
+    value = string_to_num(argv[0]);
+    if ((value <= 0) || (value > (int64_t)UINT32_MAX))
+    {
+      printf("invalid argument %s\n\r", argv[0]);
+      return;
+    }
+
+    printf("baudrate %lu -> %lu, send \"%s\" within %u ms\n\r",
+           prev_baudrate, (unsigned long)value, SERIAL_BAUD_SYNC,
+           (unsigned int)UTIL_UART_BAUD_TIMEOUT_MS);
+
+    switch (Serial_SetBaudrate((uint32_t)value, UTIL_UART_BAUD_TIMEOUT_MS))
+    {
+      case 0:
+        break;
+      case -2:
+        printf("no confirmation, back to %lu\n\r", prev_baudrate);
+        break;
+      default:
+        printf("baudrate %lu not supported\n\r", (unsigned long)value);
+        break;
+    }
+  }
+
+  printf("baudrate = %lu\n\r", (unsigned long)Serial_GetBaudrate());
+}
+
+static void do_record(int argc, char *argv[])
+{
+  if (argc == 2)
+  {
+    if (!strcmp(argv[0], "on"))
+    {
+      Record_Enable(true);
+    }
+    else if (!strcmp(argv[0], "off"))
+    {
+      Record_Enable(false);
+    }
+    else
+    {
+      printf("invalid argument %s\n\r", argv[0]);
+      return;
+    }
+  }
+
+  printf("record = %s\n\r", Record_IsEnabled() ? "on" : "off");
+}
+
+static void do_script(int argc, char *argv[])
+{
+  if (argc == 1)
+  {
+    Script_List();
+    return;
+  }
+
+  if (Script_IsRunning())
+  {
+    printf("script %s not allowed in a script\n\r", argv[0]);
+    return;
+  }
+
+  if (!strcmp(argv[0], "load"))
+  {
+    if (Script_Load() != 0)
+    {
+      printf("script not loaded\n\r");
+    }
+  }
+  else if (!strcmp(argv[0], "run"))
+  {
+    Script_Run();
+  }
+  else
+  {
+    printf("invalid argument %s\n\r", argv[0]);
+  }
+}
+
+static uint8_t ihex_buf[IHEX_RECORD_LEN];
+static uint32_t ihex_len;
+static uint32_t ihex_addr;
+
+static void ihex_record(uint8_t type, uint16_t addr, const uint8_t *data,
+                        uint32_t len)
+{
+  char line[12 + (2 * IHEX_RECORD_LEN)];
+  uint8_t sum = (uint8_t)(len + (addr >> 8) + addr + type);
+  uint32_t i;
+
+  sprintf(line, ":%02X%04X%02X", (unsigned int)len, (unsigned int)addr, type);
+  for (i = 0; i < len; i++)
+  {
+    sprintf(&line[9 + (2 * i)], "%02X", data[i]);
+    sum += data[i];
+  }
+
+  printf("%s%02X\n\r", line, (uint8_t)(0x100U - sum));
+}
+
+static void ihex_flush(void)
+{
+  uint8_t ext[2];
+
+  if (ihex_len == 0U)
+  {
+    return;
+  }
+
+  /* Extended linear address on each 64KB boundary */
+  if (((ihex_addr & 0xFFFFU) == 0U) && (ihex_addr != 0U))
+  {
+    ext[0] = (uint8_t)(ihex_addr >> 24);
+    ext[1] = (uint8_t)(ihex_addr >> 16);
+    ihex_record(0x04U, 0U, ext, sizeof(ext));
+  }
+
+  ihex_record(0x00U, (uint16_t)ihex_addr, ihex_buf, ihex_len);
+  ihex_addr += ihex_len;
+  ihex_len = 0U;
+}
+
+static void ihex_write(const void *data, uint32_t len)
+{
+  const uint8_t *byte = data;
+
+  while (len-- != 0U)
+  {
+    ihex_buf[ihex_len++] = *byte++;
+    if (ihex_len == IHEX_RECORD_LEN)
+    {
+      ihex_flush();
+    }
+  }
+}
+
+static int32_t snap_slot(const char *arg, uint32_t *slot)
+{
+  int64_t value;
+
+  if (!strcmp(arg, "cfg"))
+  {
+    *slot = HAL_DDR_SNAPSHOT_CONFIG;
+    return 0;
+  }
+
+  if (!strcmp(arg, "now"))
+  {
+    *slot = HAL_DDR_SNAPSHOT_NOW;
+    return 0;
+  }
+
+  value = string_to_num((char *)arg);
+  if ((value < 0) || (value > (int64_t)HAL_DDR_SNAPSHOT_USER))
+  {
+    printf("invalid snapshot %s\n\r", arg);
+    return -1;
+  }
+
+  *slot = (uint32_t)value;
+
+  return 0;
+}
+
+static void do_snap(int argc, char *argv[])
+{
+  uint32_t from;
+  uint32_t to = HAL_DDR_SNAPSHOT_NOW;
+  uint32_t tick;
+  uint32_t slot;
+
+  if (argc == 1)
+  {
+    for (slot = 0; slot <= HAL_DDR_SNAPSHOT_USER; slot++)
+    {
+      printf("%lu:%-20s", (unsigned long)slot,
+             (slot == HAL_DDR_SNAPSHOT_USER) ? "USER" : step_str[slot]);
+      if (HAL_DDR_Snapshot_Info(slot, &tick) == HAL_OK)
+      {
+        printf("taken at %lu.%03lu s\n\r", (unsigned long)(tick / 1000U),
+               (unsigned long)(tick % 1000U));
+      }
+      else
+      {
+        printf("none\n\r");
+      }
+    }
+    return;
+  }
+
+  if (!strcmp(argv[0], "take") && (argc == 2))
+  {
+    HAL_DDR_Snapshot_Take(HAL_DDR_SNAPSHOT_USER);
+    printf("snapshot %lu taken\n\r", (unsigned long)HAL_DDR_SNAPSHOT_USER);
+  }
+  else if (!strcmp(argv[0], "diff") && (argc >= 3))
+  {
+    if ((snap_slot(argv[1], &from) != 0) ||
+        ((argc == 4) && (snap_slot(argv[2], &to) != 0)))
+    {
+      return;
+    }
+
+    if (HAL_DDR_Snapshot_Diff(from, to) != HAL_OK)
+    {
+      printf("snapshot not taken\n\r");
+    }
+  }
+  else if (!strcmp(argv[0], "export") && (argc == 2))
+  {
+    ihex_len = 0U;
+    ihex_addr = 0U;
+    HAL_DDR_Snapshot_Export(ihex_write);
+    ihex_flush();
+    ihex_record(0x01U, 0U, NULL, 0U);
+  }
+  else
+  {
+    printf("invalid argument %s\n\r", argv[0]);
+  }
+}
+
+static void do_load(HAL_DDR_InteractStepTypeDef step)
+{
+  if (!check_step(step, STEP_DDR_RESET))
+  {
+    return;
+  }
+
+  if (DDR_Config_Load() != 0)
+  {
+    printf("configuration not loaded\n\r");
+    return;
+  }
+
+  printf("name = %s\n\r", static_ddr_config.info.name);
+  printf("size = 0x%lx\n\r", static_ddr_config.info.size);
+  printf("speed = %d kHz\n\r", static_ddr_config.info.speed);
+}
+
 static void do_param(HAL_DDR_InteractStepTypeDef step, int argc, char *argv[])
 {
   char reg_name[(argc == 1)? 0 : strlen(argv[0])];
@@ -680,8 +1049,8 @@ static char argv1[CMD_MAX_LEN / 4] = "\0";
 static char argv2[CMD_MAX_LEN / 4] = "\0";
 static char argv3[CMD_MAX_LEN / 4] = "\0";
 
-static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
-                      const int size)
+static uint32_t do_subcmd(int argc, char *argv[], const subcmd_desc *array,
+                          const int size)
 {
   int i;
   int64_t value;
@@ -692,7 +1061,7 @@ static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
   {
     printf("Please enter a sub command number\n\r\n\r");
     print_subcmd_usage(array, size);
-    return;
+    return 0XFFFFFFFF;
   }
 
   /* Check sub command ID */
@@ -701,7 +1070,7 @@ static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
   {
     printf("Unknown sub command [%s]\n\r\n\r", argv[0]);
     print_subcmd_usage(array, size);
-    return;
+    return 0XFFFFFFFF;
   }
 
   /*
@@ -743,7 +1112,7 @@ static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
     /* any other cases */
     printf("Incorrect number of arguments\n\r\n\r");
     print_single_subcmd_usage(array, value);
-    return;
+    return 0XFFFFFFFF;
   }
 
   /* Check argument validity */
@@ -753,7 +1122,7 @@ static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
     {
       printf("Invalid argument #%d %s\n\r\n\r", i, argv[i]);
       print_single_subcmd_usage(array, value);
-      return;
+      return 0XFFFFFFFF;
     }
   }
 
@@ -780,13 +1149,474 @@ static void do_subcmd(int argc, char *argv[], const subcmd_desc *array,
       break;
   }
 
+  if (array == test)
+  {
+    Record_TestResult((uint32_t)value, array[value].name, retcode);
+  }
+
   if (retcode != 0)
   {
     printf("%s failed [%d]\n\r", array[value].name, retcode);
-    return;
+    return retcode;
   }
 
     printf("Result: Pass [%s]\n\r", array[value].name);
+
+  return retcode;
+}
+
+static void do_tune(HAL_DDR_InteractStepTypeDef step, int argc, char *argv[])
+{
+  int64_t guard = TUNE_DEFAULT_GUARD;
+  int64_t size = TUNE_DEFAULT_SIZE;
+
+  if (argc == 1)
+  {
+    Tune_List();
+    return;
+  }
+
+  if (!check_step(step, STEP_DDR_READY))
+  {
+    Script_CommandResult(0XFFFFFFFF);
+    return;
+  }
+
+  if (argc > 2)
+  {
+    guard = string_to_num(argv[1]);
+  }
+  if (argc > 3)
+  {
+    size = string_to_num(argv[2]);
+  }
+  if ((guard < 0) || (size <= 0))
+  {
+    printf("invalid argument\n\r");
+    Script_CommandResult(0XFFFFFFFF);
+    return;
+  }
+
+  if (Tune_Run(argv[0], (uint32_t)guard, (uint32_t)size) != 0)
+  {
+    Script_CommandResult(0XFFFFFFFF);
+    return;
+  }
+
+  Script_CommandResult(0);
+}
+
+static void do_qos(HAL_DDR_InteractStepTypeDef step, int argc, char *argv[])
+{
+  int64_t rd_pct = TUNE_QOS_DEFAULT_READ;
+  int64_t stride = TUNE_QOS_DEFAULT_STRIDE;
+  int64_t port = 0;
+  int32_t ret;
+  int first = 1; /* first workload argument */
+
+  if (argc == 1)
+  {
+    Tune_QosList();
+    return;
+  }
+
+  if (!check_step(step, STEP_DDR_READY))
+  {
+    Script_CommandResult(0XFFFFFFFF);
+    return;
+  }
+
+  if (!strcmp(argv[0], "sweep"))
+  {
+    if (argc < 3)
+    {
+      printf("field missing\n\r");
+      Script_CommandResult(0XFFFFFFFF);
+      return;
+    }
+    first = 2;
+  }
+  else if (strcmp(argv[0], "run"))
+  {
+    printf("argument %s invalid\n\r", argv[0]);
+    Script_CommandResult(0XFFFFFFFF);
+    return;
+  }
+
+  if (argc > first + 1)
+  {
+    rd_pct = string_to_num(argv[first]);
+  }
+  if (argc > first + 2)
+  {
+    stride = string_to_num(argv[first + 1]);
+  }
+  /* A swept port field is given with its port, as suffix of its name */
+  if ((first == 1) && (argc > 4))
+  {
+    port = string_to_num(argv[3]);
+  }
+  if ((rd_pct < 0) || (stride < 0) || (port < 0))
+  {
+    printf("invalid argument\n\r");
+    Script_CommandResult(0XFFFFFFFF);
+    return;
+  }
+
+  if (first == 2)
+  {
+    ret = Tune_QosSweep(argv[1], (uint32_t)rd_pct, (uint32_t)stride);
+  }
+  else
+  {
+    ret = Tune_QosRun((uint32_t)rd_pct, (uint32_t)stride, (uint32_t)port);
+  }
+
+  Script_CommandResult((ret == 0) ? 0 : 0XFFFFFFFF);
+}
+
+static void do_traffic(HAL_DDR_InteractStepTypeDef step, int argc, char *argv[])
+{
+  int64_t value = 0;
+  int32_t ret;
+
+  if (argc == 1)
+  {
+    Traffic_List();
+    return;
+  }
+
+  if (strcmp(argv[0], "run"))
+  {
+    if (argc != 3)
+    {
+      printf("value missing\n\r");
+      Script_CommandResult(0XFFFFFFFF);
+      return;
+    }
+    value = string_to_num(argv[1]);
+    if ((value < 0) || (value > (int64_t)UINT32_MAX))
+    {
+      printf("invalid value %s\n\r", argv[1]);
+      Script_CommandResult(0XFFFFFFFF);
+      return;
+    }
+    ret = Traffic_Set(argv[0], (uint32_t)value);
+    Script_CommandResult((ret == 0) ? 0 : 0XFFFFFFFF);
+    return;
+  }
+
+  if (!check_step(step, STEP_DDR_READY))
+  {
+    Script_CommandResult(0XFFFFFFFF);
+    return;
+  }
+
+  if (argc == 3)
+  {
+    value = string_to_num(argv[1]);
+    if ((value <= 0) || (value > (int64_t)UINT32_MAX))
+    {
+      printf("invalid time %s\n\r", argv[1]);
+      Script_CommandResult(0XFFFFFFFF);
+      return;
+    }
+  }
+
+  ret = Traffic_Run((uint32_t)value);
+  Script_CommandResult((ret == 0) ? 0 : 0XFFFFFFFF);
+}
+
+static void do_jedec(HAL_DDR_InteractStepTypeDef step, int argc, char *argv[])
+{
+  int32_t ret;
+
+  if (argc == 1)
+  {
+    Jedec_List();
+    return;
+  }
+
+  if (!strcmp(argv[0], "calc") || !strcmp(argv[0], "apply"))
+  {
+    if (!strcmp(argv[0], "apply") && !check_step(step, STEP_DDR_RESET))
+    {
+      Script_CommandResult(0XFFFFFFFF);
+      return;
+    }
+    ret = Jedec_Run(!strcmp(argv[0], "apply"));
+    Script_CommandResult((ret == 0) ? 0 : 0XFFFFFFFF);
+    return;
+  }
+
+  if (argc != 3)
+  {
+    printf("value missing\n\r");
+    Script_CommandResult(0XFFFFFFFF);
+    return;
+  }
+
+  ret = Jedec_Set(argv[0], argv[1]);
+  Script_CommandResult((ret == 0) ? 0 : 0XFFFFFFFF);
+}
+
+static void do_bench(HAL_DDR_InteractStepTypeDef step, int argc, char *argv[])
+{
+  int64_t value;
+  int32_t ret;
+  bool lp;
+
+  if (!strcmp(argv[0], "refresh"))
+  {
+    lp = false;
+    value = BENCH_DEFAULT_WAIT;
+  }
+  else if (!strcmp(argv[0], "lp"))
+  {
+    lp = true;
+    value = BENCH_LP_DEFAULT_BUDGET;
+  }
+  else
+  {
+    printf("argument %s invalid\n\r", argv[0]);
+    Script_CommandResult(0XFFFFFFFF);
+    return;
+  }
+
+  if (!check_step(step, STEP_DDR_READY))
+  {
+    Script_CommandResult(0XFFFFFFFF);
+    return;
+  }
+
+  if (argc == 3)
+  {
+    value = string_to_num(argv[1]);
+    if ((value <= 0) || (value > (lp ? 1000000 : 3600)))
+    {
+      printf("invalid %s %s\n\r", lp ? "budget" : "time", argv[1]);
+      Script_CommandResult(0XFFFFFFFF);
+      return;
+    }
+  }
+
+  ret = lp ? Bench_LowPower((uint32_t)value) : Bench_Refresh((uint32_t)value);
+  Script_CommandResult((ret == 0) ? 0 : 0XFFFFFFFF);
+}
+
+#if (UTIL_USE_PMIC) && !defined(DDR_HOST_SIM)
+/* Runs the tests of the mask with their default arguments, 0 if all pass */
+static uint32_t vmargin_tests(uint32_t tests, int *failed)
+{
+  uint32_t ret = 0;
+  int i;
+
+  for (i = 1; i < test_nb; i++)
+  {
+    if ((tests & (1UL << i)) == 0U)
+    {
+      continue;
+    }
+
+    switch (test[i].max_args)
+    {
+      case 1:
+        ret = test[i].fct(0);
+        break;
+      case 2:
+        ret = test[i].fct(0, 0);
+        break;
+      case 3:
+        ret = test[i].fct(0, 0, 0);
+        break;
+      default:
+        ret = test[i].fct();
+        break;
+    }
+
+    if (ret != 0)
+    {
+      *failed = i;
+      break;
+    }
+  }
+
+  return ret;
+}
+
+/* Applies one voltage (unless current) and runs the tests, true if they pass */
+static bool vmargin_step(board_regul_t regu, uint32_t mv, uint32_t tests, bool set)
+{
+  int failed = 0;
+
+  if (set && (BSP_PMIC_DDR_Set_Voltage(regu, mv) != BSP_ERROR_NONE))
+  {
+    printf("  %4lu mV: voltage not set\n\r", (unsigned long)mv);
+    return false;
+  }
+
+  if (vmargin_tests(tests, &failed) != 0)
+  {
+    printf("  %4lu mV: fail [%s]\n\r", (unsigned long)mv, test[failed].name);
+    return false;
+  }
+
+  printf("  %4lu mV: pass\n\r", (unsigned long)mv);
+
+  return true;
+}
+
+static void do_vmargin(HAL_DDR_InteractStepTypeDef step, int argc, char *argv[])
+{
+  board_regul_t regu;
+  const char *name;
+  uint32_t tests = VMARGIN_DFLT_TESTS;
+  uint32_t mv_step;
+  uint32_t mv_min;
+  uint32_t mv_max;
+  uint32_t nominal;
+  uint32_t low;
+  uint32_t high;
+  uint32_t mv;
+  int64_t value;
+  int nb_tests;
+  bool pass;
+
+#ifdef TEST_INFINITE_ENABLE
+  nb_tests = test_nb - 3;
+#else
+  nb_tests = test_nb;
+#endif
+
+  if (!strcmp(argv[0], "vdd1"))
+  {
+    regu = VDD1_DDR;
+    name = "VDD1_DDR";
+    mv_step = VMARGIN_VDD1_STEP;
+    mv_min = BSP_PMIC_VDD1_DDR_MARGIN_MIN;
+    mv_max = BSP_PMIC_VDD1_DDR_MARGIN_MAX;
+  }
+  else if (!strcmp(argv[0], "vdd2"))
+  {
+    regu = VDD2_DDR;
+    name = "VDD2_DDR";
+    mv_step = VMARGIN_VDD2_STEP;
+    mv_min = BSP_PMIC_VDD2_DDR_MARGIN_MIN;
+    mv_max = BSP_PMIC_VDD2_DDR_MARGIN_MAX;
+  }
+  else
+  {
+    printf("argument %s invalid\n\r", argv[0]);
+    Script_CommandResult(0XFFFFFFFF);
+    return;
+  }
+
+  if (mv_max == 0U)
+  {
+    printf("%s margining not supported for this DDR type\n\r", name);
+    Script_CommandResult(0XFFFFFFFF);
+    return;
+  }
+
+  if (!check_step(step, STEP_DDR_READY))
+  {
+    Script_CommandResult(0XFFFFFFFF);
+    return;
+  }
+
+  if (argc >= 3)
+  {
+    value = string_to_num(argv[1]);
+    /* no Test All (bit 0) nor infinite test */
+    if ((value <= 1) || (value >= (1LL << nb_tests)) || ((value & 1) != 0))
+    {
+      printf("invalid tests %s\n\r", argv[1]);
+      Script_CommandResult(0XFFFFFFFF);
+      return;
+    }
+    tests = (uint32_t)value;
+  }
+
+  if (argc == 4)
+  {
+    value = string_to_num(argv[2]);
+    if ((value <= 0) || ((value % mv_step) != 0) || (value > (mv_max - mv_min)))
+    {
+      printf("invalid step %s (multiple of %lu mV)\n\r", argv[2], (unsigned long)mv_step);
+      Script_CommandResult(0XFFFFFFFF);
+      return;
+    }
+    mv_step = (uint32_t)value;
+  }
+
+  if (BSP_PMIC_DDR_Get_Voltage(regu, &nominal) != BSP_ERROR_NONE)
+  {
+    printf("voltage read failed\n\r");
+    Script_CommandResult(0XFFFFFFFF);
+    return;
+  }
+
+  printf("%s = %lu mV, DDRPHY = %lu kHz, tests 0x%lx, limits %lu..%lu mV\n\r",
+         name, (unsigned long)nominal,
+         (2 * (unsigned long)HAL_RCCEx_GetPLL2ClockFreq()) / 1000,
+         (unsigned long)tests, (unsigned long)mv_min, (unsigned long)mv_max);
+
+  if (!vmargin_step(regu, nominal, tests, false))
+  {
+    printf("fails at the current voltage\n\r");
+    Script_CommandResult(0XFFFFFFFF);
+    return;
+  }
+
+  low = nominal;
+  for (mv = nominal - mv_step; (mv >= mv_min) && (mv < nominal); mv -= mv_step)
+  {
+    if (!vmargin_step(regu, mv, tests, true))
+    {
+      break;
+    }
+    low = mv;
+  }
+
+  high = nominal;
+  for (mv = nominal + mv_step; mv <= mv_max; mv += mv_step)
+  {
+    if (!vmargin_step(regu, mv, tests, true))
+    {
+      break;
+    }
+    high = mv;
+  }
+
+  pass = (BSP_PMIC_DDR_Set_Voltage(regu, nominal) == BSP_ERROR_NONE);
+  if (!pass)
+  {
+    printf("%lu mV not restored\n\r", (unsigned long)nominal);
+  }
+
+  printf("passing window %lu..%lu mV: -%lu/+%lu mV%s%s\n\r",
+         (unsigned long)low, (unsigned long)high,
+         (unsigned long)(nominal - low), (unsigned long)(high - nominal),
+         ((low - mv_step) < mv_min) ? ", low limit reached" : "",
+         ((high + mv_step) > mv_max) ? ", high limit reached" : "");
+
+  Script_CommandResult(pass ? 0 : 0XFFFFFFFF);
+}
+#else /* UTIL_USE_PMIC */
+static void do_vmargin(HAL_DDR_InteractStepTypeDef step, int argc, char *argv[])
+{
+  (void)step;
+  (void)argc;
+  (void)argv;
+
+  printf("no PMIC\n\r");
+  Script_CommandResult(0XFFFFFFFF);
+}
+#endif /* UTIL_USE_PMIC */
+
+void HAL_DDR_DumpRegCallback(const char *name, uint32_t value)
+{
+  Record_Register(name, value);
 }
 
 bool HAL_DDR_Interactive(HAL_DDR_InteractStepTypeDef step)
@@ -795,11 +1625,17 @@ bool HAL_DDR_Interactive(HAL_DDR_InteractStepTypeDef step)
   char *argv[CMD_MAX_ARG + 1] = {argv0, argv1, argv2, argv3}; /* NULL terminated */
   int argc;
   int cmd;
+  uint32_t result;
+  bool has_result;
   static int next_step = -1;
 
   if ((next_step < 0) && (step == STEP_DDR_RESET))
   {
     next_step = STEP_DDR_RESET;
+#ifdef UTIL_DDR_SCRIPT_DEFAULT
+    /* Default plan, compiled in */
+    Script_Run();
+#endif
   }
 
 //  printf("** step %d ** %s / %d\n\r", step, step_str[step], next_step);
@@ -830,6 +1666,7 @@ bool HAL_DDR_Interactive(HAL_DDR_InteractStepTypeDef step)
     if (argc < 0)
     {
       printf("Error [%d]\n\r", argc);
+      Script_Abort("command error");
       continue;
     }
     else if (argc == 0)
@@ -852,18 +1689,39 @@ bool HAL_DDR_Interactive(HAL_DDR_InteractStepTypeDef step)
       break;
 
     case DDR_CMD_FREQ:
-      do_freq(argc, argv);
+      if (!do_freq(argc, argv))
+      {
+        Script_Abort("frequency not set");
+      }
       if ((argc == 2) && (step > STEP_CTL_INIT))
       {
         printf("### Please update PLL settings and DDR timings ###\n\r");
-        printf("### in your project. Then rebuild and restart. ###\n\r");
+        printf("### in your project. Then rebuild and restart, ###\n\r");
+        printf("### or reset and load them in step 0.          ###\n\r");
       }
       break;
 
     case DDR_CMD_RESET:
+      Serial_Flush();
       WRITE_REG(RCC->GRSTCSETR, 0x1U);
       break;
 
+    case DDR_CMD_BAUD:
+      do_baud(argc, argv);
+      break;
+
+    case DDR_CMD_RECORD:
+      do_record(argc, argv);
+      break;
+
+    case DDR_CMD_SCRIPT:
+      do_script(argc, argv);
+      break;
+
+    case DDR_CMD_LOAD:
+      do_load(step);
+      break;
+
     case DDR_CMD_PARAM:
       do_param(step, argc, argv);
       break;
@@ -880,8 +1738,13 @@ bool HAL_DDR_Interactive(HAL_DDR_InteractStepTypeDef step)
       HAL_DDR_Dump_Reg(NULL, true);
       break;
 
+    case DDR_CMD_SNAP:
+      do_snap(argc, argv);
+      break;
+
     case DDR_CMD_GO:
       next_step = STEP_RUN;
+      Script_Abort(NULL);
       printf("### Exit DDR INTERACTIVE mode. Please RESET the BOARD ###\n\r");
       break;
 
@@ -889,6 +1752,7 @@ bool HAL_DDR_Interactive(HAL_DDR_InteractStepTypeDef step)
       next_step = step + 1;
       if (next_step == STEP_RUN)
       {
+        Script_Abort(NULL);
         printf("### Exit DDR INTERACTIVE mode. Please RESET the BOARD ###\n\r");
       }
       break;
@@ -900,14 +1764,42 @@ bool HAL_DDR_Interactive(HAL_DDR_InteractStepTypeDef step)
     case DDR_CMD_TEST:
       if (!check_step(step, STEP_DDR_READY))
       {
-        continue;
+        Script_Result(0XFFFFFFFF);
+        break;
       }
-      do_subcmd(argc, argv, test, test_nb);
+      Script_Result(do_subcmd(argc, argv, test, test_nb));
+      break;
+
+    case DDR_CMD_TUNE:
+      do_tune(step, argc, argv);
+      break;
+
+    case DDR_CMD_QOS:
+      do_qos(step, argc, argv);
+      break;
+
+    case DDR_CMD_TRAFFIC:
+      do_traffic(step, argc, argv);
+      break;
+
+    case DDR_CMD_JEDEC:
+      do_jedec(step, argc, argv);
+      break;
+
+    case DDR_CMD_BENCH:
+      do_bench(step, argc, argv);
+      break;
+
+    case DDR_CMD_VMARGIN:
+      do_vmargin(step, argc, argv);
       break;
 
     default:
       break;
     }
+
+    has_result = Script_GetResult(&result);
+    Record_Command(ddr_cmd[cmd].str, step, has_result, result);
   }
 
   return next_step == STEP_DDR_RESET;
@@ -0,0 +1,948 @@
+/**
+  ******************************************************************************
+  * @file    ddr_tool_bench.c
+  * @author  MCD Application Team
+  * @brief   DDR controller setting benchmarks, see ddr_tool_bench.h: each
+  *          configuration is applied in turn and measured (bandwidth,
+  *          pointer chase latency, first-access latency after idle), its
+  *          risk being checked (JEDEC compliance, retention).
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32_device_hal.h"
+
+#include "string.h"
+#include "ddr_prbs.h"
+#include "ddr_tool_util.h"
+#include "ddr_tool_bench.h"
+#include "stm32mp2xx_hal_ddr_timer.h"
+#include "stm32mp_util_ddr_conf.h"
+
+/* Private typedef -----------------------------------------------------------*/
+enum bench_rfsh_kind {
+  BENCH_RFSH_CURRENT,
+  BENCH_RFSH_FAST,
+  BENCH_RFSH_SLOW,
+  BENCH_RFSH_BURST,
+  BENCH_RFSH_FGR2,
+  BENCH_RFSH_FGR4,
+  BENCH_RFSH_BANK,
+};
+
+typedef struct {
+  const char *name;
+  const char *spec;   /* JEDEC compliance */
+  enum bench_rfsh_kind kind;
+} bench_rfsh_config;
+
+/* Refresh settings */
+typedef struct {
+  uint32_t rfshctl0;
+  uint32_t rfshctl3;
+  uint32_t rfshtmg;
+  uint32_t mr3;       /* DDR4 */
+} bench_rfsh_regs;
+
+/* Index in bench_result.lat_ns[] */
+enum bench_lat_id {
+  BENCH_LAT_P50,
+  BENCH_LAT_P99,
+  BENCH_LAT_P999,
+  BENCH_LAT_MAX,
+  BENCH_LAT_NB,
+};
+
+/* Low-power settings, from the initial ones with all the low power disabled */
+typedef struct {
+  const char *name;
+  bool current;       /* initial settings kept */
+  uint32_t pwrctl;    /* PWRCTL enables */
+  uint32_t pd_to;     /* PWRTMG.powerdown_to_x32 */
+  uint32_t sr_to;     /* PWRTMG.selfref_to_x32 */
+  uint32_t dfilpcfg0; /* DFILPCFG0 enables */
+} bench_lp_config;
+
+typedef struct {
+  uint32_t pwrctl;
+  uint32_t pwrtmg;
+  uint32_t hwlpctl;
+  uint32_t dfilpcfg0;
+  uint32_t dfilpcfg1;
+} bench_lp_regs;
+
+typedef struct {
+  uint32_t rd_kbps;
+  uint32_t wr_kbps;
+  uint32_t lat_ns[BENCH_LAT_NB];
+  uint32_t errors;
+} bench_result;
+
+#define BENCH_LP_NB_GAPS       5U
+#define BENCH_LP_NB_BURST_GAPS 2U
+
+typedef struct {
+  uint32_t p50_ns[BENCH_LP_NB_GAPS];   /* first access after each idle gap */
+  uint32_t max_ns;                     /* over all the gaps */
+  uint32_t kbps[BENCH_LP_NB_BURST_GAPS];
+} bench_lp_result;
+
+/* Private define ------------------------------------------------------------*/
+#define BENCH_BW_BASE        DDR_MEM_BASE
+#define BENCH_CHASE_BASE     (DDR_MEM_BASE + BENCH_BW_SIZE)
+#define BENCH_CHASE_SIZE     0x1000000U
+#define BENCH_RET_BASE       (BENCH_CHASE_BASE + BENCH_CHASE_SIZE)
+#define BENCH_RET_SIZE       0x1000000U
+
+#define BENCH_LINE_SIZE      64U
+#define BENCH_NB_RUNS        3U  /* best of, against the measurement noise */
+#define BENCH_LAT_BINS       256U /* timer ticks, the last bin for above */
+#define BENCH_WAIT_STEP_US   10000U
+#define BENCH_MR_TIMEOUT_US  1000U
+
+/* RFSHTMG */
+#define BENCH_RFC_MIN_MASK   0x3FFU
+#define BENCH_RFC_NOM_POS    16U
+#define BENCH_RFC_NOM_MASK   0xFFFU
+#define BENCH_RFC_NOM_X1     (1UL << 31) /* t_rfc_nom_x1_sel */
+
+/* RFSHCTL0 */
+#define BENCH_PER_BANK       (1UL << 2)
+#define BENCH_BURST_POS      4U
+#define BENCH_BURST_MASK     0x1FU
+#define BENCH_BURST_MAX      7U  /* 8 refreshes */
+
+/* RFSHCTL3 */
+#define BENCH_DIS_AUTO_RFSH  (1UL << 0)
+#define BENCH_RFSH_MODE_POS  4U
+#define BENCH_RFSH_MODE_MASK 0x7U
+
+/* MRCTRL0, MRCTRL1, MRSTAT */
+#define BENCH_MR_WR          (1UL << 31)
+#define BENCH_MR_ADDR_POS    12U
+#define BENCH_MR_RANK0       (1UL << 4)
+#define BENCH_MR_WR_BUSY     (1UL << 0)
+
+/* DDR4 MR3: fine granularity refresh mode A8:A6 */
+#define BENCH_MR3_FGR_POS    6U
+
+/* PWRCTL */
+#define BENCH_SELFREF_EN     (1UL << 0)
+#define BENCH_POWERDOWN_EN   (1UL << 1)
+#define BENCH_DRAM_CLK_DIS   (1UL << 3)  /* en_dfi_dram_clk_disable */
+#define BENCH_PWRCTL_LP      (BENCH_SELFREF_EN | BENCH_POWERDOWN_EN | BENCH_DRAM_CLK_DIS)
+
+/* PWRTMG */
+#define BENCH_PD_TO_POS      0U
+#define BENCH_PD_TO_MASK     0x1FU
+#define BENCH_SR_TO_POS      16U
+#define BENCH_SR_TO_MASK     0xFFU
+
+/* HWLPCTL */
+#define BENCH_HW_LP_EN       (1UL << 0)
+
+/* DFILPCFG0 */
+#define BENCH_DFI_LP_EN_PD   (1UL << 0)
+#define BENCH_DFI_LP_EN_SR   (1UL << 8)
+#define BENCH_DFILPCFG0_LP   (BENCH_DFI_LP_EN_PD | BENCH_DFI_LP_EN_SR)
+
+#define BENCH_LP_STRIDE      0x10000U /* one page per sample */
+#define BENCH_LP_NB_BURSTS   64U
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static const bench_rfsh_config bench_rfsh_configs[] = {
+  {"current", "reference",   BENCH_RFSH_CURRENT},
+  {"refi/2",  "in spec",     BENCH_RFSH_FAST},
+  {"refi*2",  "OUT OF SPEC", BENCH_RFSH_SLOW},
+  {"burst8",  "in spec",     BENCH_RFSH_BURST},
+#if STM32MP_DDR4_TYPE
+  {"fgr2x",   "in spec",     BENCH_RFSH_FGR2},
+  {"fgr4x",   "in spec",     BENCH_RFSH_FGR4},
+#endif /* STM32MP_DDR4_TYPE */
+#if STM32MP_LPDDR4_TYPE
+  {"bank",    "in spec",     BENCH_RFSH_BANK},
+#endif /* STM32MP_LPDDR4_TYPE */
+};
+
+/* From the least to the most aggressive, after the current settings */
+static const bench_lp_config bench_lp_configs[] = {
+  {"current", true,  0U,                                      0U,   0U,   0U},
+  {"off",     false, 0U,                                      0U,   0U,   0U},
+  {"pd16",    false, BENCH_POWERDOWN_EN,                      16U,  0U,   0U},
+  {"pd1",     false, BENCH_POWERDOWN_EN,                      1U,   0U,   0U},
+  {"pd1dfi",  false, BENCH_POWERDOWN_EN,                      1U,   0U,   BENCH_DFI_LP_EN_PD},
+  {"sr255",   false, BENCH_POWERDOWN_EN | BENCH_SELFREF_EN,   1U,   255U, 0U},
+  {"sr16",    false, BENCH_POWERDOWN_EN | BENCH_SELFREF_EN,   1U,   16U,  0U},
+  {"sr1",     false, BENCH_POWERDOWN_EN | BENCH_SELFREF_EN,   1U,   1U,   0U},
+  {"sr1dfi",  false, BENCH_POWERDOWN_EN | BENCH_SELFREF_EN,   1U,   1U,
+   BENCH_DFI_LP_EN_PD | BENCH_DFI_LP_EN_SR},
+  {"sr1clk",  false, BENCH_PWRCTL_LP,                         1U,   1U,
+   BENCH_DFI_LP_EN_PD | BENCH_DFI_LP_EN_SR},
+};
+
+static const uint32_t bench_lp_gaps_us[BENCH_LP_NB_GAPS] = {0U, 1U, 10U, 100U, 1000U};
+static const uint32_t bench_lp_burst_gaps_us[BENCH_LP_NB_BURST_GAPS] = {2U, 20U};
+
+static uint32_t bench_lat_hist[BENCH_LAT_BINS];
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+static bool key_pressed(void)
+{
+  uint8_t key;
+
+  return Serial_GetByte(&key, 0U) == 0;
+}
+
+static uint32_t bench_random(uint32_t *state)
+{
+  /* xorshift32 */
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+
+  return *state;
+}
+
+static uint32_t bench_kbps(uint32_t bytes, uint64_t start)
+{
+  uint32_t elapsed_us = ddr_timer_elapsed_us(start);
+
+  if (elapsed_us == 0U)
+  {
+    elapsed_us = 1U;
+  }
+
+  return (uint32_t)((uint64_t)bytes * 1000U / elapsed_us);
+}
+
+/* Sequential 64-bit reads then writes, best of BENCH_NB_RUNS runs */
+static void bench_bandwidth(bench_result *result)
+{
+  volatile uint64_t *addr = (volatile uint64_t *)BENCH_BW_BASE;
+  uint32_t nb = BENCH_BW_SIZE / sizeof(uint64_t);
+  uint32_t kbps;
+  uint32_t run;
+  uint32_t i;
+  uint64_t start;
+  uint64_t data = 0U;
+
+  result->rd_kbps = 0U;
+  result->wr_kbps = 0U;
+
+  for (run = 0U; run < BENCH_NB_RUNS; run++)
+  {
+    start = ddr_timer_get_count();
+    for (i = 0U; i < nb; i += 4U)
+    {
+      data ^= addr[i] ^ addr[i + 1U] ^ addr[i + 2U] ^ addr[i + 3U];
+    }
+    kbps = bench_kbps(BENCH_BW_SIZE, start);
+    if (kbps > result->rd_kbps)
+    {
+      result->rd_kbps = kbps;
+    }
+
+    start = ddr_timer_get_count();
+    for (i = 0U; i < nb; i += 4U)
+    {
+      addr[i] = data;
+      addr[i + 1U] = data;
+      addr[i + 2U] = data;
+      addr[i + 3U] = data;
+    }
+    kbps = bench_kbps(BENCH_BW_SIZE, start);
+    if (kbps > result->wr_kbps)
+    {
+      result->wr_kbps = kbps;
+    }
+  }
+}
+
+/*
+ * Pointer chase cycle: the first word of each line holds the index of the
+ * next line, a random cyclic permutation (Sattolo's algorithm), so that each
+ * load depends on the previous one and misses the open pages.
+ */
+static void bench_chase_init(void)
+{
+  volatile uint32_t *line = (volatile uint32_t *)BENCH_CHASE_BASE;
+  uint32_t step = BENCH_LINE_SIZE / sizeof(uint32_t);
+  uint32_t nb = BENCH_CHASE_SIZE / BENCH_LINE_SIZE;
+  uint32_t state = 0x2545F491U;
+  uint32_t tmp;
+  uint32_t i;
+  uint32_t j;
+
+  for (i = 0U; i < nb; i++)
+  {
+    line[i * step] = i;
+  }
+
+  for (i = nb - 1U; i > 0U; i--)
+  {
+    j = bench_random(&state) % i;
+    tmp = line[i * step];
+    line[i * step] = line[j * step];
+    line[j * step] = tmp;
+  }
+}
+
+static uint32_t bench_ticks_to_ns(uint32_t ticks)
+{
+  uint32_t freq = ddr_timer_get_freq();
+
+  if (freq == 0U)
+  {
+    return 0U;
+  }
+
+  return (uint32_t)(((uint64_t)ticks * 1000000000U) / freq);
+}
+
+/* Latency of each dependent load, as timer ticks histogram */
+static void bench_latency(bench_result *result)
+{
+  volatile uint32_t *line = (volatile uint32_t *)BENCH_CHASE_BASE;
+  uint32_t step = BENCH_LINE_SIZE / sizeof(uint32_t);
+  uint32_t nb = BENCH_CHASE_SIZE / BENCH_LINE_SIZE;
+  const uint32_t rank[BENCH_LAT_MAX] = {500U, 990U, 999U}; /* per mille */
+  uint32_t index = 0U;
+  uint32_t max = 0U;
+  uint32_t count;
+  uint32_t ticks;
+  uint32_t hop;
+  uint32_t bin;
+  uint32_t id;
+  uint64_t start;
+  uint64_t end;
+
+  memset(bench_lat_hist, 0, sizeof(bench_lat_hist));
+
+  start = ddr_timer_get_count();
+  for (hop = 0U; hop < BENCH_NB_HOPS; hop++)
+  {
+    index = line[index * step];
+    /* The test depends on the loaded value: the load is complete */
+    if (index >= nb)
+    {
+      break;
+    }
+    end = ddr_timer_get_count();
+
+    ticks = (uint32_t)(end - start);
+    start = end;
+    if (ticks > max)
+    {
+      max = ticks;
+    }
+    bench_lat_hist[(ticks < BENCH_LAT_BINS) ? ticks : (BENCH_LAT_BINS - 1U)]++;
+  }
+
+  id = 0U;
+  count = 0U;
+  for (bin = 0U; (bin < BENCH_LAT_BINS) && (id < BENCH_LAT_MAX); bin++)
+  {
+    count += bench_lat_hist[bin];
+    while ((id < BENCH_LAT_MAX) &&
+           (((uint64_t)count * 1000U) >= ((uint64_t)hop * rank[id])))
+    {
+      result->lat_ns[id] = bench_ticks_to_ns(bin);
+      id++;
+    }
+  }
+  result->lat_ns[BENCH_LAT_MAX] = bench_ticks_to_ns(max);
+}
+
+/*
+ * Retention: PRBS31 written, kept <wait_s> seconds while the DDR is read
+ * elsewhere (no low-power entry, the refresh settings apply), then checked.
+ * Returns the number of 64-bit words in error, or UINT32_MAX if stopped.
+ */
+static uint32_t bench_retention(uint32_t wait_s)
+{
+  volatile uint64_t *addr = (volatile uint64_t *)BENCH_RET_BASE;
+  volatile uint64_t *busy = (volatile uint64_t *)BENCH_BW_BASE;
+  uint32_t nb = BENCH_RET_SIZE / sizeof(uint64_t);
+  uint32_t errors = 0U;
+  uint32_t i;
+  uint64_t deadline;
+  uint64_t data = 0U;
+  prbs_gen prbs;
+
+  (void)Prbs_Init(&prbs, PRBS_DEFAULT_POLY, 0U, 0U);
+  for (i = 0U; i < nb; i++)
+  {
+    addr[i] = Prbs_Next(&prbs);
+  }
+
+  for (i = 0U; i < ((wait_s * 1000000U) / BENCH_WAIT_STEP_US); i++)
+  {
+    if (key_pressed())
+    {
+      return UINT32_MAX;
+    }
+    deadline = ddr_timer_timeout_init_us(BENCH_WAIT_STEP_US);
+    while (!ddr_timer_timeout_elapsed(deadline))
+    {
+      data += busy[data & 0xFFFU];
+    }
+  }
+
+  (void)Prbs_Init(&prbs, PRBS_DEFAULT_POLY, 0U, 0U);
+  for (i = 0U; i < nb; i++)
+  {
+    if (addr[i] != Prbs_Next(&prbs))
+    {
+      errors++;
+    }
+  }
+
+  return errors;
+}
+
+static int32_t bench_rfsh_read(bench_rfsh_regs *regs)
+{
+  if ((HAL_DDR_Read_Reg("RFSHCTL0", &regs->rfshctl0) != HAL_OK) ||
+      (HAL_DDR_Read_Reg("RFSHCTL3", &regs->rfshctl3) != HAL_OK) ||
+      (HAL_DDR_Read_Reg("RFSHTMG", &regs->rfshtmg) != HAL_OK) ||
+      (HAL_DDR_Read_Reg("INIT4", &regs->mr3) != HAL_OK))
+  {
+    return -1;
+  }
+
+  /* INIT4.emr3: MR3 as programmed at init */
+  regs->mr3 &= 0xFFFFU;
+
+  return 0;
+}
+
+#if STM32MP_DDR4_TYPE
+static int32_t bench_mr_write(uint32_t mr, uint32_t value)
+{
+  uint32_t mrstat;
+  uint64_t timeout = ddr_timer_timeout_init_us(BENCH_MR_TIMEOUT_US);
+
+  if ((HAL_DDR_Write_Reg("MRCTRL1", value) != HAL_OK) ||
+      (HAL_DDR_Write_Reg("MRCTRL0", BENCH_MR_RANK0 | (mr << BENCH_MR_ADDR_POS)) != HAL_OK) ||
+      (HAL_DDR_Write_Reg("MRCTRL0", BENCH_MR_WR | BENCH_MR_RANK0 |
+                                    (mr << BENCH_MR_ADDR_POS)) != HAL_OK))
+  {
+    return -1;
+  }
+
+  do
+  {
+    if ((HAL_DDR_Read_Reg("MRSTAT", &mrstat) != HAL_OK) ||
+        ddr_timer_timeout_elapsed(timeout))
+    {
+      return -1;
+    }
+  } while ((mrstat & BENCH_MR_WR_BUSY) != 0U);
+
+  return 0;
+}
+#endif /* STM32MP_DDR4_TYPE */
+
+/*
+ * Applies refresh settings; RFSHTMG is written last, its refresh update
+ * (RFSHCTL3.refresh_update_level) taking the RFSHCTL0 fields into account.
+ */
+static int32_t bench_rfsh_write(const bench_rfsh_regs *regs, const bench_rfsh_regs *prev)
+{
+#if STM32MP_DDR4_TYPE
+  if (regs->mr3 != prev->mr3)
+  {
+    /* Refresh mode change: auto-refresh stopped around the MR3 update */
+    if ((HAL_DDR_Write_Reg("RFSHCTL3", prev->rfshctl3 | BENCH_DIS_AUTO_RFSH) != HAL_OK) ||
+        (bench_mr_write(3U, regs->mr3) != 0))
+    {
+      return -1;
+    }
+  }
+#else /* STM32MP_DDR4_TYPE */
+  (void)prev;
+#endif /* STM32MP_DDR4_TYPE */
+
+  if ((HAL_DDR_Write_Reg("RFSHCTL0", regs->rfshctl0) != HAL_OK) ||
+      (HAL_DDR_Write_Reg("RFSHCTL3", regs->rfshctl3) != HAL_OK) ||
+      (HAL_DDR_Write_Reg("RFSHTMG", regs->rfshtmg) != HAL_OK))
+  {
+    return -1;
+  }
+
+  return 0;
+}
+
+/* Refresh interval in DFI clock cycles */
+static uint32_t bench_refi_get(uint32_t rfshtmg)
+{
+  uint32_t nom = (rfshtmg >> BENCH_RFC_NOM_POS) & BENCH_RFC_NOM_MASK;
+
+  return ((rfshtmg & BENCH_RFC_NOM_X1) != 0U) ? nom : (nom * 32U);
+}
+
+/* x1 unit kept for per bank refresh, x32 unit else */
+static uint32_t bench_refi_set(uint32_t rfshtmg, uint32_t refi, bool x1)
+{
+  uint32_t nom = x1 ? refi : (refi / 32U);
+
+  if (nom > BENCH_RFC_NOM_MASK)
+  {
+    nom = BENCH_RFC_NOM_MASK;
+  }
+
+  rfshtmg &= ~((BENCH_RFC_NOM_MASK << BENCH_RFC_NOM_POS) | BENCH_RFC_NOM_X1);
+
+  return rfshtmg | (nom << BENCH_RFC_NOM_POS) | (x1 ? BENCH_RFC_NOM_X1 : 0U);
+}
+
+static uint32_t bench_rfc_set(uint32_t rfshtmg, uint32_t rfc)
+{
+  if (rfc > BENCH_RFC_MIN_MASK)
+  {
+    rfc = BENCH_RFC_MIN_MASK;
+  }
+
+  return (rfshtmg & ~BENCH_RFC_MIN_MASK) | rfc;
+}
+
+static void bench_rfsh_config_regs(enum bench_rfsh_kind kind,
+                                   const bench_rfsh_regs *init,
+                                   bench_rfsh_regs *regs)
+{
+  bool x1 = ((init->rfshtmg & BENCH_RFC_NOM_X1) != 0U);
+  uint32_t refi = bench_refi_get(init->rfshtmg);
+  uint32_t rfc = init->rfshtmg & BENCH_RFC_MIN_MASK;
+
+  *regs = *init;
+
+  switch (kind)
+  {
+    case BENCH_RFSH_FAST:
+      regs->rfshtmg = bench_refi_set(init->rfshtmg, refi / 2U, x1);
+      break;
+    case BENCH_RFSH_SLOW:
+      regs->rfshtmg = bench_refi_set(init->rfshtmg, refi * 2U, x1);
+      break;
+    case BENCH_RFSH_BURST:
+      regs->rfshctl0 &= ~(BENCH_BURST_MASK << BENCH_BURST_POS);
+      regs->rfshctl0 |= BENCH_BURST_MAX << BENCH_BURST_POS;
+      break;
+    case BENCH_RFSH_FGR2:
+    case BENCH_RFSH_FGR4:
+      /* From the 1x mode: tREFI / 2 (4), tRFC2 (4) = 3/4 (9/16) x tRFC1 */
+      regs->rfshtmg = bench_refi_set(init->rfshtmg,
+                                     refi / ((kind == BENCH_RFSH_FGR2) ? 2U : 4U), x1);
+      regs->rfshtmg = bench_rfc_set(regs->rfshtmg, (kind == BENCH_RFSH_FGR2) ?
+                                    (((rfc * 3U) + 3U) / 4U) : (((rfc * 9U) + 15U) / 16U));
+      regs->rfshctl3 &= ~(BENCH_RFSH_MODE_MASK << BENCH_RFSH_MODE_POS);
+      regs->rfshctl3 |= ((kind == BENCH_RFSH_FGR2) ? 1UL : 2UL) << BENCH_RFSH_MODE_POS;
+      regs->mr3 &= ~(BENCH_RFSH_MODE_MASK << BENCH_MR3_FGR_POS);
+      regs->mr3 |= ((kind == BENCH_RFSH_FGR2) ? 1UL : 2UL) << BENCH_MR3_FGR_POS;
+      break;
+    case BENCH_RFSH_BANK:
+      if ((init->rfshctl0 & BENCH_PER_BANK) != 0U)
+      {
+        /* all bank: tREFIab = 8 x tREFIpb, tRFCab = 2 x tRFCpb */
+        regs->rfshctl0 &= ~BENCH_PER_BANK;
+        regs->rfshtmg = bench_refi_set(init->rfshtmg, refi * 8U, false);
+        regs->rfshtmg = bench_rfc_set(regs->rfshtmg, rfc * 2U);
+      }
+      else
+      {
+        regs->rfshctl0 |= BENCH_PER_BANK;
+        regs->rfshtmg = bench_refi_set(init->rfshtmg, refi / 8U, true);
+        regs->rfshtmg = bench_rfc_set(regs->rfshtmg, (rfc + 1U) / 2U);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+static int32_t bench_lp_read(bench_lp_regs *regs)
+{
+  if ((HAL_DDR_Read_Reg("PWRCTL", &regs->pwrctl) != HAL_OK) ||
+      (HAL_DDR_Read_Reg("PWRTMG", &regs->pwrtmg) != HAL_OK) ||
+      (HAL_DDR_Read_Reg("HWLPCTL", &regs->hwlpctl) != HAL_OK) ||
+      (HAL_DDR_Read_Reg("DFILPCFG0", &regs->dfilpcfg0) != HAL_OK) ||
+      (HAL_DDR_Read_Reg("DFILPCFG1", &regs->dfilpcfg1) != HAL_OK))
+  {
+    return -1;
+  }
+
+  return 0;
+}
+
+/*
+ * Applies low-power settings: the low-power entries are disabled while the
+ * timeouts and the DFI low-power settings change, PWRCTL being written last.
+ */
+static int32_t bench_lp_write(const bench_lp_regs *regs)
+{
+  if ((HAL_DDR_Write_Reg("PWRCTL", regs->pwrctl & ~BENCH_PWRCTL_LP) != HAL_OK) ||
+      (HAL_DDR_Write_Reg("PWRTMG", regs->pwrtmg) != HAL_OK) ||
+      (HAL_DDR_Write_Reg("HWLPCTL", regs->hwlpctl) != HAL_OK) ||
+      (HAL_DDR_Write_Reg("DFILPCFG0", regs->dfilpcfg0) != HAL_OK) ||
+      (HAL_DDR_Write_Reg("DFILPCFG1", regs->dfilpcfg1) != HAL_OK) ||
+      (HAL_DDR_Write_Reg("PWRCTL", regs->pwrctl) != HAL_OK))
+  {
+    return -1;
+  }
+
+  return 0;
+}
+
+static void bench_lp_config_regs(const bench_lp_config *config,
+                                 const bench_lp_regs *init,
+                                 bench_lp_regs *regs)
+{
+  *regs = *init;
+
+  if (config->current)
+  {
+    return;
+  }
+
+  regs->pwrctl = (init->pwrctl & ~BENCH_PWRCTL_LP) | config->pwrctl;
+  regs->hwlpctl &= ~BENCH_HW_LP_EN;
+  regs->dfilpcfg0 = (init->dfilpcfg0 & ~BENCH_DFILPCFG0_LP) | config->dfilpcfg0;
+
+  if (config->pd_to != 0U)
+  {
+    regs->pwrtmg &= ~(BENCH_PD_TO_MASK << BENCH_PD_TO_POS);
+    regs->pwrtmg |= config->pd_to << BENCH_PD_TO_POS;
+  }
+  if (config->sr_to != 0U)
+  {
+    regs->pwrtmg &= ~(BENCH_SR_TO_MASK << BENCH_SR_TO_POS);
+    regs->pwrtmg |= config->sr_to << BENCH_SR_TO_POS;
+  }
+}
+
+/*
+ * First-access latency: one load after each idle gap, in its own page.
+ * The CPU runs from the internal memories, the DDR is idle during the gap.
+ */
+static void bench_lp_first_access(bench_lp_result *result)
+{
+  volatile uint32_t *base = (volatile uint32_t *)BENCH_CHASE_BASE;
+  uint32_t step = BENCH_LP_STRIDE / sizeof(uint32_t);
+  uint32_t ticks[BENCH_LP_SAMPLES];
+  uint32_t max = 0U;
+  uint32_t gap;
+  uint32_t i;
+  uint32_t j;
+  uint32_t tmp;
+  uint64_t start;
+
+  for (gap = 0U; gap < BENCH_LP_NB_GAPS; gap++)
+  {
+    for (i = 0U; i < BENCH_LP_SAMPLES; i++)
+    {
+      if (bench_lp_gaps_us[gap] != 0U)
+      {
+        ddr_timer_delay_us(bench_lp_gaps_us[gap]);
+      }
+
+      start = ddr_timer_get_count();
+      (void)base[((gap * BENCH_LP_SAMPLES) + i) * step];
+      /* The load is complete */
+      __DSB();
+      ticks[i] = (uint32_t)(ddr_timer_get_count() - start);
+
+      if (ticks[i] > max)
+      {
+        max = ticks[i];
+      }
+    }
+
+    /* Insertion sort for the median */
+    for (i = 1U; i < BENCH_LP_SAMPLES; i++)
+    {
+      tmp = ticks[i];
+      for (j = i; (j > 0U) && (ticks[j - 1U] > tmp); j--)
+      {
+        ticks[j] = ticks[j - 1U];
+      }
+      ticks[j] = tmp;
+    }
+    result->p50_ns[gap] = bench_ticks_to_ns(ticks[BENCH_LP_SAMPLES / 2U]);
+  }
+
+  result->max_ns = bench_ticks_to_ns(max);
+}
+
+/* Bursty reads: BENCH_LP_BURST bytes after each idle gap, timed in bursts */
+static void bench_lp_bursts(bench_lp_result *result)
+{
+  volatile uint64_t *addr;
+  uint32_t nb = BENCH_LP_BURST / sizeof(uint64_t);
+  uint32_t freq = ddr_timer_get_freq();
+  uint32_t gap;
+  uint32_t burst;
+  uint32_t i;
+  uint64_t ticks;
+  uint64_t start;
+  uint64_t data = 0U;
+
+  for (gap = 0U; gap < BENCH_LP_NB_BURST_GAPS; gap++)
+  {
+    ticks = 0U;
+    for (burst = 0U; burst < BENCH_LP_NB_BURSTS; burst++)
+    {
+      addr = (volatile uint64_t *)(BENCH_BW_BASE + (burst * BENCH_LP_BURST));
+      ddr_timer_delay_us(bench_lp_burst_gaps_us[gap]);
+
+      start = ddr_timer_get_count();
+      for (i = 0U; i < nb; i += 4U)
+      {
+        data ^= addr[i] ^ addr[i + 1U] ^ addr[i + 2U] ^ addr[i + 3U];
+      }
+      __DSB();
+      ticks += ddr_timer_get_count() - start;
+    }
+
+    if (ticks == 0U)
+    {
+      ticks = 1U;
+    }
+    result->kbps[gap] = (uint32_t)(((uint64_t)BENCH_LP_BURST * BENCH_LP_NB_BURSTS * freq) /
+                                   (ticks * 1000U));
+  }
+
+  (void)data;
+}
+
+static bool bench_lp_fits(const bench_lp_result *result, uint32_t budget_ns)
+{
+  uint32_t gap;
+
+  for (gap = 0U; gap < BENCH_LP_NB_GAPS; gap++)
+  {
+    if (result->p50_ns[gap] > budget_ns)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void print_lp_result(const char *name, const bench_lp_result *result, bool fits)
+{
+  uint32_t gap;
+
+  printf("%-8s", name);
+  for (gap = 0U; gap < BENCH_LP_NB_GAPS; gap++)
+  {
+    printf(" %6u", (unsigned int)result->p50_ns[gap]);
+  }
+  printf(" %6u", (unsigned int)result->max_ns);
+  for (gap = 0U; gap < BENCH_LP_NB_BURST_GAPS; gap++)
+  {
+    printf(" %5u.%u", (unsigned int)(result->kbps[gap] / 1000U),
+           (unsigned int)((result->kbps[gap] % 1000U) / 100U));
+  }
+  printf("  %s\n\r", fits ? "ok" : "over");
+}
+
+static void print_result(const char *name, const bench_result *result,
+                         const bench_result *ref, const char *spec)
+{
+  int32_t gain;
+  uint32_t total = result->rd_kbps + result->wr_kbps;
+  uint32_t ref_total = ref->rd_kbps + ref->wr_kbps;
+  char gain_str[16];
+
+  /* per mille of the total bandwidth */
+  gain = (ref_total != 0U) ?
+         (int32_t)((((int64_t)total - ref_total) * 1000) / ref_total) : 0;
+  snprintf(gain_str, sizeof(gain_str), "%c%u.%u%%", (gain < 0) ? '-' : '+',
+           (unsigned int)(((gain < 0) ? -gain : gain) / 10),
+           (unsigned int)(((gain < 0) ? -gain : gain) % 10));
+
+  printf("%-8s %5u.%u %5u.%u %7s %6u %6u %6u %6u  %-11s ", name,
+         (unsigned int)(result->rd_kbps / 1000U), (unsigned int)((result->rd_kbps % 1000U) / 100U),
+         (unsigned int)(result->wr_kbps / 1000U), (unsigned int)((result->wr_kbps % 1000U) / 100U),
+         gain_str,
+         (unsigned int)result->lat_ns[BENCH_LAT_P50],
+         (unsigned int)result->lat_ns[BENCH_LAT_P99],
+         (unsigned int)result->lat_ns[BENCH_LAT_P999],
+         (unsigned int)result->lat_ns[BENCH_LAT_MAX], spec);
+
+  if (result->errors == 0U)
+  {
+    printf("ok\n\r");
+  }
+  else
+  {
+    printf("%u errors\n\r", (unsigned int)result->errors);
+  }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Benchmarks the refresh configurations: bandwidth, pointer chase
+  *         latency and retention, the initial settings being restored.
+  * @param  wait_s retention time in seconds
+  * @retval 0 if success, -1 else
+  */
+int32_t Bench_Refresh(uint32_t wait_s)
+{
+  bench_rfsh_regs init;
+  bench_rfsh_regs prev;
+  bench_rfsh_regs regs;
+  bench_result ref;
+  bench_result result;
+  uint32_t i;
+  int32_t ret = 0;
+
+  if (bench_rfsh_read(&init) != 0)
+  {
+    printf("register read failed\n\r");
+    return -1;
+  }
+
+  memset(&ref, 0, sizeof(ref));
+  bench_chase_init();
+
+  printf("%-8s %7s %7s %7s %6s %6s %6s %6s  %-11s %s\n\r", "config", "rd MB/s",
+         "wr MB/s", "gain", "p50", "p99", "p99.9", "max ns", "JEDEC", "retention");
+
+  prev = init;
+  for (i = 0U; i < (sizeof(bench_rfsh_configs) / sizeof(bench_rfsh_configs[0])); i++)
+  {
+    if (key_pressed())
+    {
+      printf("stopped\n\r");
+      break;
+    }
+
+    bench_rfsh_config_regs(bench_rfsh_configs[i].kind, &init, &regs);
+    if (bench_rfsh_write(&regs, &prev) != 0)
+    {
+      ret = -1;
+      break;
+    }
+    prev = regs;
+
+    bench_bandwidth(&result);
+    bench_latency(&result);
+    result.errors = bench_retention(wait_s);
+    if (result.errors == UINT32_MAX)
+    {
+      printf("stopped\n\r");
+      break;
+    }
+
+    if (bench_rfsh_configs[i].kind == BENCH_RFSH_CURRENT)
+    {
+      ref = result;
+    }
+    print_result(bench_rfsh_configs[i].name, &result, &ref, bench_rfsh_configs[i].spec);
+  }
+
+  if (bench_rfsh_write(&init, &prev) != 0)
+  {
+    ret = -1;
+  }
+
+  if (ret != 0)
+  {
+    printf("register update failed\n\r");
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Benchmarks the low-power settings: first-access latency after
+  *         idle gaps and bursty throughput, the initial settings being
+  *         restored.
+  * @param  budget_ns first-access latency budget in ns
+  * @retval 0 if success, -1 else
+  */
+int32_t Bench_LowPower(uint32_t budget_ns)
+{
+  bench_lp_regs init;
+  bench_lp_regs regs;
+  bench_lp_result result;
+  const char *best = NULL;
+  bool fits;
+  uint32_t i;
+  int32_t ret = 0;
+
+  if (bench_lp_read(&init) != 0)
+  {
+    printf("register read failed\n\r");
+    return -1;
+  }
+
+  printf("first access p50 ns after idle gap, bursts of %u bytes, budget %u ns\n\r",
+         (unsigned int)BENCH_LP_BURST, (unsigned int)budget_ns);
+  printf("%-8s %6s %6s %6s %6s %6s %6s %7s %7s  %s\n\r", "config", "0us", "1us",
+         "10us", "100us", "1ms", "max ns", "MB/s@2", "MB/s@20", "budget");
+
+  for (i = 0U; i < (sizeof(bench_lp_configs) / sizeof(bench_lp_configs[0])); i++)
+  {
+    if (key_pressed())
+    {
+      printf("stopped\n\r");
+      break;
+    }
+
+    bench_lp_config_regs(&bench_lp_configs[i], &init, &regs);
+    if (bench_lp_write(&regs) != 0)
+    {
+      ret = -1;
+      break;
+    }
+
+    bench_lp_first_access(&result);
+    bench_lp_bursts(&result);
+
+    fits = bench_lp_fits(&result, budget_ns);
+    if (fits && !bench_lp_configs[i].current)
+    {
+      best = bench_lp_configs[i].name;
+    }
+    print_lp_result(bench_lp_configs[i].name, &result, fits);
+  }
+
+  if (bench_lp_write(&init) != 0)
+  {
+    ret = -1;
+  }
+
+  if (ret != 0)
+  {
+    printf("register update failed\n\r");
+    return ret;
+  }
+
+  if (best != NULL)
+  {
+    printf("most aggressive setting within budget: %s\n\r", best);
+  }
+  else
+  {
+    printf("no setting within budget\n\r");
+  }
+
+  return ret;
+}
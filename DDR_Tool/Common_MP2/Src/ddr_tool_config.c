@@ -0,0 +1,390 @@
+/**
+  ******************************************************************************
+  * @file    ddr_tool_config.c
+  * @author  MCD Application Team
+  * @brief   Upload of a DDR configuration over the console UART.
+  *          The configuration blob (see ddr_tool_config.h) is received with
+  *          the XMODEM protocol (CRC-16, 128 or 1024 byte blocks), checked and
+  *          loaded in static_ddr_config, so that a new configuration is tested
+  *          without rebuilding the tool.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32_device_hal.h"
+
+#include "stddef.h"
+#include "string.h"
+#include "ddr_tool_util.h"
+#include "ddr_tool_config.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define XMODEM_SOH             0x01U
+#define XMODEM_STX             0x02U
+#define XMODEM_EOT             0x04U
+#define XMODEM_ACK             0x06U
+#define XMODEM_NAK             0x15U
+#define XMODEM_CAN             0x18U
+#define XMODEM_CRC_MODE        'C'
+#define XMODEM_CRC_INIT        0U
+
+#define XMODEM_BLOCK_SIZE      128U
+#define XMODEM_BLOCK_1K_SIZE   1024U
+#define XMODEM_TIMEOUT_US      1000000U
+#define XMODEM_PURGE_US        100000U
+#define XMODEM_START_RETRY     60U
+#define XMODEM_MAX_ERRORS      10U
+
+/* End of a static_ddr_config member, excluding the tail padding */
+#define DDR_CONFIG_MEMBER_SIZE(m) (sizeof(((HAL_DDR_ConfigTypeDef *)0)->m))
+#define DDR_CONFIG_MEMBER_END(m) \
+  (offsetof(HAL_DDR_ConfigTypeDef, m) + DDR_CONFIG_MEMBER_SIZE(m))
+
+/* 32-bit words of static_ddr_config from c_reg to p_pll (the last member) */
+#define DDR_CONFIG_NB_WORDS \
+  ((DDR_CONFIG_MEMBER_END(p_pll) - offsetof(HAL_DDR_ConfigTypeDef, c_reg)) / \
+   sizeof(uint32_t))
+
+#define DDR_CONFIG_MAX_SIZE \
+  (DDR_CONFIG_HEADER_SIZE + (DDR_CONFIG_NB_WORDS * sizeof(uint32_t)))
+
+/*
+ * ddr_config_load.py sends one word per 32-bit field of the members after
+ * info: the members must follow each other without padding.
+ */
+_Static_assert((DDR_CONFIG_MEMBER_SIZE(c_reg) + DDR_CONFIG_MEMBER_SIZE(c_timing) +
+                DDR_CONFIG_MEMBER_SIZE(c_map) + DDR_CONFIG_MEMBER_SIZE(c_perf) +
+                DDR_CONFIG_MEMBER_SIZE(p_uib) + DDR_CONFIG_MEMBER_SIZE(p_uia) +
+                DDR_CONFIG_MEMBER_SIZE(p_uim) + DDR_CONFIG_MEMBER_SIZE(p_uis) +
+                DDR_CONFIG_MEMBER_SIZE(p_pll)) ==
+               (DDR_CONFIG_NB_WORDS * sizeof(uint32_t)),
+               "DDR configuration layout differs from ddr_config_load.py");
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+extern HAL_DDR_ConfigTypeDef static_ddr_config;
+
+/* Received blob, rounded up to a whole number of XMODEM 1K blocks */
+static uint8_t config_buf[((DDR_CONFIG_MAX_SIZE + XMODEM_BLOCK_1K_SIZE - 1U) /
+                           XMODEM_BLOCK_1K_SIZE) * XMODEM_BLOCK_1K_SIZE];
+static uint8_t xmodem_block[XMODEM_BLOCK_1K_SIZE];
+static HAL_DDR_ConfigTypeDef config_new;
+static char config_name[DDR_CONFIG_NAME_SIZE];
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+static void xmodem_purge(void)
+{
+  uint8_t data;
+
+  while (Serial_GetByte(&data, XMODEM_PURGE_US) == 0)
+  {
+  }
+}
+
+static void xmodem_cancel(void)
+{
+  xmodem_purge();
+  Serial_Putchar((char)XMODEM_CAN);
+  Serial_Putchar((char)XMODEM_CAN);
+  Serial_Flush();
+}
+
+static int32_t xmodem_read(uint8_t *data, uint32_t len)
+{
+  uint32_t i;
+
+  for (i = 0; i < len; i++)
+  {
+    if (Serial_GetByte(&data[i], XMODEM_TIMEOUT_US) != 0)
+    {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * Receives a file with the XMODEM-CRC protocol.
+ * Returns 0 when received, -1 if no sender, -2 if cancelled by the sender,
+ * -3 on too many errors, -4 if the file does not fit in buf.
+ */
+static int32_t xmodem_receive(uint8_t *buf, uint32_t buf_size, uint32_t *len)
+{
+  uint8_t expected = 1U;
+  uint32_t errors = 0U;
+  uint32_t retry;
+  uint32_t size;
+  uint8_t head[2];
+  uint8_t crc[2];
+  uint8_t data;
+
+  *len = 0U;
+
+  /* Request CRC mode until the sender starts */
+  for (retry = 0U; retry < XMODEM_START_RETRY; retry++)
+  {
+    Serial_Putchar(XMODEM_CRC_MODE);
+    if (Serial_GetByte(&data, XMODEM_TIMEOUT_US) == 0)
+    {
+      break;
+    }
+  }
+
+  if (retry == XMODEM_START_RETRY)
+  {
+    return -1;
+  }
+
+  while (1)
+  {
+    switch (data)
+    {
+      case XMODEM_SOH:
+        size = XMODEM_BLOCK_SIZE;
+        break;
+      case XMODEM_STX:
+        size = XMODEM_BLOCK_1K_SIZE;
+        break;
+      case XMODEM_EOT:
+        Serial_Putchar((char)XMODEM_ACK);
+        Serial_Flush();
+        return 0;
+      case XMODEM_CAN:
+        if ((Serial_GetByte(&data, XMODEM_TIMEOUT_US) == 0) &&
+            (data == XMODEM_CAN))
+        {
+          return -2;
+        }
+        size = 0U;
+        break;
+      default:
+        size = 0U;
+        break;
+    }
+
+    if ((size != 0U) &&
+        (xmodem_read(head, sizeof(head)) == 0) &&
+        (xmodem_read(xmodem_block, size) == 0) &&
+        (xmodem_read(crc, sizeof(crc)) == 0) &&
+        ((uint8_t)(head[0] ^ head[1]) == 0xFFU) &&
+        (util_crc16(xmodem_block, size, XMODEM_CRC_INIT) == (((uint16_t)crc[0] << 8) | crc[1])))
+    {
+      if (head[0] == expected)
+      {
+        if ((*len + size) > buf_size)
+        {
+          xmodem_cancel();
+          return -4;
+        }
+
+        memcpy(&buf[*len], xmodem_block, size);
+        *len += size;
+        expected++;
+        errors = 0U;
+      }
+      else if (head[0] != (uint8_t)(expected - 1U))
+      {
+        /* Neither the expected block nor a repeated one: out of sync */
+        xmodem_cancel();
+        return -3;
+      }
+
+      Serial_Putchar((char)XMODEM_ACK);
+    }
+    else
+    {
+      if (++errors > XMODEM_MAX_ERRORS)
+      {
+        xmodem_cancel();
+        return -3;
+      }
+
+      xmodem_purge();
+      Serial_Putchar((char)XMODEM_NAK);
+    }
+
+    while (Serial_GetByte(&data, XMODEM_TIMEOUT_US) != 0)
+    {
+      if (++errors > XMODEM_MAX_ERRORS)
+      {
+        xmodem_cancel();
+        return -3;
+      }
+
+      Serial_Putchar((char)XMODEM_NAK);
+    }
+  }
+}
+
+static uint32_t config_crc32(const uint8_t *data, uint32_t len, uint32_t crc)
+{
+  uint32_t i;
+  uint8_t bit;
+
+  crc = ~crc;
+
+  for (i = 0; i < len; i++)
+  {
+    crc ^= data[i];
+
+    for (bit = 0; bit < 8U; bit++)
+    {
+      crc = ((crc & 1U) != 0U) ? ((crc >> 1) ^ 0xEDB88320U) : (crc >> 1);
+    }
+  }
+
+  return ~crc;
+}
+
+static uint32_t get_le32(const uint8_t *data)
+{
+  return (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+         ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static int32_t config_check(const uint8_t *blob, uint32_t len)
+{
+  uint32_t nb_words;
+  uint32_t crc;
+
+  if (len < DDR_CONFIG_HEADER_SIZE)
+  {
+    printf("configuration too short (%lu bytes)\n\r", (unsigned long)len);
+    return -1;
+  }
+
+  if (get_le32(&blob[0]) != DDR_CONFIG_MAGIC)
+  {
+    printf("not a DDR configuration\n\r");
+    return -1;
+  }
+
+  if (((get_le32(&blob[4]) & 0xFFFFU) != DDR_CONFIG_VERSION) ||
+      ((get_le32(&blob[4]) >> 16) != DDR_CONFIG_HEADER_SIZE))
+  {
+    printf("unsupported configuration version %lu (expected %u)\n\r",
+           (unsigned long)(get_le32(&blob[4]) & 0xFFFFU), DDR_CONFIG_VERSION);
+    return -1;
+  }
+
+  nb_words = get_le32(&blob[8]);
+  if (nb_words != DDR_CONFIG_NB_WORDS)
+  {
+    printf("configuration of %lu words, %lu expected by this tool\n\r",
+           (unsigned long)nb_words, (unsigned long)DDR_CONFIG_NB_WORDS);
+    return -1;
+  }
+
+  if (len < DDR_CONFIG_MAX_SIZE)
+  {
+    printf("configuration truncated (%lu bytes)\n\r", (unsigned long)len);
+    return -1;
+  }
+
+  crc = config_crc32(blob, DDR_CONFIG_HEADER_SIZE - 4U, 0U);
+  crc = config_crc32(&blob[DDR_CONFIG_HEADER_SIZE], nb_words * 4U, crc);
+  if (crc != get_le32(&blob[DDR_CONFIG_HEADER_SIZE - 4U]))
+  {
+    printf("configuration CRC error\n\r");
+    return -1;
+  }
+
+  return 0;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Receives a DDR configuration blob over the console with XMODEM
+  *         and loads it in static_ddr_config.
+  *         The current configuration is kept when the blob is not valid.
+  * @param  None
+  * @retval 0 if loaded, -1 else
+  */
+int32_t DDR_Config_Load(void)
+{
+  uint32_t len;
+  uint32_t i;
+  int32_t ret;
+
+  printf("Start the XMODEM (CRC or 1K) transfer of the configuration file...\n\r");
+  fflush(stdout);
+  Serial_Flush();
+
+  ret = xmodem_receive(config_buf, sizeof(config_buf), &len);
+
+  /* Let the host terminal leave its transfer mode */
+  xmodem_purge();
+
+  switch (ret)
+  {
+    case 0:
+      break;
+    case -1:
+      printf("\n\rno transfer started\n\r");
+      return -1;
+    case -2:
+      printf("\n\rtransfer cancelled\n\r");
+      return -1;
+    case -4:
+      printf("\n\rfile too large for a DDR configuration\n\r");
+      return -1;
+    default:
+      printf("\n\rtransfer failed\n\r");
+      return -1;
+  }
+
+  printf("\n\rreceived %lu bytes\n\r", (unsigned long)len);
+
+  if (config_check(config_buf, len) != 0)
+  {
+    return -1;
+  }
+
+  config_new = static_ddr_config;
+  memcpy(&config_new.c_reg, &config_buf[DDR_CONFIG_HEADER_SIZE],
+         DDR_CONFIG_NB_WORDS * sizeof(uint32_t));
+  config_new.info.speed = get_le32(&config_buf[12]);
+  config_new.info.size = ((uint64_t)get_le32(&config_buf[20]) << 32) |
+                         get_le32(&config_buf[16]);
+
+  /* The driver is built for one DDR type */
+  if (config_new.p_uib.dramtype != static_ddr_config.p_uib.dramtype)
+  {
+    printf("DDR type %d not supported by this tool (%d)\n\r",
+           (int)config_new.p_uib.dramtype,
+           (int)static_ddr_config.p_uib.dramtype);
+    return -1;
+  }
+
+  if ((config_new.info.speed == 0U) || (config_new.info.size == 0U))
+  {
+    printf("invalid speed or size\n\r");
+    return -1;
+  }
+
+  for (i = 0; i < (DDR_CONFIG_NAME_SIZE - 1U); i++)
+  {
+    config_name[i] = (char)config_buf[24U + i];
+  }
+  config_name[DDR_CONFIG_NAME_SIZE - 1U] = '\0';
+  config_new.info.name = config_name;
+
+  static_ddr_config = config_new;
+
+  return 0;
+}
@@ -0,0 +1,1033 @@
+/**
+  ******************************************************************************
+  * @file    ddr_tool_jedec.c
+  * @author  MCD Application Team
+  * @brief   JEDEC timing calculator, see ddr_tool_jedec.h: the JEDEC timings
+  *          of a speed bin are rounded to clock cycles at the target
+  *          frequency, then converted to controller register fields (1:2
+  *          frequency ratio: DFI clock cycles, rounded up), mode registers
+  *          and PHY settings.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32_device_hal.h"
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "strings.h"
+#include "ddr_tool_jedec.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+  const char *name;
+  uint32_t value;
+  uint32_t min;
+  uint32_t max;
+  const char *help;
+} jedec_param;
+
+/* Index in jedec_params[] */
+enum jedec_param_id {
+  JEDEC_TYPE,
+  JEDEC_DENSITY,
+  JEDEC_WIDTH,
+  JEDEC_BIN,
+  JEDEC_FREQ,
+};
+
+/* Slowest speed bin of a data rate */
+typedef struct {
+  uint16_t rate;      /* MT/s */
+  uint32_t taa;       /* tAA = tRCD = tRP, ps */
+} jedec_bin;
+
+/*
+ * Core timings of a type, in ps (2KB page for x16): the most relaxed value
+ * of all its speed bins, as in the ST reference configurations
+ */
+typedef struct {
+  uint32_t tras;
+  uint32_t trrd;      /* DDR4: tRRD_L */
+  uint32_t trrd_s;    /* DDR4 */
+  uint32_t tfaw;
+  uint32_t tccd_l;    /* DDR4 */
+  uint32_t tcke;
+  uint32_t txp;
+  uint32_t tdllk;     /* nCK */
+} jedec_core;
+
+/* Refresh cycle time per density, in ps */
+typedef struct {
+  uint8_t density;    /* Gbits */
+  uint32_t trfc;      /* DDR3/DDR4: tRFC(1), LPDDR4: tRFCab */
+  uint32_t trfc4;     /* DDR4: tRFC4 */
+} jedec_density;
+
+/* LPDDR4 latencies (set A, read DBI off) up to a frequency */
+typedef struct {
+  uint16_t freq;      /* MHz */
+  uint8_t rl;
+  uint8_t wl;
+  uint8_t nwr;
+} jedec_lp4_latency;
+
+/* Timings in clock cycles (nCK) */
+typedef struct {
+  uint64_t tck_fs;
+  uint32_t cl;        /* LPDDR4: RL */
+  uint32_t cwl;       /* LPDDR4: WL */
+  uint32_t wr;
+  uint32_t code;      /* LPDDR4: RL/WL/nWR code of MR1/MR2 */
+  uint32_t bl;
+  uint32_t rcd;
+  uint32_t rp;        /* LPDDR4: tRPpb */
+  uint32_t ras;
+  uint32_t rc;
+  uint32_t rrd;
+  uint32_t rrd_s;
+  uint32_t faw;
+  uint32_t ccd;
+  uint32_t ccd_l;
+  uint32_t wtr;
+  uint32_t wtr_s;
+  uint32_t rtp;
+  uint32_t mrd;
+  uint32_t mrw;
+  uint32_t mod;
+  uint32_t xp;
+  uint32_t cke;
+  uint32_t ckesr;
+  uint32_t cksre;
+  uint32_t cksrx;
+  uint32_t rfc;       /* LPDDR4: tRFCpb */
+  uint32_t rfc4;
+  uint32_t refi;      /* LPDDR4: tREFIpb, rounded down */
+  uint32_t ras_max;   /* rounded down */
+  uint32_t xs;        /* LPDDR4: tXSR */
+  uint32_t dllk;
+  uint32_t pbr2pbr;
+  uint32_t dqsck;
+  uint32_t zqcs;      /* LPDDR4: tZQLAT */
+  uint32_t zqoper;    /* LPDDR4: tZQCAL */
+} jedec_timing;
+
+/* Private define ------------------------------------------------------------*/
+#if STM32MP_DDR3_TYPE
+#define JEDEC_BUILD_TYPE    STM32MP_DDR3
+#define JEDEC_DEFAULT_BIN   1866U
+#elif STM32MP_DDR4_TYPE
+#define JEDEC_BUILD_TYPE    STM32MP_DDR4
+#define JEDEC_DEFAULT_BIN   2400U
+#else /* STM32MP_LPDDR4_TYPE */
+#define JEDEC_BUILD_TYPE    STM32MP_LPDDR4
+#define JEDEC_DEFAULT_BIN   3200U
+#endif /* STM32MP_DDR3_TYPE */
+
+#ifdef DDR_SIZE_Gb
+#define JEDEC_DEFAULT_DENSITY (DDR_SIZE_Gb / 2U)
+#else /* DDR_SIZE_Gb */
+#define JEDEC_DEFAULT_DENSITY 8U
+#endif /* DDR_SIZE_Gb */
+
+#define JEDEC_NAME_MAX_LEN  64U
+
+/* PLL2 VCO range, in Hz; DDR clock = 2 x PLL2 output */
+#define JEDEC_VCO_MIN       800000000ULL
+#define JEDEC_VCO_MAX       3200000000ULL
+#define JEDEC_POSTDIV_MAX   7U
+
+#define JEDEC_TREFI         7800000U  /* DDR3/DDR4, ps */
+#define JEDEC_LP4_TREFI     3904000U  /* LPDDR4 all bank, ps */
+
+/* Private macro -------------------------------------------------------------*/
+#define JEDEC_NB(x) (sizeof(x) / sizeof((x)[0]))
+
+/* Private variables ---------------------------------------------------------*/
+extern HAL_DDR_ConfigTypeDef static_ddr_config;
+
+static const char * const jedec_type_name[] = {
+  [STM32MP_DDR3] = "ddr3",
+  [STM32MP_DDR4] = "ddr4",
+  [STM32MP_LPDDR4] = "lpddr4",
+};
+
+static jedec_param jedec_params[] = {
+  /* JEDEC_TYPE */
+  {"type",    JEDEC_BUILD_TYPE, STM32MP_DDR3, STM32MP_LPDDR4,
+   "ddr3, ddr4 or lpddr4"},
+  /* JEDEC_DENSITY */
+  {"density", JEDEC_DEFAULT_DENSITY, 1U, 16U,
+   "Gbits per x16 device (per channel for LPDDR4)"},
+  /* JEDEC_WIDTH */
+  {"width",   32U, 16U, 32U, "data bus width (16 or 32)"},
+  /* JEDEC_BIN */
+  {"bin",     JEDEC_DEFAULT_BIN, 800U, 4267U, "speed bin (MT/s)"},
+  /* JEDEC_FREQ */
+  {"freq",    DDR_FREQ, 100U, JEDEC_MAX_FREQ, "DDR clock frequency (MHz)"},
+};
+
+static const jedec_bin jedec_ddr3_bins[] = {
+  {800U, 15000U}, {1066U, 15000U}, {1333U, 15000U}, {1600U, 13750U},
+  {1866U, 13910U}, {2133U, 13090U},
+};
+
+static const jedec_bin jedec_ddr4_bins[] = {
+  {1600U, 15000U}, {1866U, 15000U}, {2133U, 15000U}, {2400U, 15000U},
+  {2666U, 15000U}, {2933U, 15000U}, {3200U, 15000U},
+};
+
+static const jedec_core jedec_ddr3_core = {
+  37500U, 10000U, 10000U, 50000U, 0U, 7500U, 7500U, 512U,
+};
+
+static const jedec_core jedec_ddr4_core = {
+  35000U, 7500U, 6000U, 35000U, 6250U, 5000U, 6000U, 1024U,
+};
+
+/* LPDDR4 core timings do not depend on the speed bin */
+static const uint16_t jedec_lp4_bins[] = {
+  1600U, 2133U, 2667U, 3200U, 3733U, 4267U,
+};
+
+static const jedec_density jedec_ddr3_densities[] = {
+  {1U, 110000U, 0U}, {2U, 160000U, 0U}, {4U, 260000U, 0U}, {8U, 350000U, 0U},
+};
+
+static const jedec_density jedec_ddr4_densities[] = {
+  {2U, 160000U, 90000U}, {4U, 260000U, 110000U}, {8U, 350000U, 160000U},
+  {16U, 550000U, 260000U},
+};
+
+static const jedec_density jedec_lp4_densities[] = {
+  {2U, 130000U, 0U}, {3U, 180000U, 0U}, {4U, 180000U, 0U}, {6U, 280000U, 0U},
+  {8U, 280000U, 0U}, {12U, 380000U, 0U}, {16U, 380000U, 0U},
+};
+
+static const jedec_lp4_latency jedec_lp4_latencies[] = {
+  { 266U,  6U,  4U,  6U}, { 533U, 10U,  6U, 10U}, { 800U, 14U,  8U, 16U},
+  {1066U, 20U, 10U, 20U}, {1333U, 24U, 12U, 24U}, {1600U, 28U, 14U, 30U},
+  {1866U, 32U, 16U, 34U}, {2133U, 36U, 18U, 40U},
+};
+
+/* Supported values, in the order of their mode register code */
+static const uint8_t jedec_ddr3_wr[] = {16U, 5U, 6U, 7U, 8U, 10U, 12U, 14U};
+static const uint8_t jedec_ddr4_cl[] = {
+  9U, 10U, 11U, 12U, 13U, 14U, 15U, 16U, 18U, 20U, 22U, 24U, 23U, 17U, 19U, 21U,
+};
+static const uint8_t jedec_ddr4_cwl[] = {9U, 10U, 11U, 12U, 14U, 16U, 18U, 20U};
+static const uint8_t jedec_ddr4_wr[] = {10U, 12U, 14U, 16U, 18U, 20U, 24U, 22U};
+
+/*
+ * Mode register bits not depending on the frequency (drive strength, ODT,
+ * VrefDQ...), from the ST reference configurations: used when the DRAM type
+ * is not the built one.
+ */
+static const HAL_DDR_ModeRegisterUiTypeDef jedec_board_mr[] = {
+  [STM32MP_DDR3] = {
+    .mr0 = {0x1000}, .mr2 = {0x0200},
+  },
+  [STM32MP_DDR4] = {
+    .mr1 = {0x0103}, .mr4 = {0x0008}, .mr5 = {0x0460}, .mr6 = {0x0016},
+  },
+  [STM32MP_LPDDR4] = {
+    .mr1 = {0x0084}, .mr3 = {0x0031}, .mr11 = {0x0066}, .mr12 = {0x0047},
+    .mr13 = {0x0008}, .mr14 = {0x0047}, .mr22 = {0x0005},
+  },
+};
+
+static char jedec_name[JEDEC_NAME_MAX_LEN];
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t jedec_get(enum jedec_param_id id)
+{
+  return jedec_params[id].value;
+}
+
+/* Cycles of a time in ps, rounded up with the JEDEC 0.025 tCK guard */
+static uint32_t jedec_nck(const jedec_timing *t, uint32_t ps, uint32_t min_nck)
+{
+  uint32_t nck;
+
+  nck = (uint32_t)(((((uint64_t)ps * 1000000U) / t->tck_fs) + 974U) / 1000U);
+
+  return (nck < min_nck) ? min_nck : nck;
+}
+
+/* Cycles of a time in ps, rounded down (maximum intervals) */
+static uint32_t jedec_nck_max(const jedec_timing *t, uint32_t ps)
+{
+  return (uint32_t)(((uint64_t)ps * 1000U) / t->tck_fs);
+}
+
+/* DFI clock cycles (1:2 frequency ratio), rounded up */
+static uint32_t jedec_dfi(uint32_t nck)
+{
+  return (nck + 1U) / 2U;
+}
+
+/* Index of the first supported value not below value, -1 if none */
+static int32_t jedec_round_up(const uint8_t *list, uint32_t nb, uint32_t *value)
+{
+  uint32_t best = 0U;
+  int32_t index = -1;
+  uint32_t i;
+
+  for (i = 0U; i < nb; i++)
+  {
+    if ((list[i] >= *value) && ((index < 0) || (list[i] < best)))
+    {
+      best = list[i];
+      index = (int32_t)i;
+    }
+  }
+
+  if (index >= 0)
+  {
+    *value = best;
+  }
+
+  return index;
+}
+
+static const jedec_bin *jedec_find_bin(uint32_t type, uint32_t rate)
+{
+  const jedec_bin *bins = (type == STM32MP_DDR3) ? jedec_ddr3_bins : jedec_ddr4_bins;
+  uint32_t nb = (type == STM32MP_DDR3) ? JEDEC_NB(jedec_ddr3_bins) : JEDEC_NB(jedec_ddr4_bins);
+  uint32_t i;
+
+  for (i = 0U; i < nb; i++)
+  {
+    if (bins[i].rate == rate)
+    {
+      return &bins[i];
+    }
+  }
+
+  return NULL;
+}
+
+static const jedec_density *jedec_find_density(uint32_t type, uint32_t density)
+{
+  const jedec_density *list;
+  uint32_t nb;
+  uint32_t i;
+
+  switch (type)
+  {
+    case STM32MP_DDR3:
+      list = jedec_ddr3_densities;
+      nb = JEDEC_NB(jedec_ddr3_densities);
+      break;
+    case STM32MP_DDR4:
+      list = jedec_ddr4_densities;
+      nb = JEDEC_NB(jedec_ddr4_densities);
+      break;
+    default:
+      list = jedec_lp4_densities;
+      nb = JEDEC_NB(jedec_lp4_densities);
+      break;
+  }
+
+  for (i = 0U; i < nb; i++)
+  {
+    if (list[i].density == density)
+    {
+      return &list[i];
+    }
+  }
+
+  return NULL;
+}
+
+static int32_t jedec_ddr_timings(jedec_timing *t, uint32_t type, uint32_t freq,
+                                 const jedec_bin *bin,
+                                 const jedec_density *dens)
+{
+  const jedec_core *core = (type == STM32MP_DDR3) ? &jedec_ddr3_core : &jedec_ddr4_core;
+  const uint8_t *cl_list = jedec_ddr4_cl;
+  uint32_t cl_nb = JEDEC_NB(jedec_ddr4_cl);
+
+  t->bl = 8U;
+  t->cl = jedec_nck(t, bin->taa, 5U);
+
+  if (type == STM32MP_DDR3)
+  {
+    /* CWL 5 to 10, one step per tCK range */
+    t->cwl = (freq <= 400U) ? 5U : (freq <= 533U) ? 6U : (freq <= 667U) ? 7U :
+             (freq <= 800U) ? 8U : (freq <= 933U) ? 9U : 10U;
+    if (t->cl > 14U)
+    {
+      return -1;
+    }
+    t->wr = jedec_nck(t, 15000U, 5U);
+    if (jedec_round_up(jedec_ddr3_wr, JEDEC_NB(jedec_ddr3_wr), &t->wr) < 0)
+    {
+      return -1;
+    }
+    t->rrd = jedec_nck(t, core->trrd, 4U);
+    t->rrd_s = t->rrd;
+    t->ccd = 4U;
+    t->ccd_l = 4U;
+    t->wtr = jedec_nck(t, 7500U, 4U);
+    t->wtr_s = t->wtr;
+    t->mrd = 4U;
+    t->mod = jedec_nck(t, 15000U, 12U);
+    t->xp = jedec_nck(t, core->txp, 3U);
+    t->rfc4 = 0U;
+    t->zqcs = jedec_nck(t, 80000U, 64U);
+    t->zqoper = jedec_nck(t, 320000U, 256U);
+  }
+  else
+  {
+    t->cwl = (freq <= 800U) ? 9U : (freq <= 933U) ? 10U : (freq <= 1066U) ? 11U :
+             (freq <= 1200U) ? 12U : (freq <= 1333U) ? 14U : 16U;
+    if (jedec_round_up(cl_list, cl_nb, &t->cl) < 0)
+    {
+      return -1;
+    }
+    t->wr = jedec_nck(t, 15000U, 10U);
+    if (jedec_round_up(jedec_ddr4_wr, JEDEC_NB(jedec_ddr4_wr), &t->wr) < 0)
+    {
+      return -1;
+    }
+    t->rrd = jedec_nck(t, core->trrd, 4U);
+    t->rrd_s = jedec_nck(t, core->trrd_s, 4U);
+    t->ccd = 4U;
+    t->ccd_l = jedec_nck(t, core->tccd_l, 5U);
+    t->wtr = jedec_nck(t, 7500U, 4U);
+    t->wtr_s = jedec_nck(t, 2500U, 2U);
+    t->mrd = 8U;
+    t->mod = jedec_nck(t, 15000U, 24U);
+    t->xp = jedec_nck(t, core->txp, 4U);
+    t->rfc4 = jedec_nck(t, dens->trfc4 + 10000U, 5U);
+    t->zqcs = 128U;
+    t->zqoper = 512U;
+  }
+
+  t->rcd = t->cl;
+  t->rp = t->cl;
+  t->ras = jedec_nck(t, core->tras, 1U);
+  t->rc = jedec_nck(t, core->tras + bin->taa, 1U);
+  t->faw = jedec_nck(t, core->tfaw, 1U);
+  t->rtp = jedec_nck(t, 7500U, 4U);
+  t->mrw = 0U;
+  t->cke = jedec_nck(t, core->tcke, 3U);
+  t->ckesr = t->cke + 1U;
+  t->cksre = jedec_nck(t, 10000U, 5U);
+  t->cksrx = t->cksre;
+  t->rfc = jedec_nck(t, dens->trfc, 1U);
+  t->refi = jedec_nck_max(t, JEDEC_TREFI);
+  t->ras_max = 9U * t->refi;
+  t->xs = jedec_nck(t, dens->trfc + 10000U, 5U);
+  t->dllk = core->tdllk;
+  t->pbr2pbr = 0U;
+  t->dqsck = 0U;
+
+  return 0;
+}
+
+static int32_t jedec_lp4_timings(jedec_timing *t, uint32_t freq,
+                                 const jedec_density *dens)
+{
+  uint32_t i;
+
+  for (i = 0U; i < JEDEC_NB(jedec_lp4_latencies); i++)
+  {
+    if (freq <= jedec_lp4_latencies[i].freq)
+    {
+      break;
+    }
+  }
+  if (i == JEDEC_NB(jedec_lp4_latencies))
+  {
+    return -1;
+  }
+
+  t->code = i;
+  t->cl = jedec_lp4_latencies[i].rl;
+  t->cwl = jedec_lp4_latencies[i].wl;
+  t->wr = jedec_lp4_latencies[i].nwr;
+  t->bl = 16U;
+  t->rcd = jedec_nck(t, 18000U, 4U);
+  t->rp = jedec_nck(t, 18000U, 4U);
+  t->ras = jedec_nck(t, 42000U, 3U);
+  t->rc = jedec_nck(t, 42000U + 18000U, 1U);
+  t->rrd = jedec_nck(t, 10000U, 4U);
+  t->rrd_s = t->rrd;
+  t->faw = jedec_nck(t, 40000U, 1U);
+  t->ccd = 8U;
+  t->ccd_l = 8U;
+  t->wtr = jedec_nck(t, 10000U, 8U);
+  t->wtr_s = t->wtr;
+  t->rtp = jedec_nck(t, 7500U, 8U);
+  t->mrd = jedec_nck(t, 14000U, 10U);
+  t->mrw = jedec_nck(t, 14000U, 10U);   /* tMRWCKEL */
+  t->mod = 0U;
+  t->xp = jedec_nck(t, 7500U, 5U);
+  /* tCKE covers the self refresh minimum time tSR */
+  t->ckesr = jedec_nck(t, 15000U, 3U);
+  t->cke = jedec_nck(t, 7500U, 4U);
+  if (t->cke < t->ckesr)
+  {
+    t->cke = t->ckesr;
+  }
+  t->cksre = jedec_nck(t, 5000U, 5U);   /* tCKELCK */
+  t->cksrx = jedec_nck(t, 1750U, 3U);   /* tCKCKEH */
+  t->rfc = jedec_nck(t, dens->trfc / 2U, 1U);
+  t->rfc4 = 0U;
+  t->refi = jedec_nck_max(t, JEDEC_LP4_TREFI / 8U);
+  t->ras_max = 9U * jedec_nck_max(t, JEDEC_LP4_TREFI);
+  t->xs = jedec_nck(t, dens->trfc + 7500U, 2U);
+  t->dllk = 0U;
+  t->pbr2pbr = jedec_nck(t, 90000U, 1U);
+  t->dqsck = jedec_nck(t, 3500U, 1U);
+  t->zqcs = jedec_nck(t, 30000U, 8U);
+  t->zqoper = jedec_nck(t, 1000000U, 1U);
+
+  return 0;
+}
+
+static int32_t jedec_timings(jedec_timing *t)
+{
+  uint32_t type = jedec_get(JEDEC_TYPE);
+  uint32_t rate = jedec_get(JEDEC_BIN);
+  uint32_t freq = jedec_get(JEDEC_FREQ);
+  const jedec_density *dens;
+  const jedec_bin *bin = NULL;
+  uint32_t i;
+
+  memset(t, 0, sizeof(*t));
+  t->tck_fs = 1000000000ULL / freq;
+
+  if (type == STM32MP_LPDDR4)
+  {
+    for (i = 0U; i < JEDEC_NB(jedec_lp4_bins); i++)
+    {
+      if (jedec_lp4_bins[i] == rate)
+      {
+        break;
+      }
+    }
+    if (i == JEDEC_NB(jedec_lp4_bins))
+    {
+      rate = 0U;
+    }
+  }
+  else
+  {
+    bin = jedec_find_bin(type, rate);
+    if (bin == NULL)
+    {
+      rate = 0U;
+    }
+  }
+
+  if (rate == 0U)
+  {
+    printf("no %s speed bin %u\n\r", jedec_type_name[type],
+           (unsigned int)jedec_get(JEDEC_BIN));
+    return -1;
+  }
+
+  if ((2U * freq) > rate)
+  {
+    printf("freq %u MHz above the speed bin %u\n\r", (unsigned int)freq,
+           (unsigned int)rate);
+    return -1;
+  }
+
+  /* DLL on mode: tCK(avg) max 3.3 ns (DDR3), 1.6 ns (DDR4) */
+  if (((type == STM32MP_DDR3) && (freq < 300U)) ||
+      ((type == STM32MP_DDR4) && (freq < 625U)))
+  {
+    printf("freq %u MHz below the DLL on minimum\n\r", (unsigned int)freq);
+    return -1;
+  }
+
+  dens = jedec_find_density(type, jedec_get(JEDEC_DENSITY));
+  if (dens == NULL)
+  {
+    printf("no %s density %u Gbits\n\r", jedec_type_name[type],
+           (unsigned int)jedec_get(JEDEC_DENSITY));
+    return -1;
+  }
+
+  if (((type == STM32MP_LPDDR4) ? jedec_lp4_timings(t, freq, dens) :
+                                  jedec_ddr_timings(t, type, freq, bin, dens)) != 0)
+  {
+    printf("latencies out of range at %u MHz\n\r", (unsigned int)freq);
+    return -1;
+  }
+
+  return 0;
+}
+
+/* Mode registers: frequency dependent fields over the board settings */
+static void jedec_mode_registers(const jedec_timing *t, uint32_t type,
+                                 HAL_DDR_ModeRegisterUiTypeDef *mr)
+{
+  uint32_t code;
+  uint32_t value;
+  int32_t index;
+
+  if (type == STM32MP_DDR3)
+  {
+    /* MR0: CL A6:A4,A2, DLL reset A8, WR A11:A9 */
+    code = (t->cl <= 11U) ? ((t->cl - 4U) << 4) : (((t->cl - 12U) << 4) | 0x4U);
+    value = t->wr;
+    index = jedec_round_up(jedec_ddr3_wr, JEDEC_NB(jedec_ddr3_wr), &value);
+    mr->mr0[0] = (mr->mr0[0] & ~0x0F74) | (int32_t)code | 0x100 | (index << 9);
+    /* MR2: CWL A5:A3 */
+    mr->mr2[0] = (mr->mr2[0] & ~0x38) | (int32_t)((t->cwl - 5U) << 3);
+  }
+  else if (type == STM32MP_DDR4)
+  {
+    /* MR0: CL A6:A4,A2, DLL reset A8, WR/RTP A11:A9 */
+    value = t->cl;
+    index = jedec_round_up(jedec_ddr4_cl, JEDEC_NB(jedec_ddr4_cl), &value);
+    code = ((index & 0x1) << 2) | ((index & 0xE) << 3);
+    value = t->wr;
+    mr->mr0[0] = (mr->mr0[0] & ~0x3F74) | (int32_t)code | 0x100 |
+                 (jedec_round_up(jedec_ddr4_wr, JEDEC_NB(jedec_ddr4_wr), &value) << 9);
+    /* MR2: CWL A5:A3 */
+    value = t->cwl;
+    index = jedec_round_up(jedec_ddr4_cwl, JEDEC_NB(jedec_ddr4_cwl), &value);
+    mr->mr2[0] = (mr->mr2[0] & ~0x38) | (index << 3);
+    /* MR6: tCCD_L A12:A10 */
+    mr->mr6[0] = (mr->mr6[0] & ~0x1C00) | (int32_t)((t->ccd_l - 4U) << 10);
+  }
+  else
+  {
+    /* MR1: nWR OP[6:4], MR2: RL OP[2:0], WL set A OP[5:3] */
+    mr->mr1[0] = (mr->mr1[0] & ~0x70) | (int32_t)(t->code << 4);
+    mr->mr2[0] = (mr->mr2[0] & ~0x3F) | (int32_t)(t->code | (t->code << 3));
+  }
+}
+
+static void jedec_controller(const jedec_timing *t, uint32_t type,
+                             HAL_DDR_ConfigTypeDef *config)
+{
+  HAL_DDR_RegTypeDef *reg = &config->c_reg;
+  HAL_DDR_TimingTypeDef *tmg = &config->c_timing;
+  HAL_DDR_ModeRegisterUiTypeDef *mr = &config->p_uim;
+  bool lp4 = (type == STM32MP_LPDDR4);
+  uint32_t wr2rd;
+  uint32_t rd2wr;
+  uint32_t wr2pre;
+  uint32_t rd2pre;
+  uint32_t wrlat;
+
+  /* Type, burst length (BL8: 4, BL16: 8 DFI transfers), 1 rank */
+  reg->MSTR = (type == STM32MP_DDR3) ? 0x01040001U :
+              (type == STM32MP_DDR4) ? 0x01040010U : 0x01080020U;
+  if (jedec_get(JEDEC_WIDTH) == 16U)
+  {
+    reg->MSTR |= DDRC_MSTR_DATA_BUS_WIDTH_0;
+  }
+
+  if (lp4)
+  {
+    wr2pre = t->cwl + (t->bl / 2U) + t->wr + 1U;
+    rd2pre = (t->bl / 2U) + t->rtp - 8U;
+    wr2rd = t->cwl + (t->bl / 2U) + t->wtr + 1U;
+    /*
+     * read postamble 1.5 tCK (MR1 OP[7]), write preamble 2 tCK, plus the
+     * PHY turnaround of the reference configurations
+     */
+    rd2wr = t->cl + (t->bl / 2U) + t->dqsck + 2U + 2U + 4U - t->cwl;
+    wrlat = t->cwl - 2U;
+  }
+  else
+  {
+    wr2pre = t->cwl + (t->bl / 2U) + t->wr;
+    rd2pre = t->rtp;
+    wr2rd = t->cwl + (t->bl / 2U) + t->wtr;
+    rd2wr = t->cl + (t->bl / 2U) + 2U - t->cwl;
+    wrlat = t->cwl - 3U;
+  }
+
+  /* Refresh: per bank for LPDDR4 (t_rfc_nom_x1_sel: value in x1 cycles) */
+  if (lp4)
+  {
+    tmg->RFSHTMG = (1UL << 31) | ((t->refi / 2U) << 16) | jedec_dfi(t->rfc);
+    tmg->RFSHTMG1 = jedec_dfi(t->pbr2pbr) << 16;
+  }
+  else
+  {
+    tmg->RFSHTMG = ((t->refi / 2U / 32U) << 16) | jedec_dfi(t->rfc);
+    tmg->RFSHTMG1 = 0x008C0000U;
+  }
+
+  tmg->DRAMTMG0 = (jedec_dfi(wr2pre) << 24) | (jedec_dfi(t->faw) << 16) |
+                  ((((t->ras_max / 1024U) - 1U) / 2U) << 8) | jedec_dfi(t->ras);
+  tmg->DRAMTMG1 = (jedec_dfi(t->xp) << 16) | (jedec_dfi(rd2pre) << 8) |
+                  jedec_dfi(t->rc);
+  tmg->DRAMTMG2 = (jedec_dfi(t->cwl) << 24) | (jedec_dfi(t->cl) << 16) |
+                  (jedec_dfi(rd2wr) << 8) | jedec_dfi(wr2rd);
+  if (lp4)
+  {
+    tmg->DRAMTMG3 = (jedec_dfi(t->mrw) << 20) | (jedec_dfi(t->mrd) << 12) | 0x00CU;
+    /* t_rp: tRPpb, all bank precharges covered by the PHY/firmware margins */
+    tmg->DRAMTMG4 = (jedec_dfi(t->rcd) << 24) | (jedec_dfi(t->ccd) << 16) |
+                    (jedec_dfi(t->rrd) << 8) | jedec_dfi(t->rp);
+    tmg->DRAMTMG6 = 0x02020000U | (jedec_dfi(t->xp) + 2U);
+    tmg->DRAMTMG7 = (jedec_dfi(t->cksre) << 8) | jedec_dfi(t->cksrx);
+    tmg->DRAMTMG8 = 0x03034405U;
+    tmg->DRAMTMG9 = 0x0004040DU;
+    tmg->DRAMTMG13 = (jedec_dfi(t->cwl + (t->bl / 2U) + 2U) << 24) |
+                     (jedec_dfi(32U) << 16) | jedec_dfi(4U);
+    tmg->DRAMTMG14 = jedec_dfi(t->xs);
+    tmg->ODTCFG = 0x04000400U;
+  }
+  else
+  {
+    tmg->DRAMTMG3 = (5UL << 20) | (jedec_dfi(t->mrd) << 12) | jedec_dfi(t->mod);
+    tmg->DRAMTMG4 = (jedec_dfi(t->rcd) << 24) | (jedec_dfi(t->ccd_l) << 16) |
+                    (jedec_dfi(t->rrd) << 8) | (jedec_dfi(t->rp) + 1U);
+    tmg->DRAMTMG6 = 0x02020005U;
+    tmg->DRAMTMG7 = 0x00000202U;
+    tmg->DRAMTMG8 = (3UL << 24) | (3UL << 16) |
+                    (((jedec_dfi(t->dllk) + 31U) / 32U) << 8) |
+                    ((jedec_dfi(t->xs) + 31U) / 32U);
+    tmg->DRAMTMG9 = 0x0004040DU;
+    if (type == STM32MP_DDR4)
+    {
+      tmg->DRAMTMG8 &= ~0x1F1F0000U;
+      tmg->DRAMTMG8 |= (((jedec_dfi(t->rfc4) + 31U) / 32U) << 24) |
+                       (((jedec_dfi(t->rfc4) + 31U) / 32U) << 16);
+      tmg->DRAMTMG9 = (jedec_dfi(t->ccd) << 16) | (jedec_dfi(t->rrd_s) << 8) |
+                      jedec_dfi(t->cwl + (t->bl / 2U) + t->wtr_s);
+    }
+    tmg->DRAMTMG13 = 0x1C200004U;
+    tmg->DRAMTMG14 = 0x000000A0U;
+    /* ODT from CL - CWL, held BL/2 + 2 */
+    tmg->ODTCFG = (6UL << 24) | (6UL << 8) | ((t->cl - t->cwl) << 2);
+  }
+  tmg->DRAMTMG5 = (jedec_dfi(t->cksrx) << 24) | (jedec_dfi(t->cksre) << 16) |
+                  (jedec_dfi(t->ckesr) << 8) | jedec_dfi(t->cke);
+
+  /* Rank to rank write to read, single rank: same as wr2rd */
+  reg->RANKCTL1 = (reg->RANKCTL1 & ~0x3FU) | jedec_dfi(wr2rd);
+
+  reg->ZQCTL0 = (reg->ZQCTL0 & ~0x07FF03FFU) | (jedec_dfi(t->zqoper) << 16) |
+                jedec_dfi(t->zqcs);
+
+  /* PHY latencies, in DFI PHY clock cycles */
+  reg->DFITMG0 = (reg->DFITMG0 & ~0x007F003FU) | ((t->cl - 3U) << 16) | wrlat;
+  reg->DFITMG2 = ((t->cl - 3U) << 8) | wrlat;
+
+  /* Mode registers, as programmed by the controller */
+  if (lp4)
+  {
+    reg->INIT3 = ((uint32_t)mr->mr1[0] << 16) | (uint32_t)mr->mr2[0];
+    reg->INIT4 = ((uint32_t)mr->mr3[0] << 16) | (uint32_t)mr->mr13[0];
+    reg->INIT6 = ((uint32_t)mr->mr11[0] << 16) | (uint32_t)mr->mr12[0];
+    reg->INIT7 = ((uint32_t)mr->mr22[0] << 16) | (uint32_t)mr->mr14[0];
+  }
+  else
+  {
+    reg->INIT3 = ((uint32_t)mr->mr0[0] << 16) | (uint32_t)mr->mr1[0];
+    reg->INIT4 = ((uint32_t)mr->mr2[0] << 16) | (uint32_t)mr->mr3[0];
+    reg->INIT6 = ((uint32_t)mr->mr4[0] << 16) | (uint32_t)mr->mr5[0];
+    reg->INIT7 = (uint32_t)mr->mr6[0];
+  }
+}
+
+/* PLL2 at half the DDR frequency, integer FBDIV preferred */
+static void jedec_pll(HAL_DDR_PllTypeDef *pll, uint32_t freq)
+{
+  uint64_t fref = (pll->source == RCC_PLLSOURCE_HSI) ? HSI_VALUE : HSE_VALUE;
+  uint64_t out = (uint64_t)freq * 500000U;
+  uint64_t vco = 0U;
+  uint32_t postdiv1 = 0U;
+  uint32_t div;
+
+  if (pll->frefdiv <= 0)
+  {
+    pll->frefdiv = 1;
+  }
+  fref /= (uint64_t)pll->frefdiv;
+
+  for (div = 1U; div <= JEDEC_POSTDIV_MAX; div++)
+  {
+    if (((out * div * 2U) < JEDEC_VCO_MIN) || ((out * div * 2U) > JEDEC_VCO_MAX))
+    {
+      continue;
+    }
+    if ((postdiv1 == 0U) || (((out * div * 2U) % fref) == 0U))
+    {
+      postdiv1 = div;
+      vco = out * div * 2U;
+      if ((vco % fref) == 0U)
+      {
+        break;
+      }
+    }
+  }
+
+  if (postdiv1 == 0U)
+  {
+    /* Below the VCO range: largest dividers */
+    postdiv1 = JEDEC_POSTDIV_MAX;
+    vco = out * JEDEC_POSTDIV_MAX * 2U;
+  }
+
+  pll->postdiv1 = (int32_t)postdiv1;
+  pll->postdiv2 = 2;
+  pll->fbdiv = (int32_t)(vco / fref);
+  pll->fracin = (int32_t)(((vco % fref) << 24) / fref);
+}
+
+static void jedec_print(const jedec_timing *t, uint32_t type,
+                        const HAL_DDR_ConfigTypeDef *config)
+{
+  const HAL_DDR_RegTypeDef *reg = &config->c_reg;
+  const HAL_DDR_TimingTypeDef *tmg = &config->c_timing;
+  const HAL_DDR_ModeRegisterUiTypeDef *mr = &config->p_uim;
+  const struct {
+    const char *name;
+    uint32_t value;
+  } regs[] = {
+    {"MSTR", reg->MSTR},           {"RFSHTMG", tmg->RFSHTMG},
+    {"RFSHTMG1", tmg->RFSHTMG1},   {"INIT3", reg->INIT3},
+    {"INIT4", reg->INIT4},         {"INIT6", reg->INIT6},
+    {"INIT7", reg->INIT7},         {"RANKCTL1", reg->RANKCTL1},
+    {"DRAMTMG0", tmg->DRAMTMG0},   {"DRAMTMG1", tmg->DRAMTMG1},
+    {"DRAMTMG2", tmg->DRAMTMG2},   {"DRAMTMG3", tmg->DRAMTMG3},
+    {"DRAMTMG4", tmg->DRAMTMG4},   {"DRAMTMG5", tmg->DRAMTMG5},
+    {"DRAMTMG6", tmg->DRAMTMG6},   {"DRAMTMG7", tmg->DRAMTMG7},
+    {"DRAMTMG8", tmg->DRAMTMG8},   {"DRAMTMG9", tmg->DRAMTMG9},
+    {"DRAMTMG13", tmg->DRAMTMG13}, {"DRAMTMG14", tmg->DRAMTMG14},
+    {"ZQCTL0", reg->ZQCTL0},       {"DFITMG0", reg->DFITMG0},
+    {"DFITMG2", reg->DFITMG2},     {"ODTCFG", tmg->ODTCFG},
+  };
+  const struct {
+    const char *name;
+    int32_t value;
+  } uis[] = {
+    {"UIB_FREQUENCY_0", config->p_uib.frequency[0]},
+    {"UIA_LP4RL_0", config->p_uia.lp4rl[0]},
+    {"UIA_LP4WL_0", config->p_uia.lp4wl[0]},
+    {"UIA_LP4NWR_0", config->p_uia.lp4nwr[0]},
+    {"UIM_MR0_0", mr->mr0[0]},   {"UIM_MR1_0", mr->mr1[0]},
+    {"UIM_MR2_0", mr->mr2[0]},   {"UIM_MR3_0", mr->mr3[0]},
+    {"UIM_MR4_0", mr->mr4[0]},   {"UIM_MR5_0", mr->mr5[0]},
+    {"UIM_MR6_0", mr->mr6[0]},   {"UIM_MR11_0", mr->mr11[0]},
+    {"UIM_MR12_0", mr->mr12[0]}, {"UIM_MR13_0", mr->mr13[0]},
+    {"UIM_MR14_0", mr->mr14[0]}, {"UIM_MR22_0", mr->mr22[0]},
+    {"PLL_FBDIV", config->p_pll.fbdiv},
+    {"PLL_FREFDIV", config->p_pll.frefdiv},
+    {"PLL_FRACIN", config->p_pll.fracin},
+    {"PLL_POSTDIV1", config->p_pll.postdiv1},
+    {"PLL_POSTDIV2", config->p_pll.postdiv2},
+  };
+  uint32_t i;
+
+  printf("\n\r/*\n\r");
+  printf(" * %s\n\r", config->info.name);
+  printf(" * computed from the JEDEC speed bin %u (slowest bin)\n\r",
+         (unsigned int)jedec_get(JEDEC_BIN));
+  if (type == STM32MP_LPDDR4)
+  {
+    printf(" * RL %u WL %u nWR %u BL %u\n\r", (unsigned int)t->cl,
+           (unsigned int)t->cwl, (unsigned int)t->wr, (unsigned int)t->bl);
+  }
+  else
+  {
+    printf(" * CL %u CWL %u WR %u BL %u\n\r", (unsigned int)t->cl,
+           (unsigned int)t->cwl, (unsigned int)t->wr, (unsigned int)t->bl);
+  }
+  printf(" * tRCD %u tRP %u tRAS %u tRC %u tFAW %u tRFC %u tREFI %u (nCK)\n\r",
+         (unsigned int)t->rcd, (unsigned int)t->rp, (unsigned int)t->ras,
+         (unsigned int)t->rc, (unsigned int)t->faw, (unsigned int)t->rfc,
+         (unsigned int)t->refi);
+  printf(" * other settings: see the reference configuration of the type\n\r");
+  printf(" */\n\r");
+  printf("#define DDR_MEM_NAME  \"%s\"\n\r", config->info.name);
+  printf("#define DDR_MEM_SPEED %uU\n\r", (unsigned int)config->info.speed);
+  printf("#define DDR_MEM_SIZE  0x%lxUL\n\r", (unsigned long)config->info.size);
+
+  for (i = 0U; i < JEDEC_NB(regs); i++)
+  {
+    printf("#define DDR_%s 0x%08XU\n\r", regs[i].name, (unsigned int)regs[i].value);
+  }
+
+  for (i = 0U; i < JEDEC_NB(uis); i++)
+  {
+    if (strncmp(uis[i].name, "PLL", 3) == 0)
+    {
+      printf("#define DDR_%s %uU\n\r", uis[i].name, (unsigned int)uis[i].value);
+    }
+    else
+    {
+      printf("#define DDR_%s 0x%08X\n\r", uis[i].name, (unsigned int)uis[i].value);
+    }
+  }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Prints the calculator parameters with their value.
+  * @param  None
+  * @retval None
+  */
+void Jedec_List(void)
+{
+  uint32_t i;
+
+  for (i = 0U; i < JEDEC_NB(jedec_params); i++)
+  {
+    if (i == JEDEC_TYPE)
+    {
+      printf("%-12s %8s  %s\n\r", jedec_params[i].name,
+             jedec_type_name[jedec_params[i].value], jedec_params[i].help);
+    }
+    else
+    {
+      printf("%-12s %8u  %s\n\r", jedec_params[i].name,
+             (unsigned int)jedec_params[i].value, jedec_params[i].help);
+    }
+  }
+}
+
+/**
+  * @brief  Sets one calculator parameter.
+  * @param  param name of the parameter
+  * @param  value new value, type name for the "type" parameter
+  * @retval 0 if success, -1 else
+  */
+int32_t Jedec_Set(const char *param, const char *value)
+{
+  unsigned long num;
+  char *end_ptr;
+  uint32_t i;
+
+  for (i = 0U; i < JEDEC_NB(jedec_params); i++)
+  {
+    if (strcasecmp(param, jedec_params[i].name))
+    {
+      continue;
+    }
+
+    if (i == JEDEC_TYPE)
+    {
+      for (num = 0U; num < JEDEC_NB(jedec_type_name); num++)
+      {
+        if (!strcasecmp(value, jedec_type_name[num]))
+        {
+          jedec_params[i].value = (uint32_t)num;
+          return 0;
+        }
+      }
+      printf("invalid type %s\n\r", value);
+      return -1;
+    }
+
+    num = strtoul(value, &end_ptr, 0);
+    if (end_ptr == value)
+    {
+      printf("invalid value %s\n\r", value);
+      return -1;
+    }
+    if ((num < jedec_params[i].min) || (num > jedec_params[i].max) ||
+        ((i == JEDEC_WIDTH) && (num != 16U) && (num != 32U)))
+    {
+      printf("%s out of range [%u..%u]\n\r", jedec_params[i].name,
+             (unsigned int)jedec_params[i].min,
+             (unsigned int)jedec_params[i].max);
+      return -1;
+    }
+    jedec_params[i].value = (uint32_t)num;
+    return 0;
+  }
+
+  printf("unknown parameter %s\n\r", param);
+  return -1;
+}
+
+/**
+  * @brief  Computes the settings from the parameters, prints them as a
+  *         configuration template and optionally applies them to the
+  *         current configuration.
+  * @param  apply true to replace the current configuration settings, only
+  *         allowed for the DRAM type of the build
+  * @retval 0 if success, -1 else
+  */
+int32_t Jedec_Run(bool apply)
+{
+  HAL_DDR_ConfigTypeDef config = static_ddr_config;
+  uint32_t type = jedec_get(JEDEC_TYPE);
+  uint32_t width = jedec_get(JEDEC_WIDTH);
+  uint32_t density = jedec_get(JEDEC_DENSITY);
+  uint32_t freq = jedec_get(JEDEC_FREQ);
+  jedec_timing t;
+
+  if (apply && (type != JEDEC_BUILD_TYPE))
+  {
+    printf("type %s not supported by this build (%s)\n\r",
+           jedec_type_name[type], jedec_type_name[JEDEC_BUILD_TYPE]);
+    return -1;
+  }
+
+  if (jedec_timings(&t) != 0)
+  {
+    return -1;
+  }
+
+  if (type != JEDEC_BUILD_TYPE)
+  {
+    config.p_uim = jedec_board_mr[type];
+    config.c_reg.RANKCTL1 = 0U;
+    config.c_reg.ZQCTL0 = 0U;
+  }
+  jedec_mode_registers(&t, type, &config.p_uim);
+  jedec_controller(&t, type, &config);
+
+  config.p_uib.frequency[0] = (int32_t)freq;
+  config.p_uia.lp4rl[0] = (type == STM32MP_LPDDR4) ? (int32_t)t.code : 0;
+  config.p_uia.lp4wl[0] = config.p_uia.lp4rl[0];
+  config.p_uia.lp4nwr[0] = config.p_uia.lp4rl[0];
+  jedec_pll(&config.p_pll, freq);
+
+  /* LPDDR4: one device of all the channels, else x16 devices */
+  if (type == STM32MP_LPDDR4)
+  {
+    snprintf(jedec_name, sizeof(jedec_name), "LPDDR4 1x%uGbits 1x%ubits %uMHz",
+             (unsigned int)(density * width / 16U), (unsigned int)width,
+             (unsigned int)freq);
+  }
+  else
+  {
+    snprintf(jedec_name, sizeof(jedec_name), "%s %ux%uGbits %ux16bits %uMHz",
+             (type == STM32MP_DDR3) ? "DDR3" : "DDR4", (unsigned int)(width / 16U),
+             (unsigned int)density, (unsigned int)(width / 16U), (unsigned int)freq);
+  }
+  config.info.name = jedec_name;
+  config.info.speed = freq * 1000U;
+  config.info.size = ((uint64_t)density << 30) / 8U * (width / 16U);
+
+  jedec_print(&t, type, &config);
+
+  if (apply)
+  {
+    static_ddr_config = config;
+    printf("configuration updated\n\r");
+  }
+
+  return 0;
+}
@@ -0,0 +1,292 @@
+/**
+  ******************************************************************************
+  * @file    ddr_tool_record.c
+  * @author  MCD Application Team
+  * @brief   Machine readable records of the DDR tool results.
+  *          When enabled with the "record" command, command results, test
+  *          verdicts, test errors and register dumps are also sent as framed
+  *          CBOR records, decoded on host side by Scripts/record/ddr_record.py
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32_device_hal.h"
+
+#include "string.h"
+#include "ddr_tool_util.h"
+#include "ddr_tool_record.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+  uint8_t *buf;
+  uint32_t len;
+  bool overflow;
+} cbor_writer;
+
+/* Private define ------------------------------------------------------------*/
+#define RECORD_HEADER_SIZE 7U
+#define RECORD_CRC_SIZE    2U
+#define RECORD_CRC_INIT    0xFFFFU
+
+/* CBOR major types */
+#define CBOR_UINT          0U
+#define CBOR_TEXT          3U
+#define CBOR_MAP           5U
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static bool record_enabled;
+static uint16_t record_seq;
+static uint8_t record_frame[RECORD_HEADER_SIZE + RECORD_MAX_PAYLOAD +
+                            RECORD_CRC_SIZE];
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+static void cbor_put(cbor_writer *w, uint8_t data)
+{
+  if (w->len >= RECORD_MAX_PAYLOAD)
+  {
+    w->overflow = true;
+    return;
+  }
+
+  w->buf[w->len++] = data;
+}
+
+static void cbor_head(cbor_writer *w, uint8_t major, uint64_t value)
+{
+  uint8_t nb_bytes;
+  uint8_t info;
+
+  if (value < 24U)
+  {
+    cbor_put(w, (uint8_t)((major << 5) | value));
+    return;
+  }
+
+  if (value <= 0xFFU)
+  {
+    info = 24U;
+    nb_bytes = 1U;
+  }
+  else if (value <= 0xFFFFU)
+  {
+    info = 25U;
+    nb_bytes = 2U;
+  }
+  else if (value <= 0xFFFFFFFFU)
+  {
+    info = 26U;
+    nb_bytes = 4U;
+  }
+  else
+  {
+    info = 27U;
+    nb_bytes = 8U;
+  }
+
+  cbor_put(w, (uint8_t)((major << 5) | info));
+
+  /* CBOR arguments are big endian */
+  while (nb_bytes > 0U)
+  {
+    nb_bytes--;
+    cbor_put(w, (uint8_t)(value >> (8U * nb_bytes)));
+  }
+}
+
+static void cbor_text(cbor_writer *w, const char *str)
+{
+  size_t len = strlen(str);
+  size_t i;
+
+  cbor_head(w, CBOR_TEXT, len);
+
+  for (i = 0; i < len; i++)
+  {
+    cbor_put(w, (uint8_t)str[i]);
+  }
+}
+
+static void cbor_key_uint(cbor_writer *w, const char *key, uint64_t value)
+{
+  cbor_text(w, key);
+  cbor_head(w, CBOR_UINT, value);
+}
+
+static void cbor_key_text(cbor_writer *w, const char *key, const char *str)
+{
+  cbor_text(w, key);
+  cbor_text(w, str);
+}
+
+static void record_begin(cbor_writer *w, uint8_t nb_pairs)
+{
+  w->buf = &record_frame[RECORD_HEADER_SIZE];
+  w->len = 0;
+  w->overflow = false;
+
+  cbor_head(w, CBOR_MAP, nb_pairs);
+}
+
+static void record_send(record_type type, const cbor_writer *w)
+{
+  uint16_t crc;
+  uint32_t len;
+
+  if (w->overflow)
+  {
+    /* Truncated record is useless for the host, drop it */
+    return;
+  }
+
+  record_frame[0] = RECORD_SOF0;
+  record_frame[1] = RECORD_SOF1;
+  record_frame[2] = (uint8_t)type;
+  record_frame[3] = (uint8_t)record_seq;
+  record_frame[4] = (uint8_t)(record_seq >> 8);
+  record_frame[5] = (uint8_t)w->len;
+  record_frame[6] = (uint8_t)(w->len >> 8);
+
+  len = RECORD_HEADER_SIZE + w->len;
+  crc = util_crc16(&record_frame[2], len - 2U, RECORD_CRC_INIT);
+  record_frame[len++] = (uint8_t)crc;
+  record_frame[len++] = (uint8_t)(crc >> 8);
+
+  /* Flush pending text, so that the frame is not split by a printf */
+  fflush(stdout);
+  Serial_Printf((char *)record_frame, (int)len);
+
+  record_seq++;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Enables or disables the records.
+  * @param  enable true to send records along with the console text
+  * @retval None
+  */
+void Record_Enable(bool enable)
+{
+  record_enabled = enable;
+}
+
+/**
+  * @brief  Gets the record state.
+  * @param  None
+  * @retval true if records are sent
+  */
+bool Record_IsEnabled(void)
+{
+  return record_enabled;
+}
+
+/**
+  * @brief  Sends the record of an executed console command.
+  * @param  cmd command name
+  * @param  step DDR interactive step in which the command was executed
+  * @param  has_result true if the command reported a result
+  * @param  result 0 if passed, error code else
+  * @retval None
+  */
+void Record_Command(const char *cmd, uint32_t step, bool has_result,
+                    uint32_t result)
+{
+  cbor_writer w;
+
+  if (!record_enabled)
+  {
+    return;
+  }
+
+  record_begin(&w, has_result ? 3U : 2U);
+  cbor_key_text(&w, "cmd", cmd);
+  cbor_key_uint(&w, "step", step);
+  if (has_result)
+  {
+    cbor_key_uint(&w, "res", result);
+  }
+  record_send(RECORD_CMD, &w);
+}
+
+/**
+  * @brief  Sends the verdict of a test.
+  * @param  id test number
+  * @param  name test name
+  * @param  result 0 if passed, test error code else
+  * @retval None
+  */
+void Record_TestResult(uint32_t id, const char *name, uint32_t result)
+{
+  cbor_writer w;
+
+  if (!record_enabled)
+  {
+    return;
+  }
+
+  record_begin(&w, 3U);
+  cbor_key_uint(&w, "id", id);
+  cbor_key_text(&w, "name", name);
+  cbor_key_uint(&w, "res", result);
+  record_send(RECORD_TEST, &w);
+}
+
+/**
+  * @brief  Sends a test error with the expected and read data.
+  * @param  test test name
+  * @param  addr failing address
+  * @param  expected expected data
+  * @param  actual read data
+  * @retval None
+  */
+void Record_TestMismatch(const char *test, uint64_t addr, uint64_t expected,
+                         uint64_t actual)
+{
+  cbor_writer w;
+
+  if (!record_enabled)
+  {
+    return;
+  }
+
+  record_begin(&w, 4U);
+  cbor_key_text(&w, "test", test);
+  cbor_key_uint(&w, "addr", addr);
+  cbor_key_uint(&w, "exp", expected);
+  cbor_key_uint(&w, "act", actual);
+  record_send(RECORD_ERROR, &w);
+}
+
+/**
+  * @brief  Sends a register value.
+  * @param  name register name
+  * @param  value register value
+  * @retval None
+  */
+void Record_Register(const char *name, uint32_t value)
+{
+  cbor_writer w;
+
+  if (!record_enabled)
+  {
+    return;
+  }
+
+  record_begin(&w, 2U);
+  cbor_key_text(&w, "reg", name);
+  cbor_key_uint(&w, "val", value);
+  record_send(RECORD_REG, &w);
+}
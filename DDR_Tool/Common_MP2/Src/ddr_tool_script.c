@@ -0,0 +1,819 @@
+/**
+  ******************************************************************************
+  * @file    ddr_tool_script.c
+  * @author  MCD Application Team
+  * @brief   Execution of console command scripts (batch mode).
+  *          The script is received in one transfer (or compiled in with
+  *          UTIL_DDR_SCRIPT_DEFAULT), kept in memory and its lines are given to
+  *          the console one by one, after the handling of the variables, the
+  *          loops and the failure policy, see ddr_tool_script.h.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32_device_hal.h"
+
+#include "string.h"
+#include "stdlib.h"
+#include "ddr_tool_util.h"
+#include "ddr_tool_script.h"
+#include "stm32mp_util_conf.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  char name[12];
+  char value[24];
+} script_var;
+
+typedef struct
+{
+  uint32_t line;                 /* line of the "for" */
+  script_var *var;               /* loop variable */
+  char items[SCRIPT_LINE_LEN];   /* item list, variables expanded */
+  const char *next;              /* next item of the list */
+  uint32_t value;                /* current value of a range */
+  uint32_t last;                 /* last value of a range */
+} script_loop;
+
+/* Private define ------------------------------------------------------------*/
+#ifndef UTIL_DDR_SCRIPT_SIZE
+#define UTIL_DDR_SCRIPT_SIZE       4096U
+#endif
+
+#define SCRIPT_MAX_VARS            8U
+#define SCRIPT_MAX_FAILS           16U
+#define SCRIPT_FAIL_LEN            96U
+
+#define SCRIPT_EOT                 0x04U /* Ctrl-D */
+#define SCRIPT_SUB                 0x1AU /* Ctrl-Z */
+#define SCRIPT_START_TIMEOUT_US    30000000U
+#define SCRIPT_IDLE_TIMEOUT_US     2000000U
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+#ifdef UTIL_DDR_SCRIPT_DEFAULT
+static char script_buf[UTIL_DDR_SCRIPT_SIZE] = UTIL_DDR_SCRIPT_DEFAULT;
+#else
+static char script_buf[UTIL_DDR_SCRIPT_SIZE];
+#endif
+
+static uint32_t script_line_off[SCRIPT_MAX_LINES];
+static uint32_t script_nb_lines;
+
+/* Result of the last command, with or without script in progress */
+static bool script_has_result;
+static uint32_t script_result;
+
+static struct
+{
+  bool running;
+  bool stop_on_fail;
+  uint32_t pc;                   /* next line to execute */
+  uint32_t line;                 /* line of the command in progress */
+  uint32_t depth;
+  script_loop loop[SCRIPT_MAX_DEPTH];
+  uint32_t nb_vars;
+  script_var var[SCRIPT_MAX_VARS];
+  char cmd[SCRIPT_LINE_LEN];     /* command in progress */
+  uint32_t nb_cmds;
+  uint32_t nb_cmd_fails;         /* commands other than "test" */
+  uint32_t nb_tests;
+  uint32_t nb_fails;             /* "test" commands */
+  char fail[SCRIPT_MAX_FAILS][SCRIPT_FAIL_LEN];
+  uint32_t start_tick;
+} script;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/* Copies line n without its comment, returns the copy */
+static char *script_read_line(uint32_t n, char *line, uint32_t size)
+{
+  const char *src = &script_buf[script_line_off[n]];
+  uint32_t i = 0;
+
+  while ((src[i] != '\0') && (src[i] != '\n') && (src[i] != '#') &&
+         (i < (size - 1U)))
+  {
+    line[i] = src[i];
+    i++;
+  }
+  line[i] = '\0';
+
+  return line;
+}
+
+/* Extracts the next word of p in word, returns the position after it */
+static const char *script_word(const char *p, char *word, uint32_t size)
+{
+  uint32_t i = 0;
+
+  while ((*p == ' ') || (*p == '\t') || (*p == '\r'))
+  {
+    p++;
+  }
+
+  while ((*p != '\0') && (*p != ' ') && (*p != '\t') && (*p != '\r'))
+  {
+    if (i < (size - 1U))
+    {
+      word[i++] = *p;
+    }
+    p++;
+  }
+  word[i] = '\0';
+
+  return p;
+}
+
+static bool script_is_name_char(char c)
+{
+  return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+         ((c >= '0') && (c <= '9')) || (c == '_');
+}
+
+static script_var *script_find_var(const char *name, bool create)
+{
+  uint32_t i;
+
+  for (i = 0; i < script.nb_vars; i++)
+  {
+    if (!strcmp(script.var[i].name, name))
+    {
+      return &script.var[i];
+    }
+  }
+
+  if (!create)
+  {
+    return NULL;
+  }
+
+  if ((script.nb_vars == SCRIPT_MAX_VARS) ||
+      (strlen(name) >= sizeof(script.var[0].name)))
+  {
+    printf("line %lu: too many variables or name too long (%s)\n\r",
+           (unsigned long)(script.line + 1U), name);
+    return NULL;
+  }
+
+  strcpy(script.var[script.nb_vars].name, name);
+  script.var[script.nb_vars].value[0] = '\0';
+
+  return &script.var[script.nb_vars++];
+}
+
+/* Copies src in dst, replacing $var and ${var} by their value */
+static int32_t script_expand(const char *src, char *dst, uint32_t size)
+{
+  char name[sizeof(script.var[0].name)];
+  script_var *var;
+  uint32_t len = 0;
+  uint32_t i;
+  bool brace;
+
+  while (*src != '\0')
+  {
+    if (*src != '$')
+    {
+      if (len >= (size - 1U))
+      {
+        break;
+      }
+      dst[len++] = *src++;
+      continue;
+    }
+
+    src++;
+    brace = (*src == '{');
+    if (brace)
+    {
+      src++;
+    }
+
+    for (i = 0; script_is_name_char(*src); src++)
+    {
+      if (i < (sizeof(name) - 1U))
+      {
+        name[i++] = *src;
+      }
+    }
+    name[i] = '\0';
+
+    if (brace && (*src++ != '}'))
+    {
+      printf("line %lu: missing }\n\r", (unsigned long)(script.line + 1U));
+      return -1;
+    }
+
+    var = script_find_var(name, false);
+    if (var == NULL)
+    {
+      printf("line %lu: undefined variable %s\n\r",
+             (unsigned long)(script.line + 1U), name);
+      return -1;
+    }
+
+    for (i = 0; (var->value[i] != '\0') && (len < (size - 1U)); i++)
+    {
+      dst[len++] = var->value[i];
+    }
+  }
+
+  if (*src != '\0')
+  {
+    printf("line %lu: line too long\n\r", (unsigned long)(script.line + 1U));
+    return -1;
+  }
+
+  dst[len] = '\0';
+
+  return 0;
+}
+
+/*
+ * Loads the next item of the loop in its variable.
+ * Returns 1 if loaded, 0 at the end of the list, -1 on error.
+ */
+static int32_t script_loop_next(script_loop *loop)
+{
+  char word[sizeof(loop->var->value)];
+  char *range;
+  char *end;
+
+  if (loop->value != loop->last)
+  {
+    loop->value += (loop->value < loop->last) ? 1U : (uint32_t)-1;
+    snprintf(loop->var->value, sizeof(loop->var->value), "%lu",
+             (unsigned long)loop->value);
+    return 1;
+  }
+
+  loop->next = script_word(loop->next, word, sizeof(word));
+  if (word[0] == '\0')
+  {
+    return 0;
+  }
+
+  range = strstr(word, "..");
+  if (range == NULL)
+  {
+    strcpy(loop->var->value, word);
+    return 1;
+  }
+
+  *range = '\0';
+  loop->value = strtoul(word, &end, 0);
+  if ((end == word) || (*end != '\0'))
+  {
+    printf("line %lu: invalid range %s\n\r", (unsigned long)(loop->line + 1U),
+           word);
+    return -1;
+  }
+
+  loop->last = strtoul(range + 2, &end, 0);
+  if ((end == (range + 2)) || (*end != '\0'))
+  {
+    printf("line %lu: invalid range %s\n\r", (unsigned long)(loop->line + 1U),
+           range + 2);
+    return -1;
+  }
+
+  snprintf(loop->var->value, sizeof(loop->var->value), "%lu",
+           (unsigned long)loop->value);
+
+  return 1;
+}
+
+/* Splits the script in lines and checks the loops */
+static int32_t script_prepare(void)
+{
+  char line[SCRIPT_LINE_LEN];
+  char word[sizeof(script.var[0].name)];
+  const char *p;
+  uint32_t depth = 0;
+  uint32_t off = 0;
+  uint32_t n;
+
+  script_nb_lines = 0;
+
+  while (script_buf[off] != '\0')
+  {
+    if (script_nb_lines == SCRIPT_MAX_LINES)
+    {
+      printf("script longer than %u lines\n\r", SCRIPT_MAX_LINES);
+      script_nb_lines = 0;
+      return -1;
+    }
+
+    script_line_off[script_nb_lines++] = off;
+
+    while ((script_buf[off] != '\0') && (script_buf[off] != '\n'))
+    {
+      off++;
+    }
+
+    if (script_buf[off] == '\n')
+    {
+      off++;
+    }
+  }
+
+  for (n = 0; n < script_nb_lines; n++)
+  {
+    p = script_word(script_read_line(n, line, sizeof(line)), word,
+                    sizeof(word));
+
+    if (!strcmp(word, "for"))
+    {
+      p = script_word(p, word, sizeof(word));
+      p = script_word(p, line, sizeof(line));
+      if (line[0] == '\0')
+      {
+        printf("line %lu: for <var> <item> [...] expected\n\r",
+               (unsigned long)(n + 1U));
+        break;
+      }
+
+      if (++depth > SCRIPT_MAX_DEPTH)
+      {
+        printf("line %lu: more than %u nested loops\n\r",
+               (unsigned long)(n + 1U), SCRIPT_MAX_DEPTH);
+        break;
+      }
+    }
+    else if (!strcmp(word, "end"))
+    {
+      if (depth == 0U)
+      {
+        printf("line %lu: end without for\n\r", (unsigned long)(n + 1U));
+        break;
+      }
+      depth--;
+    }
+  }
+
+  if ((n == script_nb_lines) && (depth != 0U))
+  {
+    printf("for without end\n\r");
+  }
+
+  if ((n != script_nb_lines) || (depth != 0U))
+  {
+    script_nb_lines = 0;
+    return -1;
+  }
+
+  return 0;
+}
+
+static void script_end(const char *reason)
+{
+  uint32_t time = HAL_GetTick() - script.start_tick;
+  uint32_t nb_fails = script.nb_cmd_fails + script.nb_fails;
+  uint32_t i;
+
+  script.running = false;
+
+  printf("\n\r========== script summary ==========\n\r");
+  printf("commands: %lu, failed: %lu\n\r", (unsigned long)script.nb_cmds,
+         (unsigned long)script.nb_cmd_fails);
+  printf("tests: %lu, passed: %lu, failed: %lu\n\r",
+         (unsigned long)script.nb_tests,
+         (unsigned long)(script.nb_tests - script.nb_fails),
+         (unsigned long)script.nb_fails);
+  printf("time: %lu.%03lu s\n\r", (unsigned long)(time / 1000U),
+         (unsigned long)(time % 1000U));
+
+  for (i = 0; (i < nb_fails) && (i < SCRIPT_MAX_FAILS); i++)
+  {
+    printf("  %s\n\r", script.fail[i]);
+  }
+
+  if (nb_fails > SCRIPT_MAX_FAILS)
+  {
+    printf("  ... %lu more failures\n\r",
+           (unsigned long)(nb_fails - SCRIPT_MAX_FAILS));
+  }
+
+  printf("result: %s%s%s\n\r",
+         ((reason != NULL) || (nb_fails != 0U)) ? "FAIL" : "PASS",
+         (reason != NULL) ? ", " : "", (reason != NULL) ? reason : "");
+}
+
+/* Handles the script statements, returns 1 if line is a console command */
+static int32_t script_statement(const char *line)
+{
+  char word[sizeof(script.var[0].name)];
+  char value[sizeof(script.var[0].value)];
+  script_var *var;
+  script_loop *loop;
+  const char *p;
+  int32_t ret;
+
+  p = script_word(line, word, sizeof(word));
+
+  if (word[0] == '\0')
+  {
+    return 0;
+  }
+
+  if (!strcmp(word, "set"))
+  {
+    p = script_word(p, word, sizeof(word));
+    script_word(p, value, sizeof(value));
+    var = script_find_var(word, true);
+    if (var == NULL)
+    {
+      return -1;
+    }
+    strcpy(var->value, value);
+    return 0;
+  }
+
+  if (!strcmp(word, "onfail"))
+  {
+    script_word(p, word, sizeof(word));
+    if (!strcmp(word, "stop"))
+    {
+      script.stop_on_fail = true;
+    }
+    else if (!strcmp(word, "continue"))
+    {
+      script.stop_on_fail = false;
+    }
+    else
+    {
+      printf("line %lu: onfail stop|continue expected\n\r",
+             (unsigned long)(script.line + 1U));
+      return -1;
+    }
+    return 0;
+  }
+
+  if (!strcmp(word, "for"))
+  {
+    loop = &script.loop[script.depth];
+    p = script_word(p, word, sizeof(word));
+    loop->var = script_find_var(word, true);
+    if (loop->var == NULL)
+    {
+      return -1;
+    }
+    strncpy(loop->items, p, sizeof(loop->items) - 1U);
+    loop->items[sizeof(loop->items) - 1U] = '\0';
+    loop->next = loop->items;
+    loop->line = script.line;
+    loop->value = 0;
+    loop->last = 0;
+
+    ret = script_loop_next(loop);
+    if (ret <= 0)
+    {
+      if (ret == 0)
+      {
+        printf("line %lu: empty list\n\r", (unsigned long)(script.line + 1U));
+      }
+      return -1;
+    }
+
+    script.depth++;
+    return 0;
+  }
+
+  if (!strcmp(word, "end"))
+  {
+    loop = &script.loop[script.depth - 1U];
+
+    ret = script_loop_next(loop);
+    if (ret < 0)
+    {
+      return -1;
+    }
+
+    if (ret > 0)
+    {
+      script.pc = loop->line + 1U;
+    }
+    else
+    {
+      script.depth--;
+    }
+    return 0;
+  }
+
+  return 1;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Receives a script as text over the console, ended by Ctrl-D,
+  *         Ctrl-Z or 2 seconds without data.
+  * @param  None
+  * @retval 0 if loaded, -1 else
+  */
+int32_t Script_Load(void)
+{
+  uint32_t timeout = SCRIPT_START_TIMEOUT_US;
+  uint32_t len = 0;
+  bool overflow = false;
+  uint8_t prev = 0;
+  uint8_t data;
+
+  printf("Send the script text, end with Ctrl-D...\n\r");
+  fflush(stdout);
+  Serial_Flush();
+
+  script_nb_lines = 0;
+
+  while (Serial_GetByte(&data, timeout) == 0)
+  {
+    timeout = SCRIPT_IDLE_TIMEOUT_US;
+
+    if ((data == SCRIPT_EOT) || (data == SCRIPT_SUB))
+    {
+      break;
+    }
+
+    /* CR LF, CR or LF line endings */
+    if ((data == '\n') && (prev == '\r'))
+    {
+      prev = data;
+      continue;
+    }
+    prev = data;
+
+    if (len >= (sizeof(script_buf) - 1U))
+    {
+      overflow = true;
+      continue;
+    }
+
+    script_buf[len++] = (data == '\r') ? '\n' : (char)data;
+  }
+
+  script_buf[len] = '\0';
+
+  if (overflow)
+  {
+    printf("script larger than %u bytes\n\r", (unsigned int)sizeof(script_buf));
+    script_buf[0] = '\0';
+    return -1;
+  }
+
+  if (len == 0U)
+  {
+    printf("no script received\n\r");
+    return -1;
+  }
+
+  if (script_prepare() != 0)
+  {
+    script_buf[0] = '\0';
+    return -1;
+  }
+
+  printf("script of %lu lines loaded\n\r", (unsigned long)script_nb_lines);
+
+  return 0;
+}
+
+/**
+  * @brief  Prints the loaded script with the line numbers.
+  * @param  None
+  * @retval None
+  */
+void Script_List(void)
+{
+  char line[SCRIPT_LINE_LEN];
+  uint32_t n;
+
+  if ((script_buf[0] == '\0') || (script_prepare() != 0))
+  {
+    printf("no script loaded\n\r");
+    return;
+  }
+
+  for (n = 0; n < script_nb_lines; n++)
+  {
+    /* Print the whole line, comment included */
+    strncpy(line, &script_buf[script_line_off[n]], sizeof(line) - 1U);
+    line[sizeof(line) - 1U] = '\0';
+    line[strcspn(line, "\n")] = '\0';
+    printf("%3lu: %s\n\r", (unsigned long)(n + 1U), line);
+  }
+}
+
+/**
+  * @brief  Starts the execution of the loaded script, the lines are then
+  *         given by Script_GetLine().
+  * @param  None
+  * @retval 0 if started, -1 else
+  */
+int32_t Script_Run(void)
+{
+  if ((script_buf[0] == '\0') || (script_prepare() != 0))
+  {
+    printf("no script to run\n\r");
+    return -1;
+  }
+
+  memset(&script, 0, sizeof(script));
+  script.stop_on_fail = true;
+  script.start_tick = HAL_GetTick();
+  script.running = true;
+
+  printf("run script of %lu lines, press any key to abort\n\r",
+         (unsigned long)script_nb_lines);
+
+  return 0;
+}
+
+/**
+  * @brief  Tells if a script is in progress.
+  * @param  None
+  * @retval true if running
+  */
+bool Script_IsRunning(void)
+{
+  return script.running;
+}
+
+/**
+  * @brief  Gives the next console command of the script in progress.
+  *         The summary is printed when the script ends.
+  * @param  entry buffer of the command
+  * @param  size size of entry
+  * @retval 0 if a command is given, -1 if no script is in progress
+  */
+int32_t Script_GetLine(char *entry, uint32_t size)
+{
+  char line[SCRIPT_LINE_LEN];
+  uint8_t data;
+  int32_t ret;
+
+  while (script.running)
+  {
+    if (Serial_GetByte(&data, 0U) == 0)
+    {
+      script_end("aborted");
+      break;
+    }
+
+    if (script.pc >= script_nb_lines)
+    {
+      script_end(NULL);
+      break;
+    }
+
+    script.line = script.pc++;
+
+    if (script_expand(script_read_line(script.line, line, sizeof(line)),
+                      entry, size) != 0)
+    {
+      script_end("script error");
+      break;
+    }
+
+    ret = script_statement(entry);
+    if (ret < 0)
+    {
+      script_end("script error");
+      break;
+    }
+
+    if (ret > 0)
+    {
+      strncpy(script.cmd, entry, sizeof(script.cmd) - 1U);
+      script.cmd[sizeof(script.cmd) - 1U] = '\0';
+      script.nb_cmds++;
+      return 0;
+    }
+  }
+
+  return -1;
+}
+
+/* Keeps the failed command, with the loop values, for the summary */
+static void script_fail(uint32_t result)
+{
+  uint32_t n = script.nb_cmd_fails + script.nb_fails;
+  char *fail;
+  uint32_t len;
+  uint32_t i;
+
+  if (n >= SCRIPT_MAX_FAILS)
+  {
+    return;
+  }
+
+  fail = script.fail[n];
+  len = snprintf(fail, SCRIPT_FAIL_LEN, "line %lu: %s [%lu]",
+                 (unsigned long)(script.line + 1U), script.cmd,
+                 (unsigned long)result);
+
+  for (i = 0; (i < script.depth) && (len < SCRIPT_FAIL_LEN); i++)
+  {
+    len += snprintf(&fail[len], SCRIPT_FAIL_LEN - len, " %s=%s",
+                    script.loop[i].var->name, script.loop[i].var->value);
+  }
+}
+
+/**
+  * @brief  Reports the result of the test command in progress, counted in
+  *         the tests of the script summary.
+  * @param  result test result, 0 if passed
+  * @retval None
+  */
+void Script_Result(uint32_t result)
+{
+  script_has_result = true;
+  script_result = result;
+
+  if (!script.running)
+  {
+    return;
+  }
+
+  script.nb_tests++;
+
+  if (result == 0U)
+  {
+    return;
+  }
+
+  script_fail(result);
+  script.nb_fails++;
+
+  if (script.stop_on_fail)
+  {
+    script_end("stopped on failure");
+  }
+}
+
+/**
+  * @brief  Reports the result of the command in progress, other than a test
+  *         (tune, qos, bench...): a failure is counted in the commands of the
+  *         script summary, not in its tests.
+  * @param  result command result, 0 if success
+  * @retval None
+  */
+void Script_CommandResult(uint32_t result)
+{
+  script_has_result = true;
+  script_result = result;
+
+  if (!script.running || (result == 0U))
+  {
+    return;
+  }
+
+  script_fail(result);
+  script.nb_cmd_fails++;
+
+  if (script.stop_on_fail)
+  {
+    script_end("stopped on failure");
+  }
+}
+
+/**
+  * @brief  Gets and clears the result reported by the last command.
+  * @param  result test result, 0 if passed
+  * @retval true if the command reported a result
+  */
+bool Script_GetResult(uint32_t *result)
+{
+  bool has_result = script_has_result;
+
+  *result = script_result;
+  script_has_result = false;
+
+  return has_result;
+}
+
+/**
+  * @brief  Ends the script in progress, on a command error or when the
+  *         interactive mode is left.
+  * @param  reason text of the summary, NULL if not an error
+  * @retval None
+  */
+void Script_Abort(const char *reason)
+{
+  if (script.running)
+  {
+    script_end(reason);
+  }
+}
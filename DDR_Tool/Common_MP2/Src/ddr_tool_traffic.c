@@ -0,0 +1,607 @@
+/**
+  ******************************************************************************
+  * @file    ddr_tool_traffic.c
+  * @author  MCD Application Team
+  * @brief   Concurrent DDR traffic generator, see ddr_tool_traffic.h: CPU
+  *          loads/stores and HPDMA linked-list transfers running together,
+  *          with the achieved bandwidth of each master.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32_device_hal.h"
+
+#include "string.h"
+#include "strings.h"
+#include "ddr_tool_util.h"
+#include "ddr_tool_traffic.h"
+#include "stm32mp2xx_hal_ddr_timer.h"
+#include "stm32mp_util_ddr_conf.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+  const char *name;
+  uint32_t value;
+  uint32_t min;
+  uint32_t max;
+  const char *help;
+} traffic_param;
+
+/* Index in traffic_params[] */
+enum traffic_param_id {
+  TRAFFIC_CPU_RD,
+  TRAFFIC_CPU_STRIDE,
+  TRAFFIC_CPU_RATE,
+  TRAFFIC_DMA_RD,
+  TRAFFIC_DMA_BURST,
+  TRAFFIC_DMA_STRIDE,
+  TRAFFIC_DMA_RATE,
+  TRAFFIC_TIME,
+};
+
+/* Private define ------------------------------------------------------------*/
+#define TRAFFIC_CPU_BASE      DDR_MEM_BASE
+#define TRAFFIC_DMA_BASE      (DDR_MEM_BASE + TRAFFIC_REGION_SIZE)
+
+/* CPU accesses between two checks of the rates, DMA and console */
+#define TRAFFIC_CPU_CHUNK     256U
+
+/* Bytes of DDR read or written by each node */
+#define TRAFFIC_DMA_BLOCK     0x8000U
+#define TRAFFIC_DMA_MAX_BURST 64U /* beats */
+#define TRAFFIC_DMA_MAX_GAP   8191U /* bytes between two bursts */
+#define TRAFFIC_DMA_TIMEOUT   1000U /* ms */
+
+/*
+ * The nodes of a queue are addressed within the same 64KB page: aligned on a
+ * power of two holding the whole array, they cannot cross a page boundary
+ */
+#define TRAFFIC_DMA_NODES_ALIGN 512U
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static traffic_param traffic_params[] = {
+  /* TRAFFIC_CPU_RD */
+  {"cpu_rd",     70U, 0U, 100U, "CPU reads (%)"},
+  /* TRAFFIC_CPU_STRIDE */
+  {"cpu_stride", 64U, 8U, TRAFFIC_REGION_SIZE, "bytes between two CPU accesses"},
+  /* TRAFFIC_CPU_RATE */
+  {"cpu_rate",   0U, 0U, 100000U, "CPU target rate (MB/s, 0: maximum)"},
+  /* TRAFFIC_DMA_RD */
+  {"dma_rd",     50U, 0U, 100U, "DMA blocks read from the DDR (%)"},
+  /* TRAFFIC_DMA_BURST */
+  {"dma_burst",  16U, 1U, TRAFFIC_DMA_MAX_BURST, "64-bit beats per DMA burst"},
+  /* TRAFFIC_DMA_STRIDE */
+  {"dma_stride", 0U, 0U, (TRAFFIC_DMA_MAX_BURST * 8U) + TRAFFIC_DMA_MAX_GAP,
+   "bytes between two DMA bursts (0: contiguous)"},
+  /* TRAFFIC_DMA_RATE */
+  {"dma_rate",   0U, 0U, 100000U, "DMA target rate (MB/s, 0: maximum)"},
+  /* TRAFFIC_TIME */
+  {"time",       5U, 1U, 3600U, "duration (s)"},
+};
+
+#if !defined(DDR_HOST_SIM)
+static DMA_HandleTypeDef traffic_hdma;
+static DMA_QListTypeDef traffic_queue;
+static DMA_NodeTypeDef traffic_nodes[TRAFFIC_DMA_NODES]
+  __attribute__((aligned(TRAFFIC_DMA_NODES_ALIGN)));
+_Static_assert((sizeof(traffic_nodes) <= TRAFFIC_DMA_NODES_ALIGN) &&
+               ((TRAFFIC_DMA_NODES_ALIGN & (TRAFFIC_DMA_NODES_ALIGN - 1U)) == 0U) &&
+               (TRAFFIC_DMA_NODES_ALIGN <= 0x10000U),
+               "traffic_nodes may cross a 64KB page");
+/* SYSRAM side of the DMA transfers: one burst, rewritten by each burst */
+static uint64_t traffic_buffer[TRAFFIC_DMA_MAX_BURST];
+#endif /* DDR_HOST_SIM */
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+static bool key_pressed(void)
+{
+  uint8_t key;
+
+  return Serial_GetByte(&key, 0U) == 0;
+}
+
+static uint32_t traffic_get(enum traffic_param_id id)
+{
+  return traffic_params[id].value;
+}
+
+/* Achieved rate in KB/s */
+static uint32_t traffic_rate(uint64_t bytes, uint32_t elapsed_us)
+{
+  if (elapsed_us == 0U)
+  {
+    elapsed_us = 1U;
+  }
+
+  return (uint32_t)(bytes * 1000U / elapsed_us);
+}
+
+/* True while the master is below its target rate (MB/s = bytes/us) */
+static bool traffic_below_rate(uint64_t bytes, uint32_t rate, uint32_t elapsed_us)
+{
+  return (rate == 0U) || (bytes < ((uint64_t)rate * elapsed_us));
+}
+
+#if defined(DDR_HOST_SIM)
+/* Host build: no DMA, the CPU traffic runs alone */
+static int32_t traffic_dma_init(void)
+{
+  return 1;
+}
+
+static int32_t traffic_dma_start(void)
+{
+  return -1;
+}
+
+static int32_t traffic_dma_poll(__attribute__((unused)) uint32_t timeout_ms)
+{
+  return -1;
+}
+
+static void traffic_dma_deinit(void)
+{
+}
+#else /* DDR_HOST_SIM */
+/*
+ * Builds the linked list: <dma_rd>% of the nodes read a DDR block to the
+ * SYSRAM buffer, the others write it back. On the DDR side, each burst
+ * starts <dma_stride> bytes after the previous one; on the SYSRAM side, the
+ * same burst buffer is used again.
+ */
+static int32_t traffic_dma_build(void)
+{
+  DMA_NodeConfTypeDef node;
+  uint32_t burst_bytes = traffic_get(TRAFFIC_DMA_BURST) * sizeof(uint64_t);
+  uint32_t stride = traffic_get(TRAFFIC_DMA_STRIDE);
+  uint32_t ddr_addr = TRAFFIC_DMA_BASE;
+  uint32_t mix = 0U;
+  uint32_t i;
+  int32_t gap;
+
+  if (stride == 0U)
+  {
+    stride = burst_bytes;
+  }
+  if ((stride < burst_bytes) || ((stride - burst_bytes) > TRAFFIC_DMA_MAX_GAP) ||
+      ((stride % sizeof(uint64_t)) != 0U) ||
+      ((TRAFFIC_DMA_BLOCK / burst_bytes) * stride * TRAFFIC_DMA_NODES > TRAFFIC_REGION_SIZE))
+  {
+    printf("invalid DMA stride %u for bursts of %u bytes\n\r",
+           (unsigned int)stride, (unsigned int)burst_bytes);
+    return -1;
+  }
+  gap = (int32_t)(stride - burst_bytes);
+
+  memset(&node, 0, sizeof(node));
+  node.NodeType = DMA_HPDMA_2D_NODE;
+  node.Init.Request = DMA_REQUEST_SW;
+  node.Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+  node.Init.Direction = DMA_MEMORY_TO_MEMORY;
+  node.Init.SrcInc = DMA_SINC_INCREMENTED;
+  node.Init.DestInc = DMA_DINC_INCREMENTED;
+  node.Init.SrcDataWidth = DMA_SRC_DATAWIDTH_DOUBLEWORD;
+  node.Init.DestDataWidth = DMA_DEST_DATAWIDTH_DOUBLEWORD;
+  node.Init.Priority = DMA_LOW_PRIORITY_HIGH_WEIGHT;
+  node.Init.SrcBurstLength = traffic_get(TRAFFIC_DMA_BURST);
+  node.Init.DestBurstLength = traffic_get(TRAFFIC_DMA_BURST);
+  node.Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT0;
+  node.Init.TransferEventMode = DMA_TCEM_LAST_LL_ITEM_TRANSFER;
+  node.Init.Mode = DMA_NORMAL;
+  node.DataHandlingConfig.DataExchange = DMA_EXCHANGE_NONE;
+  node.DataHandlingConfig.DataAlignment = DMA_DATA_RIGHTALIGN_ZEROPADDED;
+  node.TriggerConfig.TriggerMode = DMA_TRIGM_BLOCK_TRANSFER;
+  node.TriggerConfig.TriggerPolarity = DMA_TRIG_POLARITY_MASKED;
+  node.RepeatBlockConfig.RepeatCount = 1U;
+  node.DataSize = TRAFFIC_DMA_BLOCK;
+#if defined CORTEX_IN_SECURE_STATE
+  node.SrcSecure = DMA_CHANNEL_SRC_SEC;
+  node.DestSecure = DMA_CHANNEL_DEST_SEC;
+#endif /* CORTEX_IN_SECURE_STATE */
+
+  for (i = 0U; i < TRAFFIC_DMA_NODES; i++)
+  {
+    mix += traffic_get(TRAFFIC_DMA_RD);
+    if (mix >= 100U)
+    {
+      mix -= 100U;
+      node.SrcAddress = ddr_addr;
+      node.DstAddress = (uint32_t)(uintptr_t)traffic_buffer;
+      node.RepeatBlockConfig.SrcAddrOffset = gap;
+      node.RepeatBlockConfig.DestAddrOffset = -(int32_t)burst_bytes;
+    }
+    else
+    {
+      node.SrcAddress = (uint32_t)(uintptr_t)traffic_buffer;
+      node.DstAddress = ddr_addr;
+      node.RepeatBlockConfig.SrcAddrOffset = -(int32_t)burst_bytes;
+      node.RepeatBlockConfig.DestAddrOffset = gap;
+    }
+    ddr_addr += (TRAFFIC_DMA_BLOCK / burst_bytes) * stride;
+
+    if ((HAL_DMAEx_List_BuildNode(&node, &traffic_nodes[i]) != HAL_OK) ||
+        (HAL_DMAEx_List_InsertNode_Tail(&traffic_queue, &traffic_nodes[i]) != HAL_OK))
+    {
+      printf("DMA node %u error\n\r", (unsigned int)i);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+/* Returns 0 when the DMA is ready, 1 without DMA, -1 on error */
+static int32_t traffic_dma_init(void)
+{
+  memset(&traffic_hdma, 0, sizeof(traffic_hdma));
+  memset(&traffic_queue, 0, sizeof(traffic_queue));
+  memset(traffic_nodes, 0, sizeof(traffic_nodes));
+
+  __HAL_RCC_HPDMA1_CLK_ENABLE();
+
+  /* Channel 15: 2D addressing, for the gap between the bursts */
+  traffic_hdma.Instance = HPDMA1_Channel15;
+  traffic_hdma.InitLinkedList.Priority = DMA_LOW_PRIORITY_HIGH_WEIGHT;
+  traffic_hdma.InitLinkedList.LinkStepMode = DMA_LSM_FULL_EXECUTION;
+  traffic_hdma.InitLinkedList.LinkAllocatedPort = DMA_LINK_ALLOCATED_PORT0;
+  traffic_hdma.InitLinkedList.TransferEventMode = DMA_TCEM_LAST_LL_ITEM_TRANSFER;
+  traffic_hdma.InitLinkedList.LinkedListMode = DMA_LINKEDLIST_NORMAL;
+
+  if (HAL_DMAEx_List_Init(&traffic_hdma) != HAL_OK)
+  {
+    printf("DMA init error\n\r");
+    return -1;
+  }
+
+#if defined CORTEX_IN_SECURE_STATE
+  if (HAL_DMA_ConfigChannelAttributes(&traffic_hdma, DMA_CHANNEL_PRIV | DMA_CHANNEL_SEC |
+                                      DMA_CHANNEL_SRC_SEC | DMA_CHANNEL_DEST_SEC) != HAL_OK)
+  {
+    printf("DMA attributes error\n\r");
+    return -1;
+  }
+#endif /* CORTEX_IN_SECURE_STATE */
+
+  if ((traffic_dma_build() != 0) ||
+      (HAL_DMAEx_List_LinkQ(&traffic_hdma, &traffic_queue) != HAL_OK))
+  {
+    (void)HAL_DMAEx_List_DeInit(&traffic_hdma);
+    return -1;
+  }
+
+  return 0;
+}
+
+static int32_t traffic_dma_start(void)
+{
+  return (HAL_DMAEx_List_Start(&traffic_hdma) == HAL_OK) ? 0 : -1;
+}
+
+/*
+ * Returns 1 when the linked list is executed, 0 while in progress (timeout 0)
+ * and -1 on transfer error.
+ */
+static int32_t traffic_dma_poll(uint32_t timeout_ms)
+{
+  if ((timeout_ms == 0U) && (__HAL_DMA_GET_FLAG(&traffic_hdma, DMA_FLAG_IDLE) == 0U))
+  {
+    return 0;
+  }
+
+  if (HAL_DMA_PollForTransfer(&traffic_hdma, HAL_DMA_FULL_TRANSFER, timeout_ms) != HAL_OK)
+  {
+    printf("DMA error 0x%x\n\r", (unsigned int)HAL_DMA_GetError(&traffic_hdma));
+    return -1;
+  }
+
+  return 1;
+}
+
+static void traffic_dma_deinit(void)
+{
+  (void)HAL_DMA_Abort(&traffic_hdma);
+  (void)HAL_DMAEx_List_UnLinkQ(&traffic_hdma);
+  (void)HAL_DMAEx_List_DeInit(&traffic_hdma);
+}
+#endif /* DDR_HOST_SIM */
+
+static void print_bandwidth(const char *master, uint32_t rd_pct, uint64_t bytes,
+                            uint32_t elapsed_us, uint32_t rate)
+{
+  uint32_t kbps = traffic_rate(bytes, elapsed_us);
+
+  printf("%-8s %3u%% rd %6u.%u MB/s", master, (unsigned int)rd_pct,
+         (unsigned int)(kbps / 1000U), (unsigned int)((kbps % 1000U) / 100U));
+  if (rate != 0U)
+  {
+    printf(" (target %u MB/s)", (unsigned int)rate);
+  }
+  printf("\n\r");
+}
+
+/**
+  * @brief  Prints the traffic parameters with their value.
+  * @param  None
+  * @retval None
+  */
+void Traffic_List(void)
+{
+  uint32_t i;
+
+  for (i = 0U; i < (sizeof(traffic_params) / sizeof(traffic_params[0])); i++)
+  {
+    printf("%-12s %8u  %s\n\r", traffic_params[i].name,
+           (unsigned int)traffic_params[i].value, traffic_params[i].help);
+  }
+}
+
+/**
+  * @brief  Sets one traffic parameter.
+  * @param  param name of the parameter
+  * @param  value new value
+  * @retval 0 if success, -1 else
+  */
+int32_t Traffic_Set(const char *param, uint32_t value)
+{
+  uint32_t i;
+
+  for (i = 0U; i < (sizeof(traffic_params) / sizeof(traffic_params[0])); i++)
+  {
+    if (!strcasecmp(param, traffic_params[i].name))
+    {
+      if ((value < traffic_params[i].min) || (value > traffic_params[i].max))
+      {
+        printf("%s out of range [%u..%u]\n\r", traffic_params[i].name,
+               (unsigned int)traffic_params[i].min,
+               (unsigned int)traffic_params[i].max);
+        return -1;
+      }
+      if ((i == TRAFFIC_CPU_STRIDE) && ((value % sizeof(uint64_t)) != 0U))
+      {
+        printf("%s not multiple of 8\n\r", traffic_params[i].name);
+        return -1;
+      }
+      traffic_params[i].value = value;
+      return 0;
+    }
+  }
+
+  printf("unknown parameter %s\n\r", param);
+  return -1;
+}
+
+/**
+  * @brief  Runs the CPU and DMA traffic together, then prints the bandwidth
+  *         achieved by each master. Any key stops the run.
+  * @param  time_s duration in seconds, 0 for the "time" parameter
+  * @retval 0 if success, -1 on DMA error
+  */
+int32_t Traffic_Run(uint32_t time_s)
+{
+  volatile uint64_t *addr = (volatile uint64_t *)TRAFFIC_CPU_BASE;
+  uint32_t nb = TRAFFIC_REGION_SIZE / traffic_get(TRAFFIC_CPU_STRIDE);
+  uint32_t step = traffic_get(TRAFFIC_CPU_STRIDE) / sizeof(uint64_t);
+  uint32_t dma_list_bytes = TRAFFIC_DMA_NODES * TRAFFIC_DMA_BLOCK;
+  uint64_t cpu_bytes = 0U;
+  uint64_t dma_bytes = 0U;
+  uint64_t data = 0U;
+  uint64_t start;
+  uint32_t elapsed_us = 0U;
+  uint32_t dma_us = 0U;
+  uint32_t time_us;
+  uint32_t mix = 0U;
+  uint32_t index = 0U;
+  uint32_t i;
+  bool dma;
+  bool dma_busy = false;
+  int32_t ret = 0;
+  int32_t status;
+
+  if (time_s == 0U)
+  {
+    time_s = traffic_get(TRAFFIC_TIME);
+  }
+  if (time_s > traffic_params[TRAFFIC_TIME].max)
+  {
+    printf("invalid time %u\n\r", (unsigned int)time_s);
+    return -1;
+  }
+  time_us = time_s * 1000000U;
+
+  status = traffic_dma_init();
+  if (status < 0)
+  {
+    return -1;
+  }
+  dma = (status == 0);
+
+  printf("CPU %u%% reads, stride %u, 0x%lx..0x%lx\n\r",
+         (unsigned int)traffic_get(TRAFFIC_CPU_RD), (unsigned int)traffic_get(TRAFFIC_CPU_STRIDE),
+         (unsigned long)TRAFFIC_CPU_BASE,
+         (unsigned long)(TRAFFIC_CPU_BASE + TRAFFIC_REGION_SIZE - 1U));
+  if (dma)
+  {
+    printf("DMA %u%% reads, burst %u, stride %u, 0x%lx..0x%lx\n\r",
+           (unsigned int)traffic_get(TRAFFIC_DMA_RD), (unsigned int)traffic_get(TRAFFIC_DMA_BURST),
+           (unsigned int)traffic_get(TRAFFIC_DMA_STRIDE), (unsigned long)TRAFFIC_DMA_BASE,
+           (unsigned long)(TRAFFIC_DMA_BASE + TRAFFIC_REGION_SIZE - 1U));
+  }
+  printf("running %u s, any key to stop\n\r", (unsigned int)time_s);
+  Serial_Flush();
+
+  start = ddr_timer_get_count();
+
+  while ((elapsed_us < time_us) && !key_pressed())
+  {
+    if (dma_busy)
+    {
+      status = traffic_dma_poll(0U);
+      if (status < 0)
+      {
+        ret = -1;
+        dma_busy = false;
+        break;
+      }
+      if (status > 0)
+      {
+        dma_bytes += dma_list_bytes;
+        dma_busy = false;
+      }
+    }
+
+    if (dma && !dma_busy &&
+        traffic_below_rate(dma_bytes, traffic_get(TRAFFIC_DMA_RATE), elapsed_us))
+    {
+      if (traffic_dma_start() != 0)
+      {
+        printf("DMA start error\n\r");
+        ret = -1;
+        break;
+      }
+      dma_busy = true;
+    }
+
+    if (traffic_below_rate(cpu_bytes, traffic_get(TRAFFIC_CPU_RATE), elapsed_us))
+    {
+      for (i = 0U; i < TRAFFIC_CPU_CHUNK; i++)
+      {
+        mix += traffic_get(TRAFFIC_CPU_RD);
+        if (mix >= 100U)
+        {
+          mix -= 100U;
+          data += addr[index * step];
+        }
+        else
+        {
+          addr[index * step] = data + index;
+        }
+        index = (index + 1U < nb) ? (index + 1U) : 0U;
+      }
+      cpu_bytes += TRAFFIC_CPU_CHUNK * sizeof(uint64_t);
+    }
+
+    elapsed_us = ddr_timer_elapsed_us(start);
+  }
+
+  /* The DMA bandwidth includes the list in progress */
+  dma_us = elapsed_us;
+  if (dma_busy)
+  {
+    if (traffic_dma_poll(TRAFFIC_DMA_TIMEOUT) > 0)
+    {
+      dma_bytes += dma_list_bytes;
+      dma_us = ddr_timer_elapsed_us(start);
+    }
+    else
+    {
+      ret = -1;
+    }
+  }
+  if (dma)
+  {
+    traffic_dma_deinit();
+  }
+
+  printf("%u.%03u s\n\r", (unsigned int)(elapsed_us / 1000000U),
+         (unsigned int)((elapsed_us % 1000000U) / 1000U));
+  print_bandwidth("CPU", traffic_get(TRAFFIC_CPU_RD), cpu_bytes, elapsed_us,
+                  traffic_get(TRAFFIC_CPU_RATE));
+  if (dma)
+  {
+    print_bandwidth("HPDMA1", traffic_get(TRAFFIC_DMA_RD), dma_bytes, dma_us,
+                    traffic_get(TRAFFIC_DMA_RATE));
+  }
+  else
+  {
+    printf("%-8s not available\n\r", "HPDMA1");
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Starts the HPDMA traffic alone, as background load of another
+  *         workload: the linked list runs at full rate (no dma_rate limit)
+  *         and is started again by Traffic_LoadPoll() each time it ends.
+  * @param  None
+  * @retval 0 if started, 1 without DMA (host build), -1 on DMA error
+  */
+int32_t Traffic_LoadStart(void)
+{
+  int32_t status;
+
+  status = traffic_dma_init();
+  if (status != 0)
+  {
+    return status;
+  }
+
+  if (traffic_dma_start() != 0)
+  {
+    printf("DMA start error\n\r");
+    traffic_dma_deinit();
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Without waiting, starts again the background linked list when it
+  *         has ended.
+  * @param  bytes incremented by the bytes transferred by the ended list
+  * @retval 0 if success, -1 on DMA error
+  */
+int32_t Traffic_LoadPoll(uint64_t *bytes)
+{
+  int32_t status;
+
+  status = traffic_dma_poll(0U);
+  if (status <= 0)
+  {
+    return status;
+  }
+
+  *bytes += TRAFFIC_DMA_NODES * TRAFFIC_DMA_BLOCK;
+
+  if (traffic_dma_start() != 0)
+  {
+    printf("DMA start error\n\r");
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Waits for the end of the background linked list in progress, then
+  *         stops the HPDMA traffic.
+  * @param  bytes incremented by the bytes transferred by the last list
+  * @retval 0 if success, -1 on DMA error
+  */
+int32_t Traffic_LoadStop(uint64_t *bytes)
+{
+  int32_t status;
+
+  status = traffic_dma_poll(TRAFFIC_DMA_TIMEOUT);
+  if (status > 0)
+  {
+    *bytes += TRAFFIC_DMA_NODES * TRAFFIC_DMA_BLOCK;
+  }
+  traffic_dma_deinit();
+
+  return (status > 0) ? 0 : -1;
+}
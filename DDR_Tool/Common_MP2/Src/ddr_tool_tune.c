@@ -0,0 +1,698 @@
+/**
+  ******************************************************************************
+  * @file    ddr_tool_tune.c
+  * @author  MCD Application Team
+  * @brief   Tuning of the DDR controller settings, see ddr_tool_tune.h:
+  *          - timings: each timing field is lowered while the fast test set
+  *            passes, then backed off by a guard band,
+  *          - QoS and scheduler: coordinate descent (or sweep of one field)
+  *            over candidate values, maximizing the throughput of a
+  *            synthetic workload.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32_device_hal.h"
+
+#include "string.h"
+#include "strings.h"
+#include "ddr_tests.h"
+#include "ddr_tool_util.h"
+#include "ddr_tool_tune.h"
+#include "ddr_tool_traffic.h"
+#include "stm32mp2xx_hal_ddr_timer.h"
+#include "stm32mp_util_ddr_conf.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+  const char *name;   /* field name, as in the DDRC reference manual */
+  const char *reg;    /* DDRC register */
+  uint8_t pos;
+  uint8_t width;
+} tune_field;
+
+#define QOS_MAX_VALUES 5U
+
+typedef struct {
+  tune_field field;
+  uint8_t nb;         /* number of candidate values */
+  uint16_t values[QOS_MAX_VALUES];
+} qos_field;
+
+/* Private define ------------------------------------------------------------*/
+/* Lowest value tried, 0 meaning "disabled" or "maximum" for some fields */
+#define TUNE_MIN_VALUE 1U
+
+#if STM32MP_DDR_DUAL_AXI_PORT
+#define QOS_NB_PORTS          2U
+#else /* STM32MP_DDR_DUAL_AXI_PORT */
+#define QOS_NB_PORTS          1U
+#endif /* STM32MP_DDR_DUAL_AXI_PORT */
+
+#define QOS_GLOBAL            0xFFU /* field of all the ports */
+#define QOS_WORKLOAD_SIZE     TRAFFIC_REGION_SIZE /* CPU region of "traffic" */
+#define QOS_LOAD_CHUNK        256U /* CPU accesses between two DMA checks */
+#define QOS_NB_RUNS           3U  /* best of, against the measurement noise */
+#define QOS_MAX_PASSES        3U
+#define QOS_MIN_GAIN_PERMIL   10U /* below, a change is considered as noise */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static const tune_field tune_fields[] = {
+  {"t_ras_min",   "DRAMTMG0",  0U, 6U},
+  {"t_faw",       "DRAMTMG0", 16U, 6U},
+  {"wr2pre",      "DRAMTMG0", 24U, 7U},
+  {"t_rc",        "DRAMTMG1",  0U, 7U},
+  {"rd2pre",      "DRAMTMG1",  8U, 6U},
+  {"wr2rd",       "DRAMTMG2",  0U, 6U},
+  {"rd2wr",       "DRAMTMG2",  8U, 6U},
+  {"t_rp",        "DRAMTMG4",  0U, 5U},
+  {"t_rrd",       "DRAMTMG4",  8U, 4U},
+  {"t_ccd",       "DRAMTMG4", 16U, 4U},
+  {"t_rcd",       "DRAMTMG4", 24U, 5U},
+#if STM32MP_DDR4_TYPE
+  {"wr2rd_s",     "DRAMTMG9",  0U, 6U},
+  {"t_rrd_s",     "DRAMTMG9",  8U, 4U},
+  {"t_ccd_s",     "DRAMTMG9", 16U, 3U},
+#endif /* STM32MP_DDR4_TYPE */
+  {"t_rfc_min",   "RFSHTMG",   0U, 10U},
+#if !STM32MP_LPDDR4_TYPE
+  /* ODT driven by the controller, not by mode registers as for LPDDR4 */
+  {"rd_odt_hold", "ODTCFG",    8U, 4U},
+  {"wr_odt_hold", "ODTCFG",   24U, 4U},
+#endif /* !STM32MP_LPDDR4_TYPE */
+};
+
+/*
+ * QoS and scheduler fields with their candidate values; the port fields are
+ * given for each AXI port (register suffix _0 or _1).
+ */
+#define QOS_PORT_FIELDS(n) \
+  {{"rd_port_priority_"#n,     "PCFGR_"#n,      0U, 10U}, 3U, {0x20U, 0x100U, 0x3FFU}}, \
+  {{"rd_port_pagematch_en_"#n, "PCFGR_"#n,     14U,  1U}, 2U, {0U, 1U}}, \
+  {{"rqos_map_region0_"#n,     "PCFGQOS0_"#n,  16U,  4U}, 3U, {0U, 1U, 2U}}, \
+  {{"rqos_map_timeoutb_"#n,    "PCFGQOS1_"#n,   0U, 16U}, 3U, {0x40U, 0x80U, 0x200U}}, \
+  {{"wr_port_priority_"#n,     "PCFGW_"#n,      0U, 10U}, 3U, {0x20U, 0x100U, 0x3FFU}}, \
+  {{"wr_port_pagematch_en_"#n, "PCFGW_"#n,     14U,  1U}, 2U, {0U, 1U}}, \
+  {{"wqos_map_region0_"#n,     "PCFGWQOS0_"#n, 16U,  4U}, 2U, {0U, 1U}}, \
+  {{"wqos_map_timeout1_"#n,    "PCFGWQOS1_"#n,  0U, 16U}, 3U, {0x100U, 0x200U, 0x400U}}
+
+static const qos_field qos_fields[] = {
+  {{"prefer_write",        "SCHED",     1U,  1U}, 2U, {0U, 1U}},
+  {{"pageclose",           "SCHED",     2U,  1U}, 2U, {0U, 1U}},
+  {{"rdwr_idle_gap",       "SCHED",    24U,  7U}, 5U, {0U, 1U, 4U, 8U, 16U}},
+  {{"pageclose_timer",     "SCHED1",    0U,  8U}, 4U, {0U, 16U, 64U, 255U}},
+  {{"hpr_max_starve",      "PERFHPR1",  0U, 16U}, 3U, {0x100U, 0x200U, 0x400U}},
+  {{"hpr_xact_run_length", "PERFHPR1", 24U,  8U}, 4U, {1U, 4U, 8U, 16U}},
+  {{"lpr_max_starve",      "PERFLPR1",  0U, 16U}, 4U, {0x40U, 0x80U, 0x200U, 0x400U}},
+  {{"lpr_xact_run_length", "PERFLPR1", 24U,  8U}, 5U, {1U, 4U, 8U, 16U, 32U}},
+  {{"w_max_starve",        "PERFWR1",   0U, 16U}, 3U, {0x100U, 0x400U, 0x800U}},
+  {{"w_xact_run_length",   "PERFWR1",  24U,  8U}, 5U, {1U, 4U, 8U, 16U, 32U}},
+  {{"wrcam_lowthresh",     "SCHED3",    0U,  4U}, 3U, {2U, 4U, 8U}},
+  {{"wrcam_highthresh",    "SCHED3",    8U,  4U}, 3U, {1U, 2U, 4U}},
+  {{"wr_pghit_num_thresh", "SCHED3",   16U,  5U}, 4U, {2U, 4U, 8U, 16U}},
+  {{"rd_pghit_num_thresh", "SCHED3",   24U,  5U}, 4U, {2U, 4U, 8U, 16U}},
+  {{"rd_act_idle_gap",     "SCHED4",    0U,  8U}, 4U, {4U, 8U, 16U, 32U}},
+  {{"wr_act_idle_gap",     "SCHED4",    8U,  8U}, 4U, {4U, 8U, 16U, 32U}},
+  {{"rd_page_exp_cycles",  "SCHED4",   16U,  8U}, 4U, {16U, 32U, 64U, 128U}},
+  {{"wr_page_exp_cycles",  "SCHED4",   24U,  8U}, 4U, {4U, 8U, 16U, 32U}},
+  QOS_PORT_FIELDS(0),
+#if STM32MP_DDR_DUAL_AXI_PORT
+  QOS_PORT_FIELDS(1),
+#endif /* STM32MP_DDR_DUAL_AXI_PORT */
+};
+
+/* Registers of the #define block printed after QoS tuning */
+static const char * const qos_regs[] = {
+  "SCHED", "SCHED1", "PERFHPR1", "PERFLPR1", "PERFWR1", "SCHED3", "SCHED4",
+};
+
+static const char * const qos_port_regs[] = {
+  "PCFGR", "PCFGW", "PCFGQOS0", "PCFGQOS1", "PCFGWQOS0", "PCFGWQOS1",
+};
+
+/* Registers of the #define block printed after tuning */
+static const char * const tune_regs[] = {
+  "RFSHTMG", "DRAMTMG0", "DRAMTMG1", "DRAMTMG2", "DRAMTMG3", "DRAMTMG4",
+  "DRAMTMG5", "DRAMTMG6", "DRAMTMG7", "DRAMTMG8", "DRAMTMG9", "DRAMTMG10",
+  "DRAMTMG11", "DRAMTMG12", "DRAMTMG13", "DRAMTMG14", "DRAMTMG15", "ODTCFG",
+};
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t field_mask(const tune_field *field)
+{
+  return ((1UL << field->width) - 1UL) << field->pos;
+}
+
+static int32_t field_get(const tune_field *field, uint32_t *value)
+{
+  uint32_t reg;
+
+  if (HAL_DDR_Read_Reg(field->reg, &reg) != HAL_OK)
+  {
+    return -1;
+  }
+
+  *value = (reg & field_mask(field)) >> field->pos;
+
+  return 0;
+}
+
+static int32_t field_set(const tune_field *field, uint32_t value)
+{
+  uint32_t reg;
+
+  if (HAL_DDR_Read_Reg(field->reg, &reg) != HAL_OK)
+  {
+    return -1;
+  }
+
+  reg = (reg & ~field_mask(field)) | ((value << field->pos) & field_mask(field));
+
+  if (HAL_DDR_Write_Reg(field->reg, reg) != HAL_OK)
+  {
+    return -1;
+  }
+
+  return 0;
+}
+
+static bool fast_test(uint32_t size)
+{
+  return (DDR_Test_DatabusWalk0(1UL, 0UL) == 0U) &&
+         (DDR_Test_DatabusWalk1(1UL, 0UL) == 0U) &&
+         (DDR_Test_NoiseBurst(size, 0UL, 0UL) == 0U) &&
+         (DDR_Test_Random(size, 1UL, 0UL) == 0U);
+}
+
+static bool key_pressed(void)
+{
+  uint8_t key;
+
+  return Serial_GetByte(&key, 0U) == 0;
+}
+
+/*
+ * Tunes one field, returns 0 if done, 1 if stopped by the user,
+ * -1 on register update error.
+ */
+static int32_t tune_field_run(const tune_field *field, uint32_t guard,
+                              uint32_t size)
+{
+  uint32_t initial;
+  uint32_t minimum;
+  uint32_t value;
+
+  if (field_get(field, &initial) != 0)
+  {
+    return -1;
+  }
+
+  minimum = initial;
+  while (minimum > TUNE_MIN_VALUE)
+  {
+    if (key_pressed())
+    {
+      printf("%-12s stopped, restored to %u\n\r", field->name, (unsigned int)initial);
+      return (field_set(field, initial) == 0) ? 1 : -1;
+    }
+
+    if (field_set(field, minimum - 1U) != 0)
+    {
+      return -1;
+    }
+
+    if (!fast_test(size))
+    {
+      break;
+    }
+
+    minimum--;
+  }
+
+  value = minimum + guard;
+  if (value > initial)
+  {
+    value = initial;
+  }
+
+  if (field_set(field, value) != 0)
+  {
+    return -1;
+  }
+
+  /* The guard band value must pass as well, else the field is restored */
+  if (!fast_test(size))
+  {
+    printf("%-12s failed at %u, restored\n\r", field->name, (unsigned int)value);
+    value = initial;
+    if (field_set(field, value) != 0)
+    {
+      return -1;
+    }
+  }
+
+  printf("%-12s %-9s %7u %7u %7u\n\r", field->name, field->reg,
+         (unsigned int)initial, (unsigned int)minimum, (unsigned int)value);
+
+  return 0;
+}
+
+static void print_defines(uint32_t guard)
+{
+  uint32_t i;
+  uint32_t value;
+
+  printf("\n/* DDR TUNED TIMINGS (guard band %u) */\n\r", (unsigned int)guard);
+
+  for (i = 0; i < (sizeof(tune_regs) / sizeof(tune_regs[0])); i++)
+  {
+    if (HAL_DDR_Read_Reg(tune_regs[i], &value) == HAL_OK)
+    {
+      printf("#define DDR_%s 0x%08X\n\r", tune_regs[i], (unsigned int)value);
+    }
+  }
+}
+
+/**
+  * @brief  Prints the tuned fields with their current value.
+  * @param  None
+  * @retval None
+  */
+void Tune_List(void)
+{
+  uint32_t i;
+  uint32_t value;
+
+  printf("%-12s %-9s %7s\n\r", "field", "register", "value");
+
+  for (i = 0; i < (sizeof(tune_fields) / sizeof(tune_fields[0])); i++)
+  {
+    if (field_get(&tune_fields[i], &value) == 0)
+    {
+      printf("%-12s %-9s %7u\n\r", tune_fields[i].name, tune_fields[i].reg,
+             (unsigned int)value);
+    }
+  }
+}
+
+/**
+  * @brief  Tunes one or all the timing fields, then prints the #define block
+  *         of the timing registers, as the "save" command.
+  * @param  field field name, or "all"
+  * @param  guard guard band added to the minimum passing value
+  * @param  size number of bytes tested at the DDR base address
+  * @retval 0 if success, -1 else
+  */
+int32_t Tune_Run(const char *field, uint32_t guard, uint32_t size)
+{
+  uint32_t i;
+  uint32_t nb = 0U;
+  int32_t ret = 0;
+  bool all = (strcasecmp(field, "all") == 0);
+
+  for (i = 0; i < (sizeof(tune_fields) / sizeof(tune_fields[0])); i++)
+  {
+    if (all || (strcasecmp(field, tune_fields[i].name) == 0))
+    {
+      nb++;
+    }
+  }
+
+  if (nb == 0U)
+  {
+    printf("unknown field %s\n\r", field);
+    return -1;
+  }
+
+  if (!fast_test(size))
+  {
+    printf("tests failed with the initial timings\n\r");
+    return -1;
+  }
+
+  printf("%-12s %-9s %7s %7s %7s\n\r", "field", "register", "initial", "minimum",
+         "tuned");
+
+  for (i = 0; (i < (sizeof(tune_fields) / sizeof(tune_fields[0]))) && (ret == 0); i++)
+  {
+    if (all || (strcasecmp(field, tune_fields[i].name) == 0))
+    {
+      ret = tune_field_run(&tune_fields[i], guard, size);
+    }
+  }
+
+  if (ret < 0)
+  {
+    printf("register update failed\n\r");
+    return -1;
+  }
+
+  print_defines(guard);
+
+  return 0;
+}
+
+/* Port of a QoS field, QOS_GLOBAL for the scheduler fields */
+static uint32_t qos_field_port(const qos_field *qos)
+{
+  size_t len = strlen(qos->field.reg);
+
+  if (qos->field.reg[len - 2U] != '_')
+  {
+    return QOS_GLOBAL;
+  }
+
+  return (uint32_t)(qos->field.reg[len - 1U] - '0');
+}
+
+/*
+ * Synthetic workload: from the CPU, <rd_pct>% of reads, the others being
+ * writes, one 64-bit access every <stride> bytes over QOS_WORKLOAD_SIZE
+ * bytes (the DDR is mapped non-cacheable, so each access reaches the DDR).
+ * The single CPU accesses keep at most one transaction in the controller
+ * queues, so the HPDMA1 traffic runs in the background (next 16MB, see
+ * "traffic") to fill them; the throughput is the one of both masters.
+ * Gives the best throughput of QOS_NB_RUNS runs, in KB/s.
+ */
+static int32_t qos_workload(uint32_t rd_pct, uint32_t stride, uint32_t *kbps)
+{
+  volatile uint64_t *addr = (volatile uint64_t *)DDR_MEM_BASE;
+  uint32_t nb = QOS_WORKLOAD_SIZE / stride;
+  uint64_t bytes;
+  uint32_t best = 0U;
+  uint32_t elapsed_us;
+  uint32_t mix;
+  uint32_t run;
+  uint32_t i;
+  uint64_t start;
+  uint64_t data = 0U;
+  int32_t load;
+  int32_t ret = 0;
+
+  for (run = 0U; (run < QOS_NB_RUNS) && (ret == 0); run++)
+  {
+    mix = 0U;
+    bytes = (uint64_t)nb * sizeof(uint64_t);
+
+    load = Traffic_LoadStart();
+    if (load < 0)
+    {
+      return -1;
+    }
+
+    start = ddr_timer_get_count();
+
+    for (i = 0U; i < nb; i++)
+    {
+      mix += rd_pct;
+      if (mix >= 100U)
+      {
+        mix -= 100U;
+        data += addr[(i * stride) / sizeof(uint64_t)];
+      }
+      else
+      {
+        addr[(i * stride) / sizeof(uint64_t)] = data + i;
+      }
+
+      if ((load == 0) && ((i % QOS_LOAD_CHUNK) == 0U) &&
+          (Traffic_LoadPoll(&bytes) != 0))
+      {
+        ret = -1;
+        break;
+      }
+    }
+
+    /* The DMA throughput includes the list in progress */
+    if ((load == 0) && (Traffic_LoadStop(&bytes) != 0))
+    {
+      ret = -1;
+    }
+
+    elapsed_us = ddr_timer_elapsed_us(start);
+    if (elapsed_us == 0U)
+    {
+      elapsed_us = 1U;
+    }
+
+    if ((bytes * 1000U / elapsed_us) > best)
+    {
+      best = (uint32_t)(bytes * 1000U / elapsed_us);
+    }
+  }
+
+  *kbps = best;
+
+  return ret;
+}
+
+static void print_throughput(const char *label, uint32_t kbps)
+{
+  printf("%-24s %6u.%u MB/s\n\r", label, (unsigned int)(kbps / 1000U),
+         (unsigned int)((kbps % 1000U) / 100U));
+}
+
+static bool qos_check_workload(uint32_t rd_pct, uint32_t stride, uint32_t port)
+{
+  if ((rd_pct > 100U) || (stride < sizeof(uint64_t)) ||
+      ((stride % sizeof(uint64_t)) != 0U) || (stride > QOS_WORKLOAD_SIZE))
+  {
+    printf("invalid workload: read %u%%, stride %u\n\r", (unsigned int)rd_pct,
+           (unsigned int)stride);
+    return false;
+  }
+
+  if (port >= QOS_NB_PORTS)
+  {
+    printf("invalid port %u\n\r", (unsigned int)port);
+    return false;
+  }
+
+  return true;
+}
+
+/**
+  * @brief  Prints the QoS and scheduler fields with their current value and
+  *         candidate values.
+  * @param  None
+  * @retval None
+  */
+void Tune_QosList(void)
+{
+  uint32_t i;
+  uint32_t j;
+  uint32_t value;
+
+  printf("%-24s %-12s %7s  %s\n\r", "field", "register", "value", "candidates");
+
+  for (i = 0; i < (sizeof(qos_fields) / sizeof(qos_fields[0])); i++)
+  {
+    if (field_get(&qos_fields[i].field, &value) != 0)
+    {
+      continue;
+    }
+
+    printf("%-24s %-12s %7u ", qos_fields[i].field.name, qos_fields[i].field.reg,
+           (unsigned int)value);
+    for (j = 0; j < qos_fields[i].nb; j++)
+    {
+      printf(" %u", (unsigned int)qos_fields[i].values[j]);
+    }
+    printf("\n\r");
+  }
+}
+
+/**
+  * @brief  Measures the synthetic workload for each candidate value of one
+  *         QoS field, the field being then restored.
+  * @param  field field name
+  * @param  rd_pct percentage of reads of the workload
+  * @param  stride access stride of the workload in bytes
+  * @retval 0 if success, -1 else
+  */
+int32_t Tune_QosSweep(const char *field, uint32_t rd_pct, uint32_t stride)
+{
+  const qos_field *qos = NULL;
+  uint32_t initial;
+  uint32_t kbps;
+  uint32_t i;
+  char label[24];
+
+  for (i = 0; i < (sizeof(qos_fields) / sizeof(qos_fields[0])); i++)
+  {
+    if (strcasecmp(field, qos_fields[i].field.name) == 0)
+    {
+      qos = &qos_fields[i];
+    }
+  }
+
+  if (qos == NULL)
+  {
+    printf("unknown field %s\n\r", field);
+    return -1;
+  }
+
+  if (!qos_check_workload(rd_pct, stride, 0U) ||
+      (field_get(&qos->field, &initial) != 0))
+  {
+    return -1;
+  }
+
+  for (i = 0; i < qos->nb; i++)
+  {
+    if (field_set(&qos->field, qos->values[i]) != 0)
+    {
+      return -1;
+    }
+
+    if (qos_workload(rd_pct, stride, &kbps) != 0)
+    {
+      (void)field_set(&qos->field, initial);
+      return -1;
+    }
+    snprintf(label, sizeof(label), "%u%s", (unsigned int)qos->values[i],
+             (qos->values[i] == initial) ? " (current)" : "");
+    print_throughput(label, kbps);
+  }
+
+  return field_set(&qos->field, initial);
+}
+
+/**
+  * @brief  Coordinate descent over the scheduler fields and the fields of one
+  *         port: each field in turn is set to the candidate value giving the
+  *         best workload throughput, until no field improves it. The best
+  *         configuration is kept and printed as a #define block.
+  * @param  rd_pct percentage of reads of the workload
+  * @param  stride access stride of the workload in bytes
+  * @param  port AXI port of the tuned port fields
+  * @retval 0 if success, -1 else
+  */
+int32_t Tune_QosRun(uint32_t rd_pct, uint32_t stride, uint32_t port)
+{
+  const qos_field *qos;
+  uint32_t initial_kbps;
+  uint32_t best_kbps;
+  uint32_t best_value;
+  uint32_t kbps;
+  uint32_t pass;
+  uint32_t i;
+  uint32_t j;
+  uint32_t value;
+  bool improved = true;
+  char name[16];
+
+  if (!qos_check_workload(rd_pct, stride, port))
+  {
+    return -1;
+  }
+
+  printf("workload: %u%% read, stride %u, port %u fields\n\r",
+         (unsigned int)rd_pct, (unsigned int)stride, (unsigned int)port);
+
+  if (qos_workload(rd_pct, stride, &initial_kbps) != 0)
+  {
+    return -1;
+  }
+  best_kbps = initial_kbps;
+  print_throughput("initial", initial_kbps);
+
+  for (pass = 0U; (pass < QOS_MAX_PASSES) && improved; pass++)
+  {
+    improved = false;
+
+    for (i = 0; i < (sizeof(qos_fields) / sizeof(qos_fields[0])); i++)
+    {
+      qos = &qos_fields[i];
+      if ((qos_field_port(qos) != QOS_GLOBAL) && (qos_field_port(qos) != port))
+      {
+        continue;
+      }
+
+      if (field_get(&qos->field, &best_value) != 0)
+      {
+        return -1;
+      }
+
+      for (j = 0; j < qos->nb; j++)
+      {
+        if (key_pressed())
+        {
+          printf("stopped\n\r");
+          (void)field_set(&qos->field, best_value);
+          pass = QOS_MAX_PASSES;
+          break;
+        }
+
+        value = qos->values[j];
+        if ((value == best_value) || (field_set(&qos->field, value) != 0))
+        {
+          continue;
+        }
+
+        if (qos_workload(rd_pct, stride, &kbps) != 0)
+        {
+          (void)field_set(&qos->field, best_value);
+          return -1;
+        }
+        if ((uint64_t)kbps * 1000U >
+            (uint64_t)best_kbps * (1000U + QOS_MIN_GAIN_PERMIL))
+        {
+          best_kbps = kbps;
+          best_value = value;
+          improved = true;
+          print_throughput(qos->field.name, kbps);
+        }
+      }
+
+      if (field_set(&qos->field, best_value) != 0)
+      {
+        return -1;
+      }
+
+      if (pass >= QOS_MAX_PASSES)
+      {
+        break;
+      }
+    }
+  }
+
+  print_throughput("best", best_kbps);
+  printf("gain %d.%d%%\n\r",
+         (int)(((int64_t)best_kbps - initial_kbps) * 100 / initial_kbps),
+         (int)((((int64_t)best_kbps - initial_kbps) * 1000 / initial_kbps) % 10));
+
+  printf("\n/* DDR TUNED QOS (port %u) */\n\r", (unsigned int)port);
+
+  for (i = 0; i < (sizeof(qos_regs) / sizeof(qos_regs[0])); i++)
+  {
+    if (HAL_DDR_Read_Reg(qos_regs[i], &value) == HAL_OK)
+    {
+      printf("#define DDR_%s 0x%08X\n\r", qos_regs[i], (unsigned int)value);
+    }
+  }
+
+  for (i = 0; i < (sizeof(qos_port_regs) / sizeof(qos_port_regs[0])); i++)
+  {
+    snprintf(name, sizeof(name), "%s_%u", qos_port_regs[i], (unsigned int)port);
+    if (HAL_DDR_Read_Reg(name, &value) == HAL_OK)
+    {
+      printf("#define DDR_%s 0x%08X\n\r", name, (unsigned int)value);
+    }
+  }
+
+  return 0;
+}
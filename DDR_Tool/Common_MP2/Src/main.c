@@ -71,14 +71,17 @@ int main(void)
 
   HAL_Init();
 
-  /* Dummy delay to ensure SysTick is running fine
+  /*
+   * Configure A35 system clock, because some parts are only reachable in EL3.
+   * This starts STGEN, which provides the time base of all delays.
+   */
+  Mon_A35SystemClockConfig();
+
+  /* Dummy delay to ensure STGEN is running fine
    * If it is not we will be stuck here
    */
   valid_delay_us(10 * 1000);
 
-  /* Configure A35 system clock, because some parts are only reachable in EL3 */
-  Mon_A35SystemClockConfig();
-
   /* Configure the system clock */
   SystemClock_Config();
 
@@ -109,6 +112,7 @@ int main(void)
   if (HAL_DDR_Init(&iddr) != HAL_OK)
   {
     printf("DDR Initialization KO\n\r");
+    Serial_Flush();
     return 1;
   }
 
@@ -153,7 +157,7 @@ void Mon_A35SystemClockConfig( void )
    /* Set CNTFRQ_EL0 register according to STGEN frequency in Hz */
    /* see ARM DDI0487B.a page 2673 #D7.5.1 "CNTFRQ_EL0" */
    reg32_val = READ_REG(STGENC->CNTFID0);
-   asm volatile("MSR CNTFRQ_EL0, %0" : "=r" (reg32_val));
+   asm volatile("MSR CNTFRQ_EL0, %0" : : "r" ((uint64_t)reg32_val));
 
    return;
 }
@@ -576,18 +580,22 @@ void assert_failed(__attribute__((unused))uint8_t* file,
 PUTCHAR_PROTOTYPE
 {
   /* Place your implementation of fputc here */
-  /* e.g. write a character to the USART1 and Loop until the end of transmission */
+  /* e.g. queue a character in the console UART TX buffer */
+  /* __LOG_TRACE_IO_ only records the log_* messages, see log.h */
 #if defined (__LOG_UART_IO_)
-extern UART_HandleTypeDef huart;
-  HAL_UART_Transmit(&huart, (uint8_t *)&ch, 1, HAL_MAX_DELAY);
-#endif
-#if defined (__LOG_TRACE_IO_)
-	log_buff(ch);
+  Serial_Putchar((char)ch);
 #endif
 	return ch;
 }
 #endif
 
+#if defined (__LOG_UART_IO_) && defined (__GNUC__)
+int __attribute__(( weak )) __io_getchar(void)
+{
+  return (int)Serial_Scanf(0xFFU);
+}
+#endif
+
 /**
   * @}
   */
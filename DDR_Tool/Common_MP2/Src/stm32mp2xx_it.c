@@ -139,6 +139,37 @@ void SysTick_Handler(void)
   HAL_IncTick();
 }
 
+/******************************************************************************/
+/*                 STM32MP2xx Peripherals Interrupt Handlers                  */
+/******************************************************************************/
+
+/**
+  * @brief  This function handles IRQ taken at EL3 (called from the
+  *         minimal_startup64_a35.s vector table).
+  * @param  None
+  * @retval None
+  */
+void el3_curr_el_spx_irq_vector(void)
+{
+  IRQn_Type irqn = GIC_AcknowledgePending();
+  uint32_t id = (uint32_t)irqn & 0x3FFU;
+
+  /* 1020 to 1023: spurious, nothing to acknowledge */
+  if (id >= 1020U)
+  {
+    return;
+  }
+
+#if defined(COM_CA35_IRQn)
+  if (id == (uint32_t)COM_CA35_IRQn)
+  {
+    Serial_IRQHandler();
+  }
+#endif /* COM_CA35_IRQn */
+
+  GIC_EndInterrupt(irqn);
+}
+
 /**
   * @}
   */
@@ -0,0 +1,47 @@
+/**
+  ******************************************************************************
+  * @file    host_sim.h
+  * @author  MCD Application Team
+  * @brief   Header for the host build of the DDR tool (host_sim.c and
+  *          host_serial.c modules)
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HOST_SIM_H
+#define __HOST_SIM_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/*
+ * The register file is a plain memory at the addresses of the peripherals on
+ * target, so that the DDR HAL and the console run unmodified (the build is
+ * not position independent). The status registers polled by the HAL are set
+ * to their "done" value; there is no model of the DDR controller behavior.
+ */
+#define HOST_SIM_IP_SIZE      0x10000U    /* DDRC, DDRDBG, RCC, PWR */
+#define HOST_SIM_PHY_SIZE     0x400000U   /* DDRPHYC, CSR address * 4 */
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+int32_t HostSim_Init(void);
+void HostSim_Reset(void);
+
+int32_t HostSerial_Init(bool pty);
+void HostSerial_Exit(int status);
+
+#endif /* __HOST_SIM_H */
@@ -0,0 +1,89 @@
+/**
+  ******************************************************************************
+  * @file    host_main.c
+  * @author  MCD Application Team
+  * @brief   Main program of the host build of the DDR tool (DDR_HOST_SIM).
+  *          Runs the DDR interactive console through the DDR steps, against
+  *          the simulated register file of host_sim.c.
+  *          The DDR init sequence itself (HAL_DDR_Init) is not executed: the
+  *          steps are only the points where the console is entered.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+
+#include "stm32_device_hal.h"
+#include "ddr_tool_util.h"
+#include "host_sim.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "usage: %s [-p]\n", name);
+  fprintf(stderr, "  console on stdin/stdout, on a pseudo terminal with -p\n");
+}
+
+/**
+  * @brief  Main program
+  * @param  argc, argv command line
+  * @retval 0 when the tool exits from the last step, 1 on error
+  */
+int main(int argc, char *argv[])
+{
+  HAL_DDR_InteractStepTypeDef step;
+  bool pty = false;
+
+  if ((argc == 2) && (strcmp(argv[1], "-p") == 0))
+  {
+    pty = true;
+  }
+  else if (argc != 1)
+  {
+    usage(argv[0]);
+    return 1;
+  }
+
+  if ((HostSim_Init() != 0) || (HostSerial_Init(pty) != 0))
+  {
+    return 1;
+  }
+
+  UART_Config();
+
+  /* Same step sequence as HAL_DDR_Init(), back to step 0 on request */
+  step = STEP_DDR_RESET;
+  while (step < STEP_RUN)
+  {
+    HAL_DDR_Snapshot_Take((uint32_t)step);
+
+    if (HAL_DDR_Interactive(step))
+    {
+      HostSim_Reset();
+      step = STEP_DDR_RESET;
+      continue;
+    }
+
+    step++;
+  }
+
+  HostSerial_Exit(0);
+
+  return 0;
+}
@@ -0,0 +1,321 @@
+/**
+  ******************************************************************************
+  * @file    host_serial.c
+  * @author  MCD Application Team
+  * @brief   Console of the host build of the DDR tool (DDR_HOST_SIM), on
+  *          stdin/stdout or on a pseudo terminal: same services as the UART
+  *          console of the board (ddr_tool_util.h).
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#include "stm32_device_hal.h"
+#include "ddr_tool_util.h"
+#include "stm32mp_util_conf.h"
+#include "stm32mp_util_ddr_conf.h"
+#include "host_sim.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Time left to the host tools to read the console before the pty hang up */
+#define HOST_SERIAL_EXIT_DRAIN_MS 1000U
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static struct termios host_serial_termios;
+static bool host_serial_raw;
+static int host_serial_pty_slave = -1;
+static uint8_t host_serial_last;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Restores the terminal settings.
+  * @param  None
+  * @retval None
+  */
+static void host_serial_restore(void)
+{
+  if (host_serial_raw)
+  {
+    (void)tcsetattr(STDIN_FILENO, TCSANOW, &host_serial_termios);
+    host_serial_raw = false;
+  }
+}
+
+/**
+  * @brief  Opens a pseudo terminal and moves the console on it; its name is
+  *         printed on stderr, to be opened by the host tools.
+  * @param  None
+  * @retval 0 if success, -1 else
+  */
+static int32_t host_serial_open_pty(void)
+{
+  struct termios tio;
+  int master;
+
+  master = posix_openpt(O_RDWR | O_NOCTTY);
+  if ((master < 0) || (grantpt(master) != 0) || (unlockpt(master) != 0))
+  {
+    return -1;
+  }
+
+  /*
+   * The slave side is kept open, so that the console survives the host tools
+   * closing and reopening it.
+   */
+  host_serial_pty_slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+  if ((host_serial_pty_slave < 0) || (tcgetattr(host_serial_pty_slave, &tio) != 0))
+  {
+    return -1;
+  }
+  cfmakeraw(&tio);
+  (void)tcsetattr(host_serial_pty_slave, TCSANOW, &tio);
+
+  fprintf(stderr, "console on %s\n", ptsname(master));
+
+  if ((dup2(master, STDIN_FILENO) < 0) || (dup2(master, STDOUT_FILENO) < 0))
+  {
+    return -1;
+  }
+  (void)close(master);
+
+  return 0;
+}
+
+/**
+  * @brief  Configures the console: raw mode on a terminal, so that the keys
+  *         are received as on the UART, or a pseudo terminal.
+  * @param  pty true to serve the console on a pseudo terminal
+  * @retval 0 if success, -1 else
+  */
+int32_t HostSerial_Init(bool pty)
+{
+  struct termios tio;
+
+  if (pty)
+  {
+    return host_serial_open_pty();
+  }
+
+  if (isatty(STDIN_FILENO) && (tcgetattr(STDIN_FILENO, &host_serial_termios) == 0))
+  {
+    tio = host_serial_termios;
+    tio.c_lflag &= ~(ICANON | ECHO);
+    tio.c_iflag &= ~ICRNL;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &tio) == 0)
+    {
+      host_serial_raw = true;
+      (void)atexit(host_serial_restore);
+    }
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Leaves the tool, the console output being flushed.
+  * @param  status exit status
+  * @retval None
+  */
+void HostSerial_Exit(int status)
+{
+  uint32_t i;
+  int pending;
+
+  Serial_Flush();
+
+  if (host_serial_pty_slave >= 0)
+  {
+    for (i = 0U; i < HOST_SERIAL_EXIT_DRAIN_MS; i += 10U)
+    {
+      if ((ioctl(host_serial_pty_slave, FIONREAD, &pending) != 0) || (pending == 0))
+      {
+        break;
+      }
+      (void)usleep(10000U);
+    }
+  }
+
+  exit(status);
+}
+
+/**
+  * @brief  Prints the banner of the tool, as the UART configuration on target.
+  * @param  None
+  * @retval None
+  */
+void UART_Config(void)
+{
+  printf("\n\r=============== UTILITIES-DDR Tool ===============\r");
+  printf("\n\rModel: %s (host simulation)\r", UTIL_MODEL);
+  printf("\n\rRAM: %s \n\r", DDR_MEM_NAME);
+}
+
+/**
+  * @brief  Gets a character typed on the console.
+  *         A line feed is received as a carriage return, as sent by a
+  *         terminal, and dropped after a carriage return.
+  * @param  Maximun value allowed (value)
+  * @retval The character received
+  */
+uint32_t Serial_Scanf(uint32_t value)
+{
+  uint8_t prev;
+  uint8_t tmp;
+
+  for (;;)
+  {
+    while (Serial_GetByte(&tmp, 1000000U) != 0)
+    {
+    }
+
+    prev = host_serial_last;
+    host_serial_last = tmp;
+
+    if (tmp != '\n')
+    {
+      break;
+    }
+    if (prev != '\r')
+    {
+      tmp = '\r';
+      break;
+    }
+  }
+
+  if (tmp > value)
+  {
+    printf("\n\r  !!! Please enter valid number between 0 and %u \n", value);
+    return 0xFF;
+  }
+  return tmp;
+}
+
+/**
+  * @brief  Gets a raw byte from the console, used by binary transfers.
+  *         The tool exits at the end of its input.
+  * @param  data received byte
+  * @param  timeout_us time to wait for the byte in us
+  * @retval 0 if a byte is received, -1 on timeout
+  */
+int32_t Serial_GetByte(uint8_t *data, uint32_t timeout_us)
+{
+  struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN };
+  ssize_t ret;
+
+  /* The answers of the protocol are expected before the next byte */
+  Serial_Flush();
+
+  if (poll(&pfd, 1, (int)((timeout_us + 999U) / 1000U)) <= 0)
+  {
+    return -1;
+  }
+
+  ret = read(STDIN_FILENO, data, 1);
+  if (ret <= 0)
+  {
+    HostSerial_Exit(0);
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Sends a character to the console.
+  * @param  value character to send
+  * @retval None
+  */
+void Serial_Putchar(char value)
+{
+  (void)putchar(value);
+}
+
+/**
+  * @brief  Sends a string to the console.
+  * @param  value characters to send
+  * @param  len number of characters
+  * @retval None
+  */
+void Serial_Printf(char *value, int len)
+{
+  if (len > 0)
+  {
+    (void)fwrite(value, 1U, (size_t)len, stdout);
+  }
+}
+
+/**
+  * @brief  Waits until all queued characters are sent on the console.
+  * @param  None
+  * @retval None
+  */
+void Serial_Flush(void)
+{
+  (void)fflush(stdout);
+}
+
+/**
+  * @brief  Gets the console baud rate.
+  * @param  None
+  * @retval baud rate
+  */
+uint32_t Serial_GetBaudrate(void)
+{
+  return UTIL_UART_BAUDRATE;
+}
+
+/**
+  * @brief  Switches the console to a new baud rate: not supported on host.
+  * @param  baudrate new baud rate
+  * @param  timeout_ms confirmation timeout in ms
+  * @retval -1
+  */
+int32_t Serial_SetBaudrate(__attribute__((unused)) uint32_t baudrate,
+                           __attribute__((unused)) uint32_t timeout_ms)
+{
+  return -1;
+}
+
+/**
+  * @brief  Console interrupt handler, nothing to do on host.
+  * @param  None
+  * @retval None
+  */
+void Serial_IRQHandler(void)
+{
+}
+
+/**
+  * @brief  This function is executed in case of error occurrence.
+  * @param  None
+  * @retval None
+  */
+void Error_Handler(void)
+{
+  printf("\n\r Error Handler \n\r");
+  HostSerial_Exit(1);
+}
+
+void valid_delay_us(unsigned long delay_us)
+{
+  (void)usleep((useconds_t)delay_us);
+}
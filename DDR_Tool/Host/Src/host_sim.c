@@ -0,0 +1,242 @@
+/**
+  ******************************************************************************
+  * @file    host_sim.c
+  * @author  MCD Application Team
+  * @brief   Simulated DDRC/DDRPHYC register file and platform services of the
+  *          host build of the DDR tool (DDR_HOST_SIM).
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2023 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "stm32_device_hal.h"
+#include "stm32mp2xx_hal_ddr_timer.h"
+#include "stm32mp_util_ddr_conf.h"
+#include "host_sim.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  const char *name;
+  uintptr_t base;
+  size_t size;
+  bool reset;     /* cleared on a DDR tool restart (step 0) */
+} host_sim_region_t;
+
+/* Private define ------------------------------------------------------------*/
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE 0x100000
+#endif /* MAP_FIXED_NOREPLACE */
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static const host_sim_region_t host_sim_region[] =
+{
+  { "DDRC",    DDRC_BASE,    HOST_SIM_IP_SIZE,  true },
+  { "DDRDBG",  DDRDBG_BASE,  HOST_SIM_IP_SIZE,  true },
+  { "DDRPHYC", DDRPHYC_BASE, HOST_SIM_PHY_SIZE, true },
+  { "RCC",     RCC_BASE,     HOST_SIM_IP_SIZE,  false },
+  { "PWR",     PWR_BASE,     HOST_SIM_IP_SIZE,  false },
+  /* Pages allocated on first access only */
+  { "DDR",     DDR_MEM_BASE, DDR_MEM_SIZE,      false },
+};
+
+static RCC_PLLInitTypeDef host_sim_pll2 =
+{
+  .PLLSource  = DDR_PLL_SOURCE,
+  .PLLState   = DDR_PLL_STATE,
+  .PLLMode    = DDR_PLL_MODE,
+  .FREFDIV    = DDR_PLL_FREFDIV,
+  .FBDIV      = DDR_PLL_FBDIV,
+  .FRACIN     = DDR_PLL_FRACIN,
+  .POSTDIV1   = DDR_PLL_POSTDIV1,
+  .POSTDIV2   = DDR_PLL_POSTDIV2,
+  .SSM_Mode   = DDR_PLL_SSM_MODE,
+  .SSM_SPREAD = DDR_PLL_SSM_SPREAD,
+  .SSM_DIVVAL = DDR_PLL_SSM_DIVVAL,
+};
+
+static uint64_t host_sim_start;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Maps anonymous memory at a fixed address, page per page when the
+  *         range overlaps an already mapped region.
+  * @param  base start address, page aligned
+  * @param  size size in bytes
+  * @retval 0 if mapped, -1 else
+  */
+static int32_t host_sim_map(uintptr_t base, size_t size)
+{
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  size_t offset;
+  void *addr;
+
+  addr = mmap((void *)base, size, PROT_READ | PROT_WRITE,
+              MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED_NOREPLACE,
+              -1, 0);
+  if (addr == (void *)base)
+  {
+    return 0;
+  }
+  if (addr != MAP_FAILED)
+  {
+    /* Kernel without MAP_FIXED_NOREPLACE: the address was a hint only */
+    (void)munmap(addr, size);
+    return -1;
+  }
+  if (errno != EEXIST)
+  {
+    return -1;
+  }
+
+  for (offset = 0U; offset < size; offset += page)
+  {
+    addr = mmap((void *)(base + offset), page, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if ((addr == MAP_FAILED) && (errno != EEXIST))
+    {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Sets the status registers polled by the DDR HAL to their "done"
+  *         value: normal mode, no port busy, queues empty, quasi dynamic
+  *         update acknowledged.
+  * @param  None
+  * @retval None
+  */
+static void host_sim_set_status(void)
+{
+  WRITE_REG(DDRC->STAT, DDRC_STAT_OPERATING_MODE_0);
+  WRITE_REG(DDRC->SWSTAT, DDRC_SWSTAT_SW_DONE_ACK);
+  WRITE_REG(DDRC->DFISTAT, DDRC_DFISTAT_DFI_INIT_COMPLETE);
+  WRITE_REG(DDRC->PSTAT, 0U);
+  WRITE_REG(DDRC->DBGCAM, DDRC_DBGCAM_DBG_WR_Q_EMPTY | DDRC_DBGCAM_DBG_RD_Q_EMPTY |
+                          DDRC_DBGCAM_WR_DATA_PIPELINE_EMPTY |
+                          DDRC_DBGCAM_RD_DATA_PIPELINE_EMPTY);
+}
+
+/**
+  * @brief  Maps the simulated register file and DDR.
+  * @param  None
+  * @retval 0 if success, -1 else
+  */
+int32_t HostSim_Init(void)
+{
+  uint32_t i;
+
+  for (i = 0U; i < (sizeof(host_sim_region) / sizeof(host_sim_region[0])); i++)
+  {
+    if (host_sim_map(host_sim_region[i].base, host_sim_region[i].size) != 0)
+    {
+      fprintf(stderr, "cannot map %s at 0x%lx: %s\n", host_sim_region[i].name,
+              (unsigned long)host_sim_region[i].base, strerror(errno));
+      return -1;
+    }
+  }
+
+  host_sim_set_status();
+  host_sim_start = ddr_timer_get_count();
+
+  return 0;
+}
+
+/**
+  * @brief  Puts the DDR controller and PHY registers back to their reset
+  *         value, as done by the DDR reset when the tool restarts in step 0.
+  * @param  None
+  * @retval None
+  */
+void HostSim_Reset(void)
+{
+  uint32_t i;
+
+  for (i = 0U; i < (sizeof(host_sim_region) / sizeof(host_sim_region[0])); i++)
+  {
+    if (host_sim_region[i].reset)
+    {
+      memset((void *)host_sim_region[i].base, 0, host_sim_region[i].size);
+    }
+  }
+
+  host_sim_set_status();
+}
+
+/**
+  * @brief  Provides a tick value in millisecond, since the tool start.
+  * @param  None
+  * @retval tick value
+  */
+uint32_t HAL_GetTick(void)
+{
+  return (uint32_t)((ddr_timer_get_count() - host_sim_start) / 1000U);
+}
+
+/**
+  * @brief  Gets the simulated PLL2 configuration.
+  * @param  pll_config PLL2 configuration
+  * @retval None
+  */
+void HAL_RCCEx_GetPLL2Config(RCC_PLLInitTypeDef *pll_config)
+{
+  *pll_config = host_sim_pll2;
+}
+
+/**
+  * @brief  Configures the simulated PLL2, always locked.
+  * @param  pll_config PLL2 configuration
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_RCCEx_PLL2Config(RCC_PLLInitTypeDef *pll_config)
+{
+  host_sim_pll2 = *pll_config;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Computes the simulated PLL2 frequency, as RCCEx_ComputePLLClockFreq.
+  * @param  None
+  * @retval PLL2 frequency in Hz
+  */
+uint32_t HAL_RCCEx_GetPLL2ClockFreq(void)
+{
+  const RCC_PLLInitTypeDef *pll = &host_sim_pll2;
+  uint64_t source_freq;
+  uint64_t pll_output;
+
+  if (pll->PLLState != RCC_PLL_ON)
+  {
+    return 0U;
+  }
+
+  source_freq = (pll->PLLSource == RCC_PLLSOURCE_HSE) ? HSE_VALUE : HSI_VALUE;
+
+  pll_output = source_freq * (((uint64_t)(1U << 24) * pll->FBDIV) + pll->FRACIN);
+  pll_output /= (1U << 24);
+  pll_output /= ((uint64_t)pll->FREFDIV * pll->POSTDIV1 * pll->POSTDIV2);
+
+  return (uint32_t)pll_output;
+}
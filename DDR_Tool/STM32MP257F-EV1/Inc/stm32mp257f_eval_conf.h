@@ -28,7 +28,8 @@
 #include "stm32mp2xx_hal.h"
 
 /* COM usage define */
-#define USE_COM_LOG                         1U
+/* Log I/O (__io_putchar) is provided by the DDR tool through its TX buffer */
+#define USE_COM_LOG                         0U
 #define USE_BSP_COM_FEATURE                 1U
 
 /* LCD controllers defines */
@@ -39,6 +39,13 @@
 #define UTIL_UART_STOPBITS      UART_STOPBITS_1
 #define UTIL_UART_PARITY        UART_PARITY_NONE
 #define UTIL_UART_HWFLOWCTL     UART_HWCONTROL_NONE
+#define UTIL_UART_TX_BUFFER_SIZE 4096U /* power of 2 */
+#define UTIL_UART_BAUD_TIMEOUT_MS 3000U /* host confirmation of a baud switch */
+
+/* Console scripts, see ddr_tool_script.h */
+#define UTIL_DDR_SCRIPT_SIZE 4096U
+/* Default plan, executed at start when defined, e.g. */
+/* #define UTIL_DDR_SCRIPT_DEFAULT "step 3\ntest 0\n" */
 
 /* PMIC related configuration */
 #define UTIL_USE_PMIC                     1
@@ -24,6 +24,7 @@
 #include "stm32mp257f_eval.h"
 
 #include "ddr_tool_util.h"
+#include "stm32mp2xx_hal_ddr_timer.h"
 #include "main.h"
 #include "stm32mp_util_conf.h"
 #include "stm32mp_util_ddr_conf.h"
@@ -32,17 +33,172 @@
 /* Private define ------------------------------------------------------------*/
 #define HAL_TIMEOUT_VALUE   HAL_MAX_DELAY
 
+#ifndef UTIL_UART_TX_BUFFER_SIZE
+#define UTIL_UART_TX_BUFFER_SIZE 4096U
+#endif /* UTIL_UART_TX_BUFFER_SIZE */
+#define UART_TX_RING_MASK        (UTIL_UART_TX_BUFFER_SIZE - 1U)
+#define UART_TX_FLUSH_TIMEOUT_US 2000000U
+#define UART_TX_IRQ_PRIORITY     0x80U
+
+/* Baud rate switch: delay left to the host to reconfigure its side */
+#define UART_BAUD_SETTLE_US      20000U
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 /* UART handler declaration, used for logging */
 UART_HandleTypeDef huart;
 
+/*
+ * TX ring buffer: characters are queued by the console functions and moved to
+ * the UART TX FIFO by the UART interrupt (or by the producers themselves when
+ * the interrupt is not available). Indexes are free running.
+ */
+static uint8_t uart_tx_ring[UTIL_UART_TX_BUFFER_SIZE];
+static volatile uint32_t uart_tx_head;
+static volatile uint32_t uart_tx_tail;
+static bool uart_tx_ready;
+static bool uart_tx_irq;
+
 /* Private function prototypes -----------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
+/**
+  * @brief  Mask IRQ on the current core.
+  * @param  None
+  * @retval previous interrupt mask state
+  */
+static inline uint64_t uart_tx_lock(void)
+{
+  uint64_t daif = 0U;
+
+#ifdef __AARCH64__
+  __asm volatile("mrs %0, daif\n\tmsr daifset, #2" : "=r" (daif) : : "memory");
+#endif /* __AARCH64__ */
+
+  return daif;
+}
+
+/**
+  * @brief  Restore the interrupt mask state saved by uart_tx_lock().
+  * @param  daif previous interrupt mask state
+  * @retval None
+  */
+static inline void uart_tx_unlock(uint64_t daif)
+{
+#ifdef __AARCH64__
+  __asm volatile("msr daif, %0" : : "r" (daif) : "memory");
+#else /* __AARCH64__ */
+  (void)daif;
+#endif /* __AARCH64__ */
+}
+
+/**
+  * @brief  Move queued characters to the UART TX FIFO, as long as it is not
+  *         full. To be called with IRQ masked or from the UART interrupt.
+  * @param  None
+  * @retval None
+  */
+static void uart_tx_fill(void)
+{
+  UART_HandleTypeDef *huart_com = &hcom_uart[COM1];
+  uint32_t tail = uart_tx_tail;
+
+  while ((tail != uart_tx_head) &&
+         (__HAL_UART_GET_FLAG(huart_com, UART_FLAG_TXFNF) != RESET))
+  {
+    huart_com->Instance->TDR = uart_tx_ring[tail & UART_TX_RING_MASK];
+    tail++;
+  }
+
+  uart_tx_tail = tail;
+
+  if (tail == uart_tx_head)
+  {
+    __HAL_UART_DISABLE_IT(huart_com, UART_IT_TXFT);
+  }
+  else if (uart_tx_irq)
+  {
+    __HAL_UART_ENABLE_IT(huart_com, UART_IT_TXFT);
+  }
+}
+
+/**
+  * @brief  Feed the UART TX FIFO from thread context.
+  * @param  None
+  * @retval None
+  */
+static void uart_tx_pump(void)
+{
+  uint64_t daif = uart_tx_lock();
+
+  uart_tx_fill();
+  uart_tx_unlock(daif);
+}
+
+/**
+  * @brief  Queue characters to be sent, waiting for room when the ring
+  *         buffer is full.
+  * @param  data characters to send
+  * @param  len number of characters
+  * @retval None
+  */
+static void uart_tx_write(const uint8_t *data, uint32_t len)
+{
+  while (len > 0U)
+  {
+    uint32_t head = uart_tx_head;
+    uint32_t room = UTIL_UART_TX_BUFFER_SIZE - (head - uart_tx_tail);
+
+    while ((room > 0U) && (len > 0U))
+    {
+      uart_tx_ring[head & UART_TX_RING_MASK] = *data++;
+      head++;
+      room--;
+      len--;
+    }
+
+    uart_tx_head = head;
+    uart_tx_pump();
+  }
+}
+
+#if defined(COM_CA35_IRQn)
+/**
+  * @brief  Route the console UART interrupt to this core (secure group 0,
+  *         taken as IRQ at EL3) and unmask IRQ.
+  * @param  None
+  * @retval None
+  */
+static void uart_tx_irq_config(void)
+{
+  GIC_EnableDistributor();
+  GIC_SetGroup(COM_CA35_IRQn, 0U);
+  GIC_SetConfiguration(COM_CA35_IRQn, 0U);
+  GIC_SetPriority(COM_CA35_IRQn, UART_TX_IRQ_PRIORITY);
+  GIC_SetTarget(COM_CA35_IRQn, 1U);
+  GIC_EnableInterface();
+  GIC_SetInterfacePriorityMask(0xFFU);
+  GIC_EnableIRQ(COM_CA35_IRQn);
+
+#ifdef __AARCH64__
+  {
+    uint64_t scr;
+
+    /* Physical IRQs are taken at EL3 only when routed there */
+    __asm volatile("mrs %0, scr_el3" : "=r" (scr));
+    scr |= 0x2U; /* SCR_EL3.IRQ */
+    __asm volatile("msr scr_el3, %0\n\tisb" : : "r" (scr) : "memory");
+    __asm volatile("msr daifclr, #2" : : : "memory");
+  }
+#endif /* __AARCH64__ */
+
+  uart_tx_irq = true;
+}
+#endif /* COM_CA35_IRQn */
+
 /**
   * @brief  This function is executed to configure in case of error occurrence.
   * @param  None
@@ -52,7 +208,6 @@ void UART_Config(void)
 {
   COM_InitTypeDef COM_Init;
 
-  BSP_COM_SelectLogPort(COM1);
   COM_Init.BaudRate   = UTIL_UART_BAUDRATE;
   COM_Init.Parity     = (COM_ParityTypeDef)UTIL_UART_PARITY;
   COM_Init.StopBits   = (COM_StopBitsTypeDef)UTIL_UART_STOPBITS;
@@ -78,6 +233,13 @@ void UART_Config(void)
     Error_Handler();
   }
 
+  uart_tx_head = 0U;
+  uart_tx_tail = 0U;
+  uart_tx_ready = true;
+#if defined(COM_CA35_IRQn)
+  uart_tx_irq_config();
+#endif /* COM_CA35_IRQn */
+
   /* Output a message on Hyperterminal using printf function */
   printf("\n\r=============== UTILITIES-DDR Tool ===============\r");
   printf("\n\rModel: %s \r", UTIL_MODEL);
@@ -110,6 +272,12 @@ uint32_t Serial_Scanf(uint32_t value)
 
 #ifndef __TERMINAL_IO__
   __HAL_UART_CLEAR_OREFLAG(&hcom_uart[COM1]);
+  /* Keep the pending output going while waiting for the user */
+  while (uart_tx_ready &&
+         (__HAL_UART_GET_FLAG(&hcom_uart[COM1], UART_FLAG_RXFNE) == RESET))
+  {
+    uart_tx_pump();
+  }
   /* e.g. read a character from the EVAL_COM1 and Loop until RXNE = 1 */
   HAL_UART_Receive(&hcom_uart[COM1], (uint8_t *)&tmp, 1, HAL_TIMEOUT_VALUE);
 #else
@@ -124,31 +292,247 @@ uint32_t Serial_Scanf(uint32_t value)
 }
 
 /**
-  * @brief  Gets numeric values from the Hyperterminal.
-  * @param  Maximun value allowed (value)
-  * @retval The character received
+  * @brief  Gets a raw byte from the Hyperterminal, used by binary transfers.
+  * @param  data received byte
+  * @param  timeout_us time to wait for the byte in us
+  * @retval 0 if a byte is received, -1 on timeout
+  */
+int32_t Serial_GetByte(uint8_t *data, uint32_t timeout_us)
+{
+  UART_HandleTypeDef *huart_com = &hcom_uart[COM1];
+  uint64_t timeout = ddr_timer_timeout_init_us(timeout_us);
+
+  while (__HAL_UART_GET_FLAG(huart_com, UART_FLAG_RXFNE) == RESET)
+  {
+    if (ddr_timer_timeout_elapsed(timeout))
+    {
+      return -1;
+    }
+
+    /* The answers of the protocol are sent from the TX buffer */
+    if (uart_tx_ready)
+    {
+      uart_tx_pump();
+    }
+  }
+
+  *data = (uint8_t)READ_REG(huart_com->Instance->RDR);
+  __HAL_UART_CLEAR_FLAG(huart_com, UART_CLEAR_OREF | UART_CLEAR_FEF | UART_CLEAR_NEF);
+
+  return 0;
+}
+
+/**
+  * @brief  Sends a character to the Hyperterminal.
+  *         The character is queued in the TX buffer.
+  * @param  value character to send
+  * @retval None
   */
 void Serial_Putchar(char value)
 {
 #ifndef __TERMINAL_IO__
-  /* e.g. read a character from the EVAL_COM1 and Loop until RXNE = 1 */
-  HAL_UART_Transmit(&hcom_uart[COM1], (uint8_t *)&value, 1, HAL_TIMEOUT_VALUE);
+  if (!uart_tx_ready)
+  {
+    HAL_UART_Transmit(&hcom_uart[COM1], (uint8_t *)&value, 1, HAL_TIMEOUT_VALUE);
+    return;
+  }
+
+  uart_tx_write((const uint8_t *)&value, 1U);
 #endif
 }
 
 /**
-  * @brief  Gets numeric values from the Hyperterminal.
-  * @param  Maximun value allowed (value)
-  * @retval The character received
+  * @brief  Sends a string to the Hyperterminal.
+  *         The characters are queued in the TX buffer.
+  * @param  value characters to send
+  * @param  len number of characters
+  * @retval None
   */
 void Serial_Printf(char *value, int len)
 {
 #ifndef __TERMINAL_IO__
-  /* e.g. read a character from the EVAL_COM1 and Loop until RXNE = 1 */
-  HAL_UART_Transmit(&hcom_uart[COM1], (uint8_t *)value, len, HAL_TIMEOUT_VALUE);
+  if (len <= 0)
+  {
+    return;
+  }
+
+  if (!uart_tx_ready)
+  {
+    HAL_UART_Transmit(&hcom_uart[COM1], (uint8_t *)value, len, HAL_TIMEOUT_VALUE);
+    return;
+  }
+
+  uart_tx_write((const uint8_t *)value, (uint32_t)len);
 #endif
 }
 
+/**
+  * @brief  Waits until all queued characters are sent on the UART line.
+  *         To be called before reset and on error paths.
+  * @param  None
+  * @retval None
+  */
+void Serial_Flush(void)
+{
+  uint64_t timeout;
+
+  if (!uart_tx_ready)
+  {
+    return;
+  }
+
+  timeout = ddr_timer_timeout_init_us(UART_TX_FLUSH_TIMEOUT_US);
+
+  while ((uart_tx_head != uart_tx_tail) ||
+         (__HAL_UART_GET_FLAG(&hcom_uart[COM1], UART_FLAG_TC) == RESET))
+  {
+    uart_tx_pump();
+
+    if (ddr_timer_timeout_elapsed(timeout))
+    {
+      break;
+    }
+  }
+}
+
+/**
+  * @brief  Program a new baud rate on the console UART, keeping the FIFO
+  *         configuration. The TX buffer must be empty.
+  * @param  baudrate new baud rate
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef uart_set_baudrate(uint32_t baudrate)
+{
+  UART_HandleTypeDef *huart_com = &hcom_uart[COM1];
+  uint32_t cr1 = READ_REG(huart_com->Instance->CR1);
+  uint32_t cr3 = READ_REG(huart_com->Instance->CR3);
+  uint16_t nb_tx = huart_com->NbTxDataToProcess;
+  uint16_t nb_rx = huart_com->NbRxDataToProcess;
+  HAL_StatusTypeDef status;
+
+  __HAL_UART_DISABLE(huart_com);
+
+  huart_com->Init.BaudRate = baudrate;
+  status = UART_SetConfig(huart_com);
+
+  /* UART_SetConfig() resets the FIFO mode and thresholds */
+  MODIFY_REG(huart_com->Instance->CR1, USART_CR1_FIFOEN, cr1 & USART_CR1_FIFOEN);
+  MODIFY_REG(huart_com->Instance->CR3, USART_CR3_TXFTCFG | USART_CR3_RXFTCFG,
+             cr3 & (USART_CR3_TXFTCFG | USART_CR3_RXFTCFG));
+  huart_com->NbTxDataToProcess = nb_tx;
+  huart_com->NbRxDataToProcess = nb_rx;
+
+  __HAL_UART_ENABLE(huart_com);
+
+  /* Drop what was received during the switch */
+  __HAL_UART_SEND_REQ(huart_com, UART_RXDATA_FLUSH_REQUEST);
+  __HAL_UART_CLEAR_FLAG(huart_com, UART_CLEAR_OREF | UART_CLEAR_FEF | UART_CLEAR_NEF);
+
+  return status;
+}
+
+/**
+  * @brief  Gets the console baud rate.
+  * @param  None
+  * @retval baud rate
+  */
+uint32_t Serial_GetBaudrate(void)
+{
+  return hcom_uart[COM1].Init.BaudRate;
+}
+
+/**
+  * @brief  Switches the console to a new baud rate.
+  *         Once switched, the host has to send SERIAL_BAUD_SYNC at the new
+  *         baud rate within the timeout, otherwise the previous baud rate is
+  *         restored.
+  * @param  baudrate new baud rate
+  * @param  timeout_ms confirmation timeout in ms
+  * @retval 0 if switched, -1 if not supported, -2 if not confirmed
+  */
+int32_t Serial_SetBaudrate(uint32_t baudrate, uint32_t timeout_ms)
+{
+  UART_HandleTypeDef *huart_com = &hcom_uart[COM1];
+  const char *sync = SERIAL_BAUD_SYNC;
+  uint32_t prev_baudrate = huart_com->Init.BaudRate;
+  uint32_t match = 0U;
+  uint64_t timeout;
+  uint8_t data;
+
+  if (!uart_tx_ready)
+  {
+    return -1;
+  }
+
+  Serial_Flush();
+
+  if (uart_set_baudrate(baudrate) != HAL_OK)
+  {
+    (void)uart_set_baudrate(prev_baudrate);
+    return -1;
+  }
+
+  /* Let the host reconfigure its side, then wait for the confirmation */
+  ddr_timer_delay_us(UART_BAUD_SETTLE_US);
+  __HAL_UART_SEND_REQ(huart_com, UART_RXDATA_FLUSH_REQUEST);
+
+  timeout = ddr_timer_timeout_init_us(timeout_ms * 1000U);
+
+  while (sync[match] != '\0')
+  {
+    if (ddr_timer_timeout_elapsed(timeout))
+    {
+      (void)uart_set_baudrate(prev_baudrate);
+      return -2;
+    }
+
+    if (__HAL_UART_GET_FLAG(huart_com, UART_FLAG_RXFNE) == RESET)
+    {
+      continue;
+    }
+
+    data = (uint8_t)READ_REG(huart_com->Instance->RDR);
+    __HAL_UART_CLEAR_FLAG(huart_com, UART_CLEAR_OREF | UART_CLEAR_FEF | UART_CLEAR_NEF);
+
+    /* Resynchronize on any unexpected character */
+    if (data == (uint8_t)sync[match])
+    {
+      match++;
+    }
+    else
+    {
+      match = (data == (uint8_t)sync[0]) ? 1U : 0U;
+    }
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Console UART interrupt handler, feeds the TX FIFO from the TX
+  *         buffer.
+  * @param  None
+  * @retval None
+  */
+void Serial_IRQHandler(void)
+{
+  uart_tx_fill();
+}
+
+/**
+  * @brief  Called by the DDR HAL while waiting for the training firmware.
+  *         Used to keep the console output going.
+  * @param  None
+  * @retval None
+  */
+void HAL_DDR_TrainingIdleCallback(void)
+{
+  if (uart_tx_ready)
+  {
+    uart_tx_pump();
+  }
+}
+
 /**
   * @brief  This function is executed in case of error occurrence.
   * @param  None
@@ -161,22 +545,17 @@ void Error_Handler(void)
   BSP_LED_Off(LED2);
 
   /* User may add here some code to deal with this error */
+  Serial_Flush();
   while(1)
   {
     HAL_Delay(5000);
     printf("\n\r Error Handler \n\r");
     log_dbg("\n\r Why is there an error? \n\r");
+    Serial_Flush();
   }
 }
 
 void valid_delay_us(unsigned long delay_us)
 {
-  __IO uint32_t wait_loop_index = 0U;
-
-  wait_loop_index = (delay_us * (SystemCoreClock / (1000000UL * 2UL)));
-
-  while(wait_loop_index != 0UL)
-  {
-    wait_loop_index--;
-  }
+  ddr_timer_delay_us((uint32_t)delay_us);
 }
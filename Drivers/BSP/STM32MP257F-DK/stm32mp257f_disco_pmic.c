@@ -20,6 +20,7 @@
 #include "stm32mp257f_disco.h"
 #include "stm32mp257f_disco_bus.h"
 #include "stm32mp257f_disco_pmic.h"
+#include "stm32mp2xx_hal_ddr_timer.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -333,14 +334,7 @@ uint32_t BSP_PMIC_DumpRegs(void)
 #ifdef __AARCH64__
 static void bsp_pmic_delay_us(uint64_t delay_us)
 {
-  __IO uint64_t wait_loop_index = 0U;
-
-  wait_loop_index = delay_us * (SystemCoreClock / (1000000UL * 2UL));
-
-  while(wait_loop_index != 0UL)
-  {
-    wait_loop_index--;
-  }
+  ddr_timer_delay_us((uint32_t)delay_us);
 }
 #endif /* __AARCH64__ */
 
@@ -374,7 +368,7 @@ uint32_t BSP_PMIC_DDR_Power_Init()
   }
 
 #ifdef __AARCH64__
-    bsp_pmic_delay_us(2UL);
+    bsp_pmic_delay_us(2000UL);
 #else /* __AARCH64__ */
   HAL_Delay(2);
 #endif /* __AARCH64__ */
@@ -386,7 +380,7 @@ uint32_t BSP_PMIC_DDR_Power_Init()
   }
 
 #ifdef __AARCH64__
-    bsp_pmic_delay_us(2UL);
+    bsp_pmic_delay_us(2000UL);
 #else /* __AARCH64__ */
   HAL_Delay(2);
 #endif /* __AARCH64__ */
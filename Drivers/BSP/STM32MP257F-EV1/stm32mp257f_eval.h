@@ -222,51 +222,61 @@ typedef struct
   #define COM_CA35_CLK_ENABLE()             __HAL_RCC_USART1_CLK_ENABLE()
   #define COM_CA35_CLK_DISABLE()            __HAL_RCC_USART1_CLK_DISABLE()
   #define COM_CA35_RIF_RES_NUM_UART         RESMGR_RIFSC_USART1_ID
+  #define COM_CA35_IRQn                     USART1_IRQn
 #elif (UTIL_UART_INSTANCE == UTIL_USART2)
   #define COM_CA35_UART                       USART2
   #define COM_CA35_CLK_ENABLE()             __HAL_RCC_USART2_CLK_ENABLE()
   #define COM_CA35_CLK_DISABLE()            __HAL_RCC_USART2_CLK_DISABLE()
   #define COM_CA35_RIF_RES_NUM_UART         RESMGR_RIFSC_USART2_ID
+  #define COM_CA35_IRQn                     USART2_IRQn
 #elif (UTIL_UART_INSTANCE == UTIL_USART3)
   #define COM_CA35_UART                       USART3
   #define COM_CA35_CLK_ENABLE()             __HAL_RCC_USART3_CLK_ENABLE()
   #define COM_CA35_CLK_DISABLE()            __HAL_RCC_USART3_CLK_DISABLE()
   #define COM_CA35_RIF_RES_NUM_UART         RESMGR_RIFSC_USART3_ID
+  #define COM_CA35_IRQn                     USART3_IRQn
 #elif (UTIL_UART_INSTANCE == UTIL_UART4)
   #define COM_CA35_UART                       UART4
   #define COM_CA35_CLK_ENABLE()             __HAL_RCC_UART4_CLK_ENABLE()
   #define COM_CA35_CLK_DISABLE()            __HAL_RCC_UART4_CLK_DISABLE()
   #define COM_CA35_RIF_RES_NUM_UART         RESMGR_RIFSC_UART4_ID
+  #define COM_CA35_IRQn                     UART4_IRQn
 #elif (UTIL_UART_INSTANCE == UTIL_UART5)
   #define COM_CA35_UART                       UART5
   #define COM_CA35_CLK_ENABLE()             __HAL_RCC_UART5_CLK_ENABLE()
   #define COM_CA35_CLK_DISABLE()            __HAL_RCC_UART5_CLK_DISABLE()
   #define COM_CA35_RIF_RES_NUM_UART         RESMGR_RIFSC_UART5_ID
+  #define COM_CA35_IRQn                     UART5_IRQn
 #elif (UTIL_UART_INSTANCE == UTIL_USART6)
   #define COM_CA35_UART                       USART6
   #define COM_CA35_CLK_ENABLE()             __HAL_RCC_USART6_CLK_ENABLE()
   #define COM_CA35_CLK_DISABLE()            __HAL_RCC_USART6_CLK_DISABLE()
   #define COM_CA35_RIF_RES_NUM_UART         RESMGR_RIFSC_USART6_ID
+  #define COM_CA35_IRQn                     USART6_IRQn
 #elif (UTIL_UART_INSTANCE == UTIL_UART7)
   #define COM_CA35_UART                       UART7
   #define COM_CA35_CLK_ENABLE()             __HAL_RCC_UART7_CLK_ENABLE()
   #define COM_CA35_CLK_DISABLE()            __HAL_RCC_UART7_CLK_DISABLE()
   #define COM_CA35_RIF_RES_NUM_UART         RESMGR_RIFSC_UART7_ID
+  #define COM_CA35_IRQn                     UART7_IRQn
 #elif (UTIL_UART_INSTANCE == UTIL_UART8)
   #define COM_CA35_UART                       UART8
   #define COM_CA35_CLK_ENABLE()             __HAL_RCC_UART8_CLK_ENABLE()
   #define COM_CA35_CLK_DISABLE()            __HAL_RCC_UART8_CLK_DISABLE()
   #define COM_CA35_RIF_RES_NUM_UART         RESMGR_RIFSC_UART8_ID
+  #define COM_CA35_IRQn                     UART8_IRQn
 #elif (UTIL_UART_INSTANCE == UTIL_UART9)
   #define COM_CA35_UART                       UART9
   #define COM_CA35_CLK_ENABLE()             __HAL_RCC_UART9_CLK_ENABLE()
   #define COM_CA35_CLK_DISABLE()            __HAL_RCC_UART9_CLK_DISABLE()
   #define COM_CA35_RIF_RES_NUM_UART         RESMGR_RIFSC_UART9_ID
+  #define COM_CA35_IRQn                     UART9_IRQn
 #elif (UTIL_UART_INSTANCE == UTIL_LPUART1)
   #define COM_CA35_UART                       LPUART1
   #define COM_CA35_CLK_ENABLE()             __HAL_RCC_LPUART1_CLK_ENABLE()
   #define COM_CA35_CLK_DISABLE()            __HAL_RCC_LPUART1_CLK_DISABLE()
   #define COM_CA35_RIF_RES_NUM_UART         RESMGR_RIFSC_LPUART1_ID
+  #define COM_CA35_IRQn                     LPUART1_IRQn
 #else
   #error "unknown UTIL_UART_INSTANCE definition."
 #endif
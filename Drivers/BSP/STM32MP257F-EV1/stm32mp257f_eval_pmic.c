@@ -20,6 +20,7 @@
 #include "stm32mp257f_eval.h"
 #include "stm32mp257f_eval_bus.h"
 #include "stm32mp257f_eval_pmic.h"
+#include "stm32mp2xx_hal_ddr_timer.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -55,6 +56,18 @@
 /* Private define ------------------------------------------------------------*/
 #define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
 
+/* BUCK VOUT[6:0]: 500mV + 10mV steps up to 1500mV */
+#define BUCK_VOLT_MIN_MV     500U
+#define BUCK_VOLT_STEP_MV    10U
+#define BUCK_VOLT_MASK       0x7FU
+/* LDO VOUT[4:0]: 900mV + 100mV steps */
+#define LDO_VOLT_MIN_MV      900U
+#define LDO_VOLT_STEP_MV     100U
+#define LDO_VOLT_MASK        (0x1FU << LDO_VOLT_SHIFT)
+
+/* Settling time after a DDR rail voltage change */
+#define DDR_VOLT_SETTLE_US   1000UL
+
 
 /**
   * @}
@@ -112,14 +125,14 @@ board_regul_struct_t board_regulators_table[] =
     "VDD3V3_USB",  VDD3V3_USB,  STPMIC_LDO4,   LDO4_MAIN_CR,    LDO4_MAIN_CR,    \
     LDO4_ALT_CR,    LDO4_ALT_CR,    LDO4_PWRCTRL_CR,   3300, 3300
   },
-  {
-    "VDD2_DDR",    VDD2_DDR,    STPMIC_BUCK6,  BUCK6_MAIN_CR1,  BUCK6_MAIN_CR2,  BUCK6_ALT_CR1,
-    BUCK6_ALT_CR2, BUCK6_PWRCTRL_CR,  1100, 1100
-  },
   {
     "VDD1_DDR",    VDD1_DDR,    STPMIC_LDO3,   LDO3_MAIN_CR,    LDO3_MAIN_CR,    LDO3_ALT_CR,
     LDO3_ALT_CR, LDO3_PWRCTRL_CR,   0000, 0000
   },
+  {
+    "VDD2_DDR",    VDD2_DDR,    STPMIC_BUCK6,  BUCK6_MAIN_CR1,  BUCK6_MAIN_CR2,  BUCK6_ALT_CR1,
+    BUCK6_ALT_CR2, BUCK6_PWRCTRL_CR,  1100, 1100
+  },
   {
     "V3V3",        V3V3,        STPMIC_BUCK7,  BUCK7_MAIN_CR1,  BUCK7_MAIN_CR2,  \
     BUCK7_ALT_CR1,  BUCK7_ALT_CR2,  BUCK7_PWRCTRL_CR,  3300, 3300
@@ -315,14 +328,7 @@ uint32_t BSP_PMIC_DumpRegs(void)
 #ifdef __AARCH64__
 static void bsp_pmic_delay_us(uint64_t delay_us)
 {
-  __IO uint64_t wait_loop_index = 0U;
-
-  wait_loop_index = delay_us * (SystemCoreClock / (1000000UL * 2UL));
-
-  while(wait_loop_index != 0UL)
-  {
-    wait_loop_index--;
-  }
+  ddr_timer_delay_us((uint32_t)delay_us);
 }
 #endif /* __AARCH64__ */
 
@@ -335,6 +341,9 @@ static void bsp_pmic_delay_us(uint64_t delay_us)
  * wait 2ms
  * enable VREF_DDR, VTT_DDR, VPP_DDR
  *
+ * The rail voltages are only programmed for LPDDR4, the other DDR types use
+ * the PMIC NVM values.
+ *
  * @param  None
  * @retval status
  *
@@ -344,6 +353,7 @@ uint32_t BSP_PMIC_DDR_Power_Init()
 {
   uint32_t  status = BSP_ERROR_NONE;
 
+#if STM32MP_LPDDR4_TYPE
   /* VDD2_DDR ==> BUCK6 ==> 1100mV */
   if (BSP_PMIC_WriteReg(board_regulators_table[VDD2_DDR].control_reg1, 0x3C) != BSP_ERROR_NONE)
   {
@@ -355,9 +365,10 @@ uint32_t BSP_PMIC_DDR_Power_Init()
   {
     return BSP_ERROR_PMIC;
   }
+#endif /* STM32MP_LPDDR4_TYPE */
 
 #ifdef __AARCH64__
-  bsp_pmic_delay_us(2UL);
+  bsp_pmic_delay_us(2000UL);
 #else /* __AARCH64__ */
   HAL_Delay(2);
 #endif /* __AARCH64__ */
@@ -369,13 +380,13 @@ uint32_t BSP_PMIC_DDR_Power_Init()
   }
 
 #ifdef __AARCH64__
-    bsp_pmic_delay_us(2UL);
+    bsp_pmic_delay_us(2000UL);
 #else /* __AARCH64__ */
   HAL_Delay(2);
 #endif /* __AARCH64__ */
 
   /* enable vdd2_ddr (1100mV) ==> BUCK6 */
-  if (BSP_PMIC_UpdateReg(board_regulators_table[VDD2_DDR].control_reg2, 0x1 != BSP_ERROR_NONE))
+  if (BSP_PMIC_UpdateReg(board_regulators_table[VDD2_DDR].control_reg2, 0x1) != BSP_ERROR_NONE)
   {
     return BSP_ERROR_PMIC;
   }
@@ -526,6 +537,123 @@ uint32_t BSP_PMIC_DDR_Power_Off()
   return status;
 }
 
+/*
+ *
+ * @brief BSP_PMIC_DDR_Get_Voltage read the voltage of a DDR rail
+ *
+ * @param  regu VDD1_DDR (LDO3) or VDD2_DDR (BUCK6)
+ * @param  mv voltage in mV
+ * @retval status
+ *
+ */
+uint32_t BSP_PMIC_DDR_Get_Voltage(board_regul_t regu, uint32_t *mv)
+{
+  uint8_t data;
+
+  if ((regu != VDD1_DDR) && (regu != VDD2_DDR))
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  if (BSP_PMIC_ReadReg(board_regulators_table[regu].control_reg1, &data) != BSP_ERROR_NONE)
+  {
+    return BSP_ERROR_PMIC;
+  }
+
+  if (regu == VDD2_DDR)
+  {
+    *mv = BUCK_VOLT_MIN_MV + ((data & BUCK_VOLT_MASK) * BUCK_VOLT_STEP_MV);
+  }
+  else
+  {
+    *mv = LDO_VOLT_MIN_MV + (((data & LDO_VOLT_MASK) >> LDO_VOLT_SHIFT) * LDO_VOLT_STEP_MV);
+  }
+
+  return BSP_ERROR_NONE;
+}
+
+/*
+ *
+ * @brief BSP_PMIC_DDR_Set_Voltage set the voltage of a DDR rail, for the
+ *        margining, within the BSP_PMIC_VDDx_DDR_MARGIN limits of the DDR
+ *        type (no margining for a rail with a 0 limit)
+ *
+ * The other bits of the control register are kept (enable, LDO3 mode); the
+ * LDO3 in sink/source mode (VTT) is not supported.
+ *
+ * @param  regu VDD1_DDR (LDO3) or VDD2_DDR (BUCK6)
+ * @param  mv voltage in mV, multiple of the regulator step
+ * @retval status
+ *
+ */
+uint32_t BSP_PMIC_DDR_Set_Voltage(board_regul_t regu, uint32_t mv)
+{
+  uint8_t data;
+  uint32_t mv_min;
+  uint32_t mv_max;
+  uint32_t mv_step;
+
+  if (regu == VDD2_DDR)
+  {
+    mv_min = BSP_PMIC_VDD2_DDR_MARGIN_MIN;
+    mv_max = BSP_PMIC_VDD2_DDR_MARGIN_MAX;
+    mv_step = BUCK_VOLT_STEP_MV;
+  }
+  else if (regu == VDD1_DDR)
+  {
+    mv_min = BSP_PMIC_VDD1_DDR_MARGIN_MIN;
+    mv_max = BSP_PMIC_VDD1_DDR_MARGIN_MAX;
+    mv_step = LDO_VOLT_STEP_MV;
+  }
+  else
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  if (mv_max == 0U)
+  {
+    return BSP_ERROR_FEATURE_NOT_SUPPORTED;
+  }
+
+  if ((mv < mv_min) || (mv > mv_max) || ((mv % mv_step) != 0U))
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  if (BSP_PMIC_ReadReg(board_regulators_table[regu].control_reg1, &data) != BSP_ERROR_NONE)
+  {
+    return BSP_ERROR_PMIC;
+  }
+
+  if (regu == VDD2_DDR)
+  {
+    data &= ~BUCK_VOLT_MASK;
+    data |= (uint8_t)((mv - BUCK_VOLT_MIN_MV) / BUCK_VOLT_STEP_MV);
+  }
+  else
+  {
+    if ((data & LDO3_SNK_SRC) != 0U)
+    {
+      return BSP_ERROR_WRONG_PARAM;
+    }
+    data &= ~LDO_VOLT_MASK;
+    data |= (uint8_t)(((mv - LDO_VOLT_MIN_MV) / LDO_VOLT_STEP_MV) << LDO_VOLT_SHIFT);
+  }
+
+  if (BSP_PMIC_WriteReg(board_regulators_table[regu].control_reg1, data) != BSP_ERROR_NONE)
+  {
+    return BSP_ERROR_PMIC;
+  }
+
+#ifdef __AARCH64__
+  bsp_pmic_delay_us(DDR_VOLT_SETTLE_US);
+#else /* __AARCH64__ */
+  HAL_Delay(DDR_VOLT_SETTLE_US / 1000UL);
+#endif /* __AARCH64__ */
+
+  return BSP_ERROR_NONE;
+}
+
 /**
   * @brief  BSP_PMIC_Set_Power_Mode Set PMIC run/low power mode
   * @param  mode  mode to set
@@ -241,6 +241,28 @@ typedef struct
 #define  STPMIC2_STANDBY_DDR_SR       0x6U /*  */
 #define  STPMIC2_STANDBY_DDR_OFF      0x7U /*  */
 
+/*
+ * DDR rails margining limits in mV, 0 when the rail is not margined
+ * LPDDR4: VDD2 1.06-1.17V, VDD1 1.70-1.95V
+ * DDR4: VDD 1.14-1.26V on VDD2_DDR
+ */
+#if STM32MP_LPDDR4_TYPE
+#define BSP_PMIC_VDD2_DDR_MARGIN_MIN  1000U
+#define BSP_PMIC_VDD2_DDR_MARGIN_MAX  1200U
+#define BSP_PMIC_VDD1_DDR_MARGIN_MIN  1700U
+#define BSP_PMIC_VDD1_DDR_MARGIN_MAX  1900U
+#elif STM32MP_DDR4_TYPE
+#define BSP_PMIC_VDD2_DDR_MARGIN_MIN  1100U
+#define BSP_PMIC_VDD2_DDR_MARGIN_MAX  1300U
+#define BSP_PMIC_VDD1_DDR_MARGIN_MIN  0U
+#define BSP_PMIC_VDD1_DDR_MARGIN_MAX  0U
+#else /* STM32MP_LPDDR4_TYPE */
+#define BSP_PMIC_VDD2_DDR_MARGIN_MIN  0U
+#define BSP_PMIC_VDD2_DDR_MARGIN_MAX  0U
+#define BSP_PMIC_VDD1_DDR_MARGIN_MIN  0U
+#define BSP_PMIC_VDD1_DDR_MARGIN_MAX  0U
+#endif /* STM32MP_LPDDR4_TYPE */
+
 
 /**
   * @}
@@ -283,6 +305,8 @@ uint32_t BSP_PMIC_DumpRegs(void);
 #endif /* defined (STPMIC2_DEBUG) */
 uint32_t BSP_PMIC_Power_Mode_Init(void);
 uint32_t BSP_PMIC_DDR_Power_Off(void);
+uint32_t BSP_PMIC_DDR_Get_Voltage(board_regul_t regu, uint32_t *mv);
+uint32_t BSP_PMIC_DDR_Set_Voltage(board_regul_t regu, uint32_t mv);
 uint32_t BSP_PMIC_REGU_Set_Off(board_regul_t regu);
 uint32_t BSP_PMIC_REGU_Set_On(board_regul_t regu);
 uint32_t BSP_PMIC_Set_Power_Mode(uint32_t mode);
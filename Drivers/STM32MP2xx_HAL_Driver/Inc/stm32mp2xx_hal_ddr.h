@@ -335,6 +335,12 @@ typedef enum
   STEP_DDR_READY,
   STEP_RUN,
 } HAL_DDR_InteractStepTypeDef;
+
+/* Register snapshot slots: one per interactive step, then */
+#define HAL_DDR_SNAPSHOT_USER   ((uint32_t)STEP_RUN)        /* user request */
+#define HAL_DDR_SNAPSHOT_NOW    ((uint32_t)STEP_RUN + 1U)   /* taken on diff */
+#define HAL_DDR_SNAPSHOT_NB     ((uint32_t)STEP_RUN + 2U)
+#define HAL_DDR_SNAPSHOT_CONFIG 0xFFU                       /* static config */
 #endif /* DDR_INTERACTIVE */
 
 /**
@@ -401,6 +407,7 @@ HAL_StatusTypeDef HAL_DDR_SR_Exit(void);
 HAL_StatusTypeDef HAL_DDR_SR_SetMode(HAL_DDR_SelfRefreshModeTypeDef mode);
 HAL_DDR_SelfRefreshModeTypeDef HAL_DDR_SR_ReadMode(void);
 HAL_StatusTypeDef HAL_DDR_SetRetentionAreaBase(uint64_t base);
+void HAL_DDR_TrainingIdleCallback(void);
 
 #ifdef DDR_INTERACTIVE
 void HAL_DDR_Convert_Case(const char *in_str, char *out_str, bool ToUpper);
@@ -411,6 +418,14 @@ HAL_StatusTypeDef HAL_DDR_Dump_Reg(const char *name, bool save);
 void HAL_DDR_Edit_Param(HAL_DDR_ConfigTypeDef *config, char *name,
                         char *string);
 void HAL_DDR_Edit_Reg(char *name, char *string);
+HAL_StatusTypeDef HAL_DDR_Read_Reg(const char *name, uint32_t *value);
+HAL_StatusTypeDef HAL_DDR_Write_Reg(const char *name, uint32_t value);
+void HAL_DDR_DumpRegCallback(const char *name, uint32_t value);
+HAL_StatusTypeDef HAL_DDR_Snapshot_Take(uint32_t slot);
+HAL_StatusTypeDef HAL_DDR_Snapshot_Info(uint32_t slot, uint32_t *tick);
+HAL_StatusTypeDef HAL_DDR_Snapshot_Diff(uint32_t from, uint32_t to);
+HAL_StatusTypeDef HAL_DDR_Snapshot_Export(void (*write)(const void *data,
+                                                        uint32_t len));
 #endif /* DDR_INTERACTIVE */
 
 /**
@@ -187,6 +187,12 @@ int32_t ddrphy_phyinit_isdbytedisabled(int32_t dbytenumber);
 int32_t ddrphy_phyinit_setretreglistbase(uintptr_t base);
 int32_t ddrphy_phyinit_trackreg(uint32_t adr);
 int32_t ddrphy_phyinit_reginterface(reginstr myreginstr, uint32_t adr, uint16_t dat);
+void ddrphy_phyinit_csrshadow_reset(void);
+void ddrphy_phyinit_csrshadow_enable(bool enable);
+void mmio_write_16_shadow(uintptr_t addr, uint16_t value);
+int32_t ddrphy_phyinit_csrshadow_read(uint32_t csr_addr, uint16_t *value);
+int32_t ddrphy_phyinit_csrshadow_getentry(uint32_t index, uint32_t *csr_addr, uint16_t *value);
+void ddrphy_phyinit_csrshadow_getstats(uint32_t *issued, uint32_t *elided);
 
 extern void ddrphy_phyinit_usercustom_pretrain(void);
 extern void ddrphy_phyinit_usercustom_posttrain(void);
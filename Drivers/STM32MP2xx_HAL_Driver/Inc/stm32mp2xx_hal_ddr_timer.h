@@ -0,0 +1,170 @@
+/**
+  ******************************************************************************
+  * @file    stm32mp2xx_hal_ddr_timer.h
+  * @author  MCD Application Team
+  * @brief   Header file of DDR HAL time services.
+  *          Microsecond delays and deadline based timeouts built on the
+  *          STGEN system counter (CNTPCT_EL0 on Cortex-A35 AArch64).
+  *          STGEN must be running before any of these services is used.
+  *          The host build (DDR_HOST_SIM) counts microseconds of the host
+  *          monotonic clock instead.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2020 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef STM32MP2xx_HAL_DDR_TIMER_H
+#define STM32MP2xx_HAL_DDR_TIMER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "stm32mp2xx_hal.h"
+#if defined(DDR_HOST_SIM)
+#include <time.h>
+#endif /* DDR_HOST_SIM */
+
+/* Exported constants --------------------------------------------------------*/
+#ifdef USE_STM32MP257CXX_EMU
+#define DDR_TIMER_EMU_FACTOR 10U
+#else /* USE_STM32MP257CXX_EMU */
+#define DDR_TIMER_EMU_FACTOR 1U
+#endif /* USE_STM32MP257CXX_EMU */
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Read the system counter
+  * @param  None
+  * @retval 64-bit counter value
+  */
+static inline uint64_t ddr_timer_get_count(void)
+{
+  uint64_t cnt;
+
+#if defined(DDR_HOST_SIM)
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+  cnt = ((uint64_t)ts.tv_sec * 1000000U) + ((uint64_t)ts.tv_nsec / 1000U);
+#elif defined(__AARCH64__)
+  __asm volatile("isb\n\tmrs %0, cntpct_el0" : "=r" (cnt) : : "memory");
+#else /* __AARCH64__ */
+  uint32_t cnt_h;
+  uint32_t cnt_l;
+
+  do
+  {
+    cnt_h = READ_REG(STGENR->CNTCVU);
+    cnt_l = READ_REG(STGENR->CNTCVL);
+  } while (cnt_h != READ_REG(STGENR->CNTCVU));
+
+  cnt = ((uint64_t)cnt_h << 32) | cnt_l;
+#endif /* DDR_HOST_SIM */
+
+  return cnt;
+}
+
+/**
+  * @brief  Get the system counter frequency
+  * @param  None
+  * @retval frequency in Hz
+  */
+static inline uint32_t ddr_timer_get_freq(void)
+{
+  uint64_t freq;
+
+#if defined(DDR_HOST_SIM)
+  freq = 1000000U;
+#elif defined(__AARCH64__)
+  __asm volatile("mrs %0, cntfrq_el0" : "=r" (freq));
+#elif defined(CORE_CA35)
+  freq = READ_REG(STGENC->CNTFID0);
+#else /* CORE_CA35 */
+  /* STGENC is not visible from M33, STGEN assumed to run on HSI */
+  freq = HSI_VALUE;
+#endif /* DDR_HOST_SIM */
+
+  return (uint32_t)freq;
+}
+
+/**
+  * @brief  Convert a duration in us into system counter ticks
+  * @param  time_us duration in us
+  * @retval number of ticks, rounded up
+  */
+static inline uint64_t ddr_timer_us_to_ticks(uint32_t time_us)
+{
+  return (((uint64_t)time_us * DDR_TIMER_EMU_FACTOR * ddr_timer_get_freq()) +
+          999999U) / 1000000U;
+}
+
+/**
+  * @brief  Initialize a timeout
+  * @param  timeout_us timeout in us
+  * @retval deadline, to be checked with ddr_timer_timeout_elapsed()
+  */
+static inline uint64_t ddr_timer_timeout_init_us(uint32_t timeout_us)
+{
+  return ddr_timer_get_count() + ddr_timer_us_to_ticks(timeout_us);
+}
+
+/**
+  * @brief  Check if a timeout has expired
+  * @param  deadline value returned by ddr_timer_timeout_init_us()
+  * @retval true if the deadline is reached
+  */
+static inline bool ddr_timer_timeout_elapsed(uint64_t deadline)
+{
+  return ddr_timer_get_count() >= deadline;
+}
+
+/**
+  * @brief  Wait a delay expressed in us
+  * @param  delay_us delay in us
+  * @retval None
+  */
+static inline void ddr_timer_delay_us(uint32_t delay_us)
+{
+  uint64_t deadline = ddr_timer_timeout_init_us(delay_us);
+
+  while (!ddr_timer_timeout_elapsed(deadline))
+  {
+  }
+}
+
+/**
+  * @brief  Get the time elapsed since a system counter value
+  * @param  start counter value returned by ddr_timer_get_count()
+  * @retval elapsed time in us
+  */
+static inline uint32_t ddr_timer_elapsed_us(uint64_t start)
+{
+  uint32_t freq = ddr_timer_get_freq();
+
+  if (freq == 0U)
+  {
+    return 0U;
+  }
+
+  return (uint32_t)(((ddr_timer_get_count() - start) * 1000000U) / freq);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32MP2xx_HAL_DDR_TIMER_H */
@@ -36,12 +36,16 @@
 #include <stdlib.h>
 #endif /* DDR_INTERACTIVE */
 #include <string.h>
+#ifdef DDR_INTERACTIVE
+#include <strings.h>
+#endif /* DDR_INTERACTIVE */
 #include <stdio.h>
 #include "stm32mp2xx_hal.h"
 
 #ifdef HAL_DDR_MODULE_ENABLED
 
 #include "stm32mp2xx_hal_ddr_ddrphy_phyinit.h"
+#include "stm32mp2xx_hal_ddr_timer.h"
 
 #ifdef DDR_INTERACTIVE
   #include "stm32mp_util_conf.h"
@@ -1084,6 +1088,20 @@ __weak int32_t HAL_DDR_MspInit(__unused ddr_type type)
   return 0;
 }
 
+/**
+  * @brief  Called while the PHY training firmware runs, between two mailbox
+  *         polls (weak here).
+  *         The application may use this time for its own work (buffer
+  *         initialization, next configuration preparation...), split in
+  *         short chunks: each call delays the handling of the next firmware
+  *         message, hence the training duration.
+  * @param  None
+  * @retval None
+  */
+__weak void HAL_DDR_TrainingIdleCallback(void)
+{
+}
+
 /**
   * @brief  This function tests a simple read/write access to the DDR.
   *         Note that the previous content is restored after test.
@@ -1230,60 +1248,6 @@ static uintptr_t ddr_check_size(void)
   return offset;
 }
 
-/**
-  * @brief  Wait a delay expressed in us
-  * @param  delay_us delay in us
-  * @retval None
-  */
-static void ddr_delay_us(uint32_t delay_us)
-{
-  __IO uint32_t wait_loop_index = 0U;
-
-  wait_loop_index = (delay_us * (SystemCoreClock / (1000000UL * 2UL)));
-
-#ifdef USE_STM32MP257CXX_EMU
-  wait_loop_index *= 10U;
-#endif /* USE_STM32MP257CXX_EMU */
-
-  while (wait_loop_index != 0UL)
-  {
-    wait_loop_index--;
-  }
-}
-
-/**
-  * @brief  Initialize DDR timeout in us
-  * @param  timeout_us timeout in us
-  * @retval wait_loop_index
-  */
-static __IO uint32_t ddr_timeout_init_us(uint32_t timeout_us)
-{
-  __IO uint32_t wait_loop_index = 0U;
-
-  wait_loop_index = timeout_us * (SystemCoreClock / (1000000UL * 2UL));
-
-#ifdef USE_STM32MP257CXX_EMU
-  wait_loop_index *= 10U;
-#endif /* USE_STM32MP257CXX_EMU */
-
-  return wait_loop_index;
-}
-
-/**
-  * @brief  Check if timeout has expired
-  * @param  timeout timeout in us
-  * @retval Timeout status
-  */
-static bool ddr_timeout_elapsed(__IO uint32_t timeout)
-{
-  if (timeout == 0U)
-  {
-    return true;
-  }
-
-  return false;
-}
-
 /**
   * @brief  Start quasi dynamic register update
   * @param  None
@@ -1302,7 +1266,7 @@ static void start_sw_done(void)
 static int32_t wait_sw_done_ack(void)
 {
   uint32_t swstat;
-  __IO uint32_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_1_US);
+  uint64_t timeout = ddr_timer_timeout_init_us(DDR_TIMEOUT_500_US);
 
   SET_BIT(DDRC->SWCTL, DDRC_SWCTL_SW_DONE);
 
@@ -1310,8 +1274,7 @@ static int32_t wait_sw_done_ack(void)
   {
     swstat = READ_REG(DDRC->SWSTAT);
 
-    timeout--;
-    if (ddr_timeout_elapsed(timeout))
+    if (ddr_timer_timeout_elapsed(timeout))
     {
       /* Timeout initialising DRAM */
       return -1;
@@ -1345,7 +1308,7 @@ static void enable_axi_port(void)
   */
 static int32_t disable_axi_port(void)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
 
   /* Disable uMCTL2 AXI port 0 */
   CLEAR_BIT(DDRC->PCTRL_0, DDRC_PCTRL_0_PORT_EN);
@@ -1359,11 +1322,10 @@ static int32_t disable_axi_port(void)
    * Poll PSTAT.rd_port_busy_n = 0
    * Poll PSTAT.wr_port_busy_n = 0
    */
-  timeout = ddr_timeout_init_us(DDR_TIMEOUT_US_1S);
+  timeout = ddr_timer_timeout_init_us(DDR_TIMEOUT_US_1S);
   while (READ_REG(DDRC->PSTAT) != 0U)
   {
-    timeout--;
-    if (ddr_timeout_elapsed(timeout))
+    if (ddr_timer_timeout_elapsed(timeout))
     {
       return -1;
     }
@@ -1400,7 +1362,7 @@ static void enable_host_interface(void)
   */
 static int32_t disable_host_interface(void)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
   uint32_t dbgcam;
   uint32_t count = 0U;
 
@@ -1416,13 +1378,12 @@ static int32_t disable_host_interface(void)
    * data_pipeline fields must be polled twice to ensure
    * value propoagation, so count is added to loop condition.
    */
-  timeout = ddr_timeout_init_us(DDR_TIMEOUT_US_1S);
+  timeout = ddr_timer_timeout_init_us(DDR_TIMEOUT_US_1S);
   do
   {
     dbgcam = READ_REG(DDRC->DBGCAM);
 
-    timeout--;
-    if (ddr_timeout_elapsed(timeout))
+    if (ddr_timer_timeout_elapsed(timeout))
     {
       return -1;
     }
@@ -1451,7 +1412,7 @@ static bool ddr_is_host_interface_enabled(void)
   */
 static int32_t sw_selfref_entry(void)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
   uint32_t stat;
   uint32_t operating_mode;
   uint32_t selref_type;
@@ -1465,14 +1426,13 @@ static int32_t sw_selfref_entry(void)
    * Ensure transition to self-refresh was due to software
    * by checking also that STAT.selfref_type[1:0]=2.
    */
-  timeout = ddr_timeout_init_us(DDR_TIMEOUT_500_US);
+  timeout = ddr_timer_timeout_init_us(DDR_TIMEOUT_500_US);
 
-  while (!ddr_timeout_elapsed(timeout))
+  while (!ddr_timer_timeout_elapsed(timeout))
   {
     stat = READ_REG(DDRC->STAT);
     operating_mode = stat & DDRC_STAT_OPERATING_MODE_Msk;
     selref_type = stat & DDRC_STAT_SELFREF_TYPE_Msk;
-    timeout--;
 
     if ((operating_mode == DDRC_STAT_OPERATING_MODE_SR)
         && (selref_type == DDRC_STAT_SELFREF_TYPE_SR))
@@ -1589,16 +1549,15 @@ static int32_t unset_qd1_qd3_update_conditions(void)
   */
 static int32_t wait_dfi_init_complete(void)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
   uint32_t dfistat;
 
-  timeout = ddr_timeout_init_us(DDR_TIMEOUT_US_1S);
+  timeout = ddr_timer_timeout_init_us(DDR_TIMEOUT_US_1S);
   do
   {
     dfistat = READ_REG(DDRC->DFISTAT);
 
-    timeout--;
-    if (ddr_timeout_elapsed(timeout))
+    if (ddr_timer_timeout_elapsed(timeout))
     {
       return -1;
     }
@@ -1614,20 +1573,19 @@ static int32_t wait_dfi_init_complete(void)
   */
 static int32_t disable_dfi_low_power_interface(void)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
   uint32_t dfistat;
   uint32_t stat;
 
   CLEAR_BIT(DDRC->DFILPCFG0, DDRC_DFILPCFG0_DFI_LP_EN_SR);
 
-  timeout = ddr_timeout_init_us(DDR_TIMEOUT_US_1S);
+  timeout = ddr_timer_timeout_init_us(DDR_TIMEOUT_US_1S);
   do
   {
     dfistat = READ_REG(DDRC->DFISTAT);
     stat = READ_REG(DDRC->STAT);
 
-    timeout--;
-    if (ddr_timeout_elapsed(timeout))
+    if (ddr_timer_timeout_elapsed(timeout))
     {
       return -1;
     }
@@ -1666,7 +1624,7 @@ static int32_t activate_controller(bool sr_entry)
     return -1;
   }
 
-  ddr_delay_us(DDR_DELAY_1_US);
+  ddr_timer_delay_us(DDR_DELAY_1_US);
 
   if (sr_entry)
   {
@@ -1677,7 +1635,7 @@ static int32_t activate_controller(bool sr_entry)
     SET_BIT(DDRC->DFIMISC, DDRC_DFIMISC_DFI_INIT_COMPLETE_EN);
   }
 
-  ddr_delay_us(DDR_DELAY_1_US);
+  ddr_timer_delay_us(DDR_DELAY_1_US);
 
   if (unset_qd1_qd3_update_conditions() != 0)
   {
@@ -1694,7 +1652,7 @@ static int32_t activate_controller(bool sr_entry)
   */
 static int32_t wait_lp3_mode(bool state)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
   uint16_t phyinlpx;
   bool repeat_loop = false;
 
@@ -1703,13 +1661,12 @@ static int32_t wait_lp3_mode(bool state)
   WRITE_REG(*(volatile uint32_t *)(DDRPHYC_BASE + DDRPHY_DRTUB0_UCCLKHCLKENABLES),
             DDRPHY_DRTUB0_UCCLKHCLKENABLES_UCCLKEN | DDRPHY_DRTUB0_UCCLKHCLKENABLES_HCLKEN);
 
-  timeout = ddr_timeout_init_us(DDR_TIMEOUT_US_1S);
+  timeout = ddr_timer_timeout_init_us(DDR_TIMEOUT_US_1S);
   do
   {
     phyinlpx = READ_REG(*(volatile uint32_t *)(DDRPHYC_BASE + DDRPHY_INITENG0_P0_PHYINLPX));
 
-    timeout--;
-    if (ddr_timeout_elapsed(timeout))
+    if (ddr_timer_timeout_elapsed(timeout))
     {
       return -1;
     }
@@ -1864,7 +1821,7 @@ static int32_t sr_loop(bool is_entry)
 #if STM32MP_LPDDR4_TYPE
   uint32_t state;
 #endif /* STM32MP_LPDDR4_TYPE */
-  __IO uint32_t timeout = ddr_timeout_init_us(DDR_TIMEOUT_1_US);
+  uint64_t timeout = ddr_timer_timeout_init_us(DDR_TIMEOUT_500_US);
   bool repeat_loop = false;
 
   /* Wait for DDRCTRL to be out of or back to "normal/mission mode" */
@@ -1875,8 +1832,7 @@ static int32_t sr_loop(bool is_entry)
     state = READ_REG(DDRC->STAT) & DDRC_STAT_SELFREF_STATE_Msk;
 #endif /* STM32MP_LPDDR4_TYPE */
 
-    timeout--;
-    if (ddr_timeout_elapsed(timeout))
+    if (ddr_timer_timeout_elapsed(timeout))
     {
       return -1;
     }
@@ -2015,7 +1971,7 @@ static int32_t sr_ssr_exit(void)
   CLEAR_BIT(RCC->DDRITFCFGR, RCC_DDRITFCFGR_DDRPHYDLP);
   SET_BIT(RCC->DDRPHYCCFGR, RCC_DDRPHYCCFGR_DDRPHYCEN);
 
-  ddr_delay_us(DDR_DELAY_1_US);
+  ddr_timer_delay_us(DDR_DELAY_1_US);
 
   if (activate_controller(false) != 0)
   {
@@ -2210,7 +2166,7 @@ static int32_t sr_hsr_set(void)
   */
 static void ddr_reset(void)
 {
-  ddr_delay_us(DDR_DELAY_1_US);
+  ddr_timer_delay_us(DDR_DELAY_1_US);
 
 #ifdef DDR_INTERACTIVE
   WRITE_REG(RCC->DDRCPCFGR, RCC_DDRCPCFGR_DDRCPEN | RCC_DDRCPCFGR_DDRCPLPEN |
@@ -2226,7 +2182,7 @@ static void ddr_reset(void)
   WRITE_REG(RCC->DDRCFGR, RCC_DDRCFGR_DDRCFGEN | RCC_DDRCFGR_DDRCFGLPEN |
                           RCC_DDRCFGR_DDRCFGRST);
 
-  ddr_delay_us(DDR_DELAY_1_US);
+  ddr_timer_delay_us(DDR_DELAY_1_US);
 
   /* Reset release */
 #ifdef DDR_INTERACTIVE
@@ -2236,7 +2192,7 @@ static void ddr_reset(void)
   CLEAR_BIT(RCC->DDRCAPBCFGR, RCC_DDRCAPBCFGR_DDRCAPBRST);
   CLEAR_BIT(RCC->DDRCFGR, RCC_DDRCFGR_DDRCFGRST);
 
-  ddr_delay_us(DDR_DELAY_1_US);
+  ddr_timer_delay_us(DDR_DELAY_1_US);
 }
 
 /**
@@ -2247,7 +2203,7 @@ static void ddr_reset(void)
 static int32_t ddr_pll2_configure(void)
 {
 #if defined(USE_STM32MP257CXX_EMU)
-  __IO uint32_t timeout;
+  uint64_t timeout;
 
   WRITE_REG(RCC->PLL2CFGR4, RCC_PLL2CFGR4_VAL);
   WRITE_REG(RCC->PLL2CFGR1, RCC_PLL2CFGR1_VAL1);
@@ -2258,20 +2214,19 @@ static int32_t ddr_pll2_configure(void)
   WRITE_REG(RCC->PLL2CFGR5, RCC_PLL2CFGR5_VAL);
   WRITE_REG(RCC->PLL2CFGR1, RCC_PLL2CFGR1_VAL2);
 
-  ddr_delay_us(DDR_DELAY_1_US);
+  ddr_timer_delay_us(DDR_DELAY_1_US);
 
-  timeout = ddr_timeout_init_us(DDR_TIMEOUT_US_1S);
+  timeout = ddr_timer_timeout_init_us(DDR_TIMEOUT_US_1S);
   while ((READ_REG(DDRDBG->FRAC_PLL_LOCK) & DDRDBG_FRAC_PLL_LOCK_LOCK) !=
          DDRDBG_FRAC_PLL_LOCK_LOCK)
   {
-    timeout--;
 
-    if (ddr_timeout_elapsed(timeout))
+    if (ddr_timer_timeout_elapsed(timeout))
     {
       return -1;
     }
 
-    ddr_delay_us(DDR_DELAY_1_US);
+    ddr_timer_delay_us(DDR_DELAY_1_US);
   }
 #endif /* USE_STM32MP257CXX_EMU */
 
@@ -2330,14 +2285,14 @@ static int32_t ddr_sysconf_configuration(void)
             DDRDBG_LP_DISABLE_LPI_XPI_DISABLE | DDRDBG_LP_DISABLE_LPI_DDRC_DISABLE);
   WRITE_REG(DDRDBG->BYPASS_PCLKEN, 0U);
 
-  ddr_delay_us(DDR_DELAY_1_US);
+  ddr_timer_delay_us(DDR_DELAY_1_US);
 
   WRITE_REG(RCC->DDRPHYCCFGR, RCC_DDRPHYCCFGR_DDRPHYCEN);
 
   WRITE_REG(RCC->DDRCPCFGR, RCC_DDRCPCFGR_DDRCPEN | RCC_DDRCPCFGR_DDRCPLPEN);
   SET_BIT(RCC->DDRITFCFGR, RCC_DDRITFCFGR_DDRRST);
 
-  ddr_delay_us(DDR_DELAY_1_US);
+  ddr_timer_delay_us(DDR_DELAY_1_US);
 #endif /* USE_STM32MP257CXX_EMU */
 
 #if !defined(USE_STM32MP257CXX_EMU)
@@ -2349,7 +2304,7 @@ static int32_t ddr_sysconf_configuration(void)
   WRITE_REG(RCC->DDRPHYCCFGR, RCC_DDRPHYCCFGR_DDRPHYCEN);
   SET_BIT(RCC->DDRITFCFGR, RCC_DDRITFCFGR_DDRRST);
 
-  ddr_delay_us(DDR_DELAY_1_US);
+  ddr_timer_delay_us(DDR_DELAY_1_US);
 #endif /* !defined(USE_STM32MP257CXX_EMU) */
 
   return 0;
@@ -2362,7 +2317,7 @@ static int32_t ddr_sysconf_configuration(void)
   */
 static int32_t wait_refresh_update_done_ack(void)
 {
-  __IO uint32_t timeout;
+  uint64_t timeout;
   uint32_t rfshctl3;
   uint32_t refresh_update_level = DDRC_RFSHCTL3_REFRESH_UPDATE_LEVEL;
 
@@ -2378,13 +2333,12 @@ static int32_t wait_refresh_update_done_ack(void)
     refresh_update_level = 0U;
   }
 
-  timeout = ddr_timeout_init_us(DDR_TIMEOUT_US_1S);
+  timeout = ddr_timer_timeout_init_us(DDR_TIMEOUT_US_1S);
   do
   {
     rfshctl3 = READ_REG(DDRC->RFSHCTL3);
 
-    timeout--;
-    if (ddr_timeout_elapsed(timeout))
+    if (ddr_timer_timeout_elapsed(timeout))
     {
       return -1;
     }
@@ -2408,12 +2362,12 @@ static int32_t disable_refresh(void)
     return -1;
   }
 
-  ddr_delay_us(DDR_DELAY_1_US);
+  ddr_timer_delay_us(DDR_DELAY_1_US);
 
   CLEAR_BIT(DDRC->PWRCTL, DDRC_PWRCTL_POWERDOWN_EN |
                           DDRC_PWRCTL_SELFREF_EN);
 
-  ddr_delay_us(DDR_DELAY_1_US);
+  ddr_timer_delay_us(DDR_DELAY_1_US);
 
   /*
    * Manage quasi-dynamic registers modification
@@ -2424,11 +2378,11 @@ static int32_t disable_refresh(void)
     return -1;
   }
 
-  ddr_delay_us(DDR_DELAY_1_US);
+  ddr_timer_delay_us(DDR_DELAY_1_US);
 
   CLEAR_BIT(DDRC->DFIMISC, DDRC_DFIMISC_DFI_INIT_COMPLETE_EN);
 
-  ddr_delay_us(DDR_DELAY_1_US);
+  ddr_timer_delay_us(DDR_DELAY_1_US);
 
   if (unset_qd3_update_conditions() != 0)
   {
@@ -2450,7 +2404,7 @@ static int32_t restore_refresh(uint32_t rfshctl3, uint32_t pwrctl)
   {
     CLEAR_BIT(DDRC->PWRCTL, DDRC_PWRCTL_SELFREF_SW);
 
-    ddr_delay_us(DDR_DELAY_1_US);
+    ddr_timer_delay_us(DDR_DELAY_1_US);
   }
 
   if ((rfshctl3 & DDRC_RFSHCTL3_DIS_AUTO_REFRESH) == 0U)
@@ -2461,21 +2415,21 @@ static int32_t restore_refresh(uint32_t rfshctl3, uint32_t pwrctl)
       return -1;
     }
 
-    ddr_delay_us(DDR_DELAY_1_US);
+    ddr_timer_delay_us(DDR_DELAY_1_US);
   }
 
   if ((pwrctl & DDRC_PWRCTL_POWERDOWN_EN) != 0U)
   {
     SET_BIT(DDRC->PWRCTL, DDRC_PWRCTL_POWERDOWN_EN);
 
-    ddr_delay_us(DDR_DELAY_1_US);
+    ddr_timer_delay_us(DDR_DELAY_1_US);
   }
 
   if ((pwrctl & DDRC_PWRCTL_SELFREF_EN) != 0U)
   {
     SET_BIT(DDRC->PWRCTL, DDRC_PWRCTL_SELFREF_EN);
 
-    ddr_delay_us(DDR_DELAY_1_US);
+    ddr_timer_delay_us(DDR_DELAY_1_US);
   }
 
   /*
@@ -2487,11 +2441,11 @@ static int32_t restore_refresh(uint32_t rfshctl3, uint32_t pwrctl)
     return -1;
   }
 
-  ddr_delay_us(DDR_DELAY_1_US);
+  ddr_timer_delay_us(DDR_DELAY_1_US);
 
   SET_BIT(DDRC->DFIMISC, DDRC_DFIMISC_DFI_INIT_COMPLETE_EN);
 
-  ddr_delay_us(DDR_DELAY_1_US);
+  ddr_timer_delay_us(DDR_DELAY_1_US);
 
   if (unset_qd3_update_conditions() != 0)
   {
@@ -2513,12 +2467,25 @@ void HAL_DDR_Convert_Case(const char *in_str, char *out_str, bool ToUpper)
   return;
 }
 
+/**
+  * @brief  Called for each register printed by HAL_DDR_Dump_Reg() (weak here).
+  *         Allows the application to log the dumped values in its own format.
+  * @param  name register name
+  * @param  value register value
+  * @retval None
+  */
+__weak void HAL_DDR_DumpRegCallback(__unused const char *name,
+                                    __unused uint32_t value)
+{
+}
+
 static void dump_reg_desc(unsigned long base_addr, const reg_desc_t *desc,
                           bool save)
 {
   uintptr_t ptr;
   char reg_name[strlen(desc->name) + 1];
   char output_dest[50] = "";
+  uint32_t value;
 
   if (save)
   {
@@ -2544,21 +2511,26 @@ static void dump_reg_desc(unsigned long base_addr, const reg_desc_t *desc,
   {
     if (save && (strcmp("SWCTL", desc->name) == 0))
     {
+      value = 0U;
       printf("%s 0x00000000\n\r", output_dest);
     }
     else
     {
+      value = READ_REG(*(volatile uint32_t*)ptr);
 #ifdef __AARCH64__
-      printf("%s 0x%08X\n\r", output_dest, READ_REG(*(volatile uint32_t*)ptr));
+      printf("%s 0x%08X\n\r", output_dest, value);
 #else
-      printf("%s 0x%08lX\n\r", output_dest, READ_REG(*(volatile uint32_t*)ptr));
+      printf("%s 0x%08lX\n\r", output_dest, value);
 #endif
     }
   }
   else
   {
+    value = (uint32_t)*(int *)ptr;
     printf("%s 0x%08X\n\r", output_dest, *(int *)ptr);
   }
+
+  HAL_DDR_DumpRegCallback(desc->name, value);
 }
 
 static void dump_pll_desc(bool save)
@@ -2655,66 +2627,153 @@ static void dump_param_desc(unsigned long par_addr, const reg_desc_t *desc)
 #endif
 }
 
-static const reg_desc_t *found_reg(const char *name, reg_type *type)
+/*
+ * PHY CSRs are isolated from APB once the PHY is in mission mode, so dump
+ * the values captured by the PHY init CSR shadow instead of reading them.
+ */
+static void dump_csr_shadow(void)
 {
-  unsigned int i, j;
-  const reg_desc_t *desc;
-  char reg_name[strlen(name) + 1];
+  uint32_t i;
+  uint32_t csr_addr;
+  uint16_t value;
+  uint32_t issued;
+  uint32_t elided;
+  int32_t ret;
 
-  for (i = 0; i < ARRAY_SIZE(ddr_registers); i++)
+  printf("==phy.csr==\n\r");
+  for (i = 0; (ret = ddrphy_phyinit_csrshadow_getentry(i, &csr_addr, &value)) >= 0; i++)
   {
-    desc = ddr_registers[i].desc;
-    for (j = 0; j < ddr_registers[i].size; j++)
+    if (ret == 0)
     {
-      /* Compare string lengths to avoid data corruption */
-      if (strlen(desc[j].name) > strlen(name))
-      {
-        continue;
-      }
-
-      HAL_DDR_Convert_Case(desc[j].name, reg_name, true); /* convert to upper case */
-      if (strcmp(name, reg_name) == 0)
-      {
-        *type = i;
-        return &desc[j];
-      }
+#ifdef __AARCH64__
+      printf("0x%05X= 0x%04X\n\r", csr_addr, value);
+#else
+      printf("0x%05lX= 0x%04X\n\r", csr_addr, value);
+#endif
     }
   }
 
-  *type = REG_TYPE_NB;
-
-  return NULL;
+  ddrphy_phyinit_csrshadow_getstats(&issued, &elided);
+#ifdef __AARCH64__
+  printf("csr writes: %u issued, %u elided\n\r", issued, elided);
+#else
+  printf("csr writes: %lu issued, %lu elided\n\r", issued, elided);
+#endif
 }
 
-static base_type get_filter(const char *name)
-{
-  char type[strlen(name) + 1];
+/*
+ * Register name index: open addressing hash table of all the ddr_registers[]
+ * descriptors, keyed by their case insensitive name and built on the first
+ * lookup, so that a name is found in one probe (a few on collision) instead
+ * of a scan of all the tables.
+ */
+#define DDR_NB_DESC \
+  (ARRAY_SIZE(ddr_reg_desc) + ARRAY_SIZE(ddr_timing_desc) + \
+   ARRAY_SIZE(ddr_perf_desc) + ARRAY_SIZE(ddr_map_desc) + \
+   ARRAY_SIZE(phy_uib_desc) + ARRAY_SIZE(phy_uia_desc) + \
+   ARRAY_SIZE(phy_uim_desc) + ARRAY_SIZE(phy_uis_desc) + \
+   ARRAY_SIZE(pll_settings_desc) + ARRAY_SIZE(ddr_dyn_desc))
+
+#define DDR_NAME_INDEX_SIZE 512U /* power of 2, load factor kept under 0.5 */
+#define DDR_NAME_INDEX_MASK (DDR_NAME_INDEX_SIZE - 1U)
+
+typedef char ddr_name_index_size_check[((2U * DDR_NB_DESC) <= DDR_NAME_INDEX_SIZE) ? 1 : -1];
 
-  HAL_DDR_Convert_Case(name, type, 0); /* convert to lower case */
+/* Descriptor number + 1 (ddr_registers[] order), 0 for a free slot */
+static uint16_t ddr_name_index[DDR_NAME_INDEX_SIZE];
+static bool ddr_name_index_ready;
 
-  if (strcmp(type, base_name[BASE_DDRCTRL]) == 0)
+static uint32_t name_hash(const char *name)
+{
+  uint32_t hash = 2166136261U; /* FNV-1a */
+
+  while (*name != '\0')
   {
-    return BASE_DDRCTRL;
+    hash ^= (uint32_t)toupper((unsigned char)*name++);
+    hash *= 16777619U;
   }
-  else if (strcmp(type, base_name[BASE_PHY_UI_BASIC]) == 0)
+
+  return hash;
+}
+
+static const reg_desc_t *get_desc(uint32_t nb, reg_type *type)
+{
+  unsigned int i;
+
+  for (i = 0; i < ARRAY_SIZE(ddr_registers); i++)
   {
-    return BASE_PHY_UI_BASIC;
+    if (nb < ddr_registers[i].size)
+    {
+      *type = i;
+      return &ddr_registers[i].desc[nb];
+    }
+    nb -= ddr_registers[i].size;
   }
-  else if (strcmp(type, base_name[BASE_PHY_UI_ADVANCED]) == 0)
+
+  *type = REG_TYPE_NB;
+
+  return NULL;
+}
+
+static void build_name_index(void)
+{
+  unsigned int i, j;
+  uint32_t nb = 0U;
+  uint32_t slot;
+
+  for (i = 0; i < ARRAY_SIZE(ddr_registers); i++)
   {
-    return BASE_PHY_UI_ADVANCED;
+    for (j = 0; j < ddr_registers[i].size; j++, nb++)
+    {
+      slot = name_hash(ddr_registers[i].desc[j].name) & DDR_NAME_INDEX_MASK;
+      while (ddr_name_index[slot] != 0U)
+      {
+        slot = (slot + 1U) & DDR_NAME_INDEX_MASK;
+      }
+      ddr_name_index[slot] = (uint16_t)(nb + 1U);
+    }
   }
-  else if (strcmp(type, base_name[BASE_PHY_UI_MODE_REGISTER]) == 0)
+
+  ddr_name_index_ready = true;
+}
+
+/* Case insensitive lookup of a register or parameter name */
+static const reg_desc_t *found_reg(const char *name, reg_type *type)
+{
+  const reg_desc_t *desc;
+  uint32_t slot;
+
+  if (!ddr_name_index_ready)
   {
-    return BASE_PHY_UI_MODE_REGISTER;
+    build_name_index();
   }
-  else if (strcmp(type, base_name[BASE_PHY_UI_SWIZZLE]) == 0)
+
+  slot = name_hash(name) & DDR_NAME_INDEX_MASK;
+  while (ddr_name_index[slot] != 0U)
   {
-    return BASE_PHY_UI_SWIZZLE;
+    desc = get_desc(ddr_name_index[slot] - 1U, type);
+    if (strcasecmp(name, desc->name) == 0)
+    {
+      return desc;
+    }
+    slot = (slot + 1U) & DDR_NAME_INDEX_MASK;
   }
-  else if (strcmp(type, base_name[BASE_DDR_PLL]) == 0)
+
+  *type = REG_TYPE_NB;
+
+  return NULL;
+}
+
+static base_type get_filter(const char *name)
+{
+  base_type i;
+
+  for (i = BASE_DDRCTRL; i < BASE_NONE; i++)
   {
-    return BASE_DDR_PLL;
+    if (strcasecmp(name, base_name[i]) == 0)
+    {
+      return i;
+    }
   }
 
   return BASE_NONE;
@@ -2748,6 +2807,15 @@ HAL_StatusTypeDef HAL_DDR_Dump_Reg(const char *name, bool save)
   else
   {
     if (name) {
+      char type_name[strlen(name) + 1];
+
+      HAL_DDR_Convert_Case(name, type_name, 0); /* convert to lower case */
+      if (strcmp(type_name, "csr") == 0)
+      {
+        dump_csr_shadow();
+        return HAL_OK;
+      }
+
       filter = get_filter(name);
     }
   }
@@ -2756,7 +2824,7 @@ HAL_StatusTypeDef HAL_DDR_Dump_Reg(const char *name, bool save)
   {
     p_base = ddr_registers[i].base;
     p_name = ddr_registers[i].name;
-    if (!name || (filter == p_base || !strcmp(name, p_name)) || save)
+    if (!name || (filter == p_base || !strcasecmp(name, p_name)) || save)
     {
       result = HAL_OK;
       desc = ddr_registers[i].desc;
@@ -2812,6 +2880,44 @@ HAL_StatusTypeDef HAL_DDR_Dump_Reg(const char *name, bool save)
   return result;
 }
 
+/*
+ * Once the DDR is in normal operating mode, the quasi-dynamic registers are
+ * written with the traffic stopped (SWCTL.sw_done sequence), and the refresh
+ * timings are applied by a refresh update request.
+ */
+static int32_t write_ctl_reg(const reg_desc_t *desc, uint32_t value)
+{
+  volatile uint32_t *reg = (volatile uint32_t *)((uintptr_t)DDRC_BASE + desc->offset);
+  bool running = ((READ_REG(DDRC->STAT) & DDRC_STAT_OPERATING_MODE_Msk) ==
+                  DDRC_STAT_OPERATING_MODE_NORMAL);
+
+  if (!running)
+  {
+    WRITE_REG(*reg, value);
+    return 0;
+  }
+
+  if (desc->qd && (set_qd3_update_conditions() != 0))
+  {
+    return -1;
+  }
+
+  WRITE_REG(*reg, value);
+
+  if (desc->qd && (unset_qd3_update_conditions() != 0))
+  {
+    return -1;
+  }
+
+  if ((desc->offset == offsetof(DDRC_TypeDef, RFSHTMG)) ||
+      (desc->offset == offsetof(DDRC_TypeDef, RFSHTMG1)))
+  {
+    return wait_refresh_update_done_ack();
+  }
+
+  return 0;
+}
+
 void HAL_DDR_Edit_Reg(char *name, char *string)
 {
   uint32_t value;
@@ -2852,7 +2958,10 @@ void HAL_DDR_Edit_Reg(char *name, char *string)
 
   if (base_addr == (void *)DDRC_BASE)
   {
-    WRITE_REG(*(volatile uint32_t*)(base_addr + desc->offset), value);
+    if (write_ctl_reg(desc, value) != 0)
+    {
+      printf("%s update timeout\n\r", reg_name);
+    }
 
 #ifdef __AARCH64__
     printf("%s= 0x%08X\n\r", reg_name,
@@ -2870,6 +2979,54 @@ void HAL_DDR_Edit_Reg(char *name, char *string)
   }
 }
 
+/**
+  * @brief  Reads a DDR controller register, by name (case insensitive).
+  * @param  name register name
+  * @param  value register value
+  * @retval HAL status: HAL_ERROR if not a DDRC register
+  */
+HAL_StatusTypeDef HAL_DDR_Read_Reg(const char *name, uint32_t *value)
+{
+  const reg_desc_t *desc;
+  reg_type type;
+
+  desc = found_reg(name, &type);
+  if (!desc || (ddr_registers[type].base != BASE_DDRCTRL))
+  {
+    return HAL_ERROR;
+  }
+
+  *value = READ_REG(*(volatile uint32_t *)((uintptr_t)DDRC_BASE + desc->offset));
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Writes a DDR controller register, by name (case insensitive),
+  *         with the quasi-dynamic register update sequence once the DDR runs.
+  * @param  name register name
+  * @param  value new register value
+  * @retval HAL status: HAL_ERROR if not a DDRC register or on update timeout
+  */
+HAL_StatusTypeDef HAL_DDR_Write_Reg(const char *name, uint32_t value)
+{
+  const reg_desc_t *desc;
+  reg_type type;
+
+  desc = found_reg(name, &type);
+  if (!desc || (ddr_registers[type].base != BASE_DDRCTRL))
+  {
+    return HAL_ERROR;
+  }
+
+  if (write_ctl_reg(desc, value) != 0)
+  {
+    return HAL_ERROR;
+  }
+
+  return HAL_OK;
+}
+
 static unsigned long get_par_addr(HAL_DDR_ConfigTypeDef *config, reg_type type)
 {
   uint32_t par_addr = 0x0;
@@ -2938,7 +3095,7 @@ HAL_StatusTypeDef HAL_DDR_Dump_Param(HAL_DDR_ConfigTypeDef *config,
 
     p_base = ddr_registers[i].base;
     p_name = ddr_registers[i].name;
-    if (!name || (filter == p_base || !strcmp(name, p_name)))
+    if (!name || (filter == p_base || !strcasecmp(name, p_name)))
     {
       result = HAL_OK;
       desc = ddr_registers[i].desc;
@@ -3011,12 +3168,276 @@ void HAL_DDR_Edit_Param(HAL_DDR_ConfigTypeDef *config, char *name,
   }
 }
 
+/*
+ * Register snapshots: values of all the ddr_registers[] entries (PLL settings
+ * included), taken at each interactive step, on user request or on diff.
+ */
+#define DDR_SNAPSHOT_NB_REGS DDR_NB_DESC
+
+#define DDR_SNAPSHOT_MAGIC     0x53524444U /* "DDRS" */
+#define DDR_SNAPSHOT_VERSION   1U
+#define DDR_SNAPSHOT_NO_CONFIG 0x01U /* no configuration value (dynamic) */
+
+static uint32_t ddr_snapshot[HAL_DDR_SNAPSHOT_NB][DDR_SNAPSHOT_NB_REGS];
+static uint32_t ddr_snapshot_tick[HAL_DDR_SNAPSHOT_NB];
+static uint32_t ddr_snapshot_valid;
+
+static void get_pll_settings(HAL_DDR_PllTypeDef *pll)
+{
+  RCC_PLLInitTypeDef PLL2;
+
+  HAL_RCCEx_GetPLL2Config(&PLL2);
+
+  /*
+   * Mode and SSM settings are not returned by HAL_RCCEx_GetPLL2Config,
+   * this software never changes them.
+   */
+  pll->source = (int32_t)PLL2.PLLSource;
+  pll->mode = DDR_PLL_MODE;
+  pll->fbdiv = (int32_t)PLL2.FBDIV;
+  pll->frefdiv = (int32_t)PLL2.FREFDIV;
+  pll->fracin = (int32_t)PLL2.FRACIN;
+  pll->postdiv1 = (int32_t)PLL2.POSTDIV1;
+  pll->postdiv2 = (int32_t)PLL2.POSTDIV2;
+  pll->state = (int32_t)PLL2.PLLState;
+  pll->ssm_mode = DDR_PLL_SSM_MODE;
+  pll->ssm_spread = DDR_PLL_SSM_SPREAD;
+  pll->ssm_divval = DDR_PLL_SSM_DIVVAL;
+}
+
+static uint32_t snapshot_read(reg_type type, const reg_desc_t *desc,
+                              const HAL_DDR_PllTypeDef *pll)
+{
+  uintptr_t base_addr = (uintptr_t)get_base_addr(ddr_registers[type].base);
+
+  if (type == PLL_SETTINGS)
+  {
+    return *(const uint32_t *)((uintptr_t)pll + desc->par_offset);
+  }
+
+  if (base_addr == (uintptr_t)DDRC_BASE)
+  {
+    return READ_REG(*(volatile uint32_t *)(base_addr + desc->offset));
+  }
+
+  return (uint32_t)*(int32_t *)(base_addr + desc->offset);
+}
+
+static bool snapshot_config(reg_type type, const reg_desc_t *desc,
+                            uint32_t *value)
+{
+  unsigned long par_addr = get_par_addr(&static_ddr_config, type);
+
+  if (!par_addr || (desc->par_offset == INVALID_OFFSET))
+  {
+    return false;
+  }
+
+  *value = *(uint32_t *)(par_addr + desc->par_offset);
+
+  return true;
+}
+
+static bool snapshot_get(uint32_t slot, reg_type type, const reg_desc_t *desc,
+                         uint32_t index, uint32_t *value)
+{
+  if (slot == HAL_DDR_SNAPSHOT_CONFIG)
+  {
+    return snapshot_config(type, desc, value);
+  }
+
+  *value = ddr_snapshot[slot][index];
+
+  return true;
+}
+
+/**
+  * @brief  Reads all the registers and settings in a snapshot slot.
+  * @param  slot snapshot slot, below HAL_DDR_SNAPSHOT_NB
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DDR_Snapshot_Take(uint32_t slot)
+{
+  HAL_DDR_PllTypeDef pll;
+  unsigned int i, j;
+  uint32_t k = 0U;
+
+  if (slot >= HAL_DDR_SNAPSHOT_NB)
+  {
+    return HAL_ERROR;
+  }
+
+  get_pll_settings(&pll);
+
+  for (i = 0; i < ARRAY_SIZE(ddr_registers); i++)
+  {
+    for (j = 0; j < ddr_registers[i].size; j++)
+    {
+      ddr_snapshot[slot][k++] = snapshot_read(i, &ddr_registers[i].desc[j],
+                                              &pll);
+    }
+  }
+
+  ddr_snapshot_tick[slot] = HAL_GetTick();
+  ddr_snapshot_valid |= 1U << slot;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Tells if a snapshot slot is valid.
+  * @param  slot snapshot slot
+  * @param  tick tick when the snapshot was taken
+  * @retval HAL_OK if valid, HAL_ERROR else
+  */
+HAL_StatusTypeDef HAL_DDR_Snapshot_Info(uint32_t slot, uint32_t *tick)
+{
+  if ((slot >= HAL_DDR_SNAPSHOT_NB) || ((ddr_snapshot_valid & (1U << slot)) == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  *tick = ddr_snapshot_tick[slot];
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Prints the registers and settings changed between two snapshots.
+  *         HAL_DDR_SNAPSHOT_NOW is taken first, HAL_DDR_SNAPSHOT_CONFIG is the
+  *         static configuration (dynamic registers are then skipped).
+  * @param  from reference snapshot slot
+  * @param  to compared snapshot slot
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DDR_Snapshot_Diff(uint32_t from, uint32_t to)
+{
+  const reg_desc_t *desc;
+  unsigned int i, j;
+  uint32_t k = 0U;
+  uint32_t changed = 0U;
+  uint32_t tick;
+  uint32_t val_from;
+  uint32_t val_to;
+
+  if ((from == HAL_DDR_SNAPSHOT_NOW) || (to == HAL_DDR_SNAPSHOT_NOW))
+  {
+    HAL_DDR_Snapshot_Take(HAL_DDR_SNAPSHOT_NOW);
+  }
+
+  if (((from != HAL_DDR_SNAPSHOT_CONFIG) &&
+       (HAL_DDR_Snapshot_Info(from, &tick) != HAL_OK)) ||
+      ((to != HAL_DDR_SNAPSHOT_CONFIG) &&
+       (HAL_DDR_Snapshot_Info(to, &tick) != HAL_OK)))
+  {
+    return HAL_ERROR;
+  }
+
+  for (i = 0; i < ARRAY_SIZE(ddr_registers); i++)
+  {
+    for (j = 0; j < ddr_registers[i].size; j++, k++)
+    {
+      desc = &ddr_registers[i].desc[j];
+
+      if (!snapshot_get(from, i, desc, k, &val_from) ||
+          !snapshot_get(to, i, desc, k, &val_to) ||
+          (val_from == val_to))
+      {
+        continue;
+      }
+
+      {
+        char reg_name[strlen(desc->name) + 1];
+
+        HAL_DDR_Convert_Case(desc->name, reg_name, 0); /* convert to lower case */
+        printf("%s.%s: 0x%08X -> 0x%08X\n\r", base_name[ddr_registers[i].base],
+               reg_name, (unsigned int)val_from, (unsigned int)val_to);
+      }
+      changed++;
+    }
+  }
+
+  printf("%u changed\n\r", (unsigned int)changed);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Exports all the snapshots and the static configuration as one
+  *         binary blob, little endian:
+  *         - magic "DDRS", version (16-bit), number of slots (16-bit),
+  *           number of registers, valid slot mask, tick of each slot,
+  *         - for each register: flags (8-bit), name length (8-bit),
+  *           "<type>.<name>" and its value in each slot.
+  *         The static configuration is the last slot.
+  * @param  write output function of the blob, called per field
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_DDR_Snapshot_Export(void (*write)(const void *data,
+                                                        uint32_t len))
+{
+  uint32_t values[HAL_DDR_SNAPSHOT_NB + 1U];
+  uint32_t header[4];
+  const reg_desc_t *desc;
+  unsigned int i, j;
+  uint32_t k = 0U;
+  uint32_t slot;
+  uint8_t info[2];
+  char name[40];
+
+  header[0] = DDR_SNAPSHOT_MAGIC;
+  header[1] = DDR_SNAPSHOT_VERSION | ((HAL_DDR_SNAPSHOT_NB + 1U) << 16);
+  header[2] = DDR_SNAPSHOT_NB_REGS;
+  header[3] = ddr_snapshot_valid | (1U << HAL_DDR_SNAPSHOT_NB);
+  write(header, sizeof(header));
+
+  values[HAL_DDR_SNAPSHOT_NB] = 0U;
+  memcpy(values, ddr_snapshot_tick, sizeof(ddr_snapshot_tick));
+  write(values, sizeof(values));
+
+  for (i = 0; i < ARRAY_SIZE(ddr_registers); i++)
+  {
+    for (j = 0; j < ddr_registers[i].size; j++, k++)
+    {
+      desc = &ddr_registers[i].desc[j];
+
+      for (slot = 0; slot < HAL_DDR_SNAPSHOT_NB; slot++)
+      {
+        values[slot] = ddr_snapshot[slot][k];
+      }
+
+      info[0] = 0U;
+      if (!snapshot_config(i, desc, &values[HAL_DDR_SNAPSHOT_NB]))
+      {
+        values[HAL_DDR_SNAPSHOT_NB] = 0U;
+        info[0] = DDR_SNAPSHOT_NO_CONFIG;
+      }
+
+      (void)snprintf(name, sizeof(name), "%s.%s",
+                     base_name[ddr_registers[i].base], desc->name);
+      info[1] = (uint8_t)strlen(name);
+      write(info, sizeof(info));
+      write(name, info[1]);
+      write(values, sizeof(values));
+    }
+  }
+
+  return HAL_OK;
+}
+
 __weak bool HAL_DDR_Interactive(__attribute__((unused))HAL_DDR_InteractStepTypeDef step)
 {
   return false;
 }
 
-#define INTERACTIVE(step) HAL_DDR_Interactive(step)
+static bool ddr_interactive(HAL_DDR_InteractStepTypeDef step)
+{
+  HAL_DDR_Snapshot_Take(step);
+
+  return HAL_DDR_Interactive(step);
+}
+
+#define INTERACTIVE(step) ddr_interactive(step)
 #endif /* DDR_INTERACTIVE */
 
 /* Exported functions ---------------------------------------------------------*/
@@ -3160,14 +3581,14 @@ start:
     CLEAR_BIT(RCC->DDRITFCFGR, RCC_DDRITFCFGR_DDRPHYDLP);
     SET_BIT(RCC->DDRPHYCCFGR, RCC_DDRPHYCCFGR_DDRPHYCEN);
 
-    ddr_delay_us(DDR_DELAY_1_US);
+    ddr_timer_delay_us(DDR_DELAY_1_US);
 
     /* Disable IO retention */
     SET_BIT(PWR->CR11, PWR_CR11_DDRRETDIS);
 
-    ddr_delay_us(DDR_DELAY_1_US);
+    ddr_timer_delay_us(DDR_DELAY_1_US);
     CLEAR_BIT(RCC->DDRCAPBCFGR, RCC_DDRCAPBCFGR_DDRCAPBRST);
-    ddr_delay_us(DDR_DELAY_1_US);
+    ddr_timer_delay_us(DDR_DELAY_1_US);
 
     if (ddr_pll2_configure() != 0)
     {
@@ -3572,7 +3993,9 @@ HAL_DDR_SelfRefreshModeTypeDef HAL_DDR_SR_ReadMode(void)
 
 /**
   * @brief  Update retention register save area address.
-  *         A default value is defined (last RETRAM 2KB).
+  *         A default value is defined (end of RETRAM). The area holds
+  *         4 + 8 * (MAX_NUM_RET_REGS + 1) bytes: 1044 bytes for DDR3/DDR4,
+  *         2276 bytes for LPDDR4.
   *         Must be used before first HAL_DDR_Init call.
   * @param  base new address.
   * @retval HAL status.
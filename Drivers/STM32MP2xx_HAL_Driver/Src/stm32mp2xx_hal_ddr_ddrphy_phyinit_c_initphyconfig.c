@@ -66,9 +66,9 @@ static void txslewrate_program(void)
         int32_t b_addr;
 
         b_addr = lane << 8;
-        mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TDBYTE |
-                                  c_addr | b_addr | CSR_TXSLEWRATE_ADDR)),
-                      txslewrate);
+        mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TDBYTE |
+                                         c_addr | b_addr | CSR_TXSLEWRATE_ADDR)),
+                             txslewrate);
       }
     }
   }
@@ -133,8 +133,8 @@ static void atxslewrate_program(void)
                              (atxpren << CSR_ATXPREN_LSB) |
                              (atxprep << CSR_ATXPREP_LSB));
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (TANIB | c_addr | CSR_ATXSLEWRATE_ADDR)),
-                  atxslewrate);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (TANIB | c_addr | CSR_ATXSLEWRATE_ADDR)),
+                         atxslewrate);
   }
 }
 
@@ -158,12 +158,12 @@ static void dfidatacsdestmap_program(void)
 
       p_addr = pstate << 20;
 
-      mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER |
-                                CSR_DFIRDDATACSDESTMAP_ADDR)),
-              dfirddatacsdestmap);
-      mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER |
-                                CSR_DFIWRDATACSDESTMAP_ADDR)),
-              dfiwrdatacsdestmap);
+      mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER |
+                                       CSR_DFIRDDATACSDESTMAP_ADDR)),
+                     dfirddatacsdestmap);
+      mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER |
+                                       CSR_DFIWRDATACSDESTMAP_ADDR)),
+                     dfiwrdatacsdestmap);
     }
   }
 }
@@ -213,8 +213,8 @@ static void pllctrl2_program(void)
       pllctrl2 = 0x19U;
     }
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_PLLCTRL2_ADDR)),
-                  pllctrl2);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_PLLCTRL2_ADDR)),
+                         pllctrl2);
   }
 }
 
@@ -260,8 +260,8 @@ static void ardptrinitval_program(void)
       ardptrinitval[pstate]++;
     }
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_ARDPTRINITVAL_ADDR)),
-                  (uint16_t)ardptrinitval[pstate]);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_ARDPTRINITVAL_ADDR)),
+                         (uint16_t)ardptrinitval[pstate]);
   }
 }
 
@@ -290,9 +290,9 @@ static void procodtctl_program(void)
     seq0bgpr4 = (uint16_t)(0x00000000U |
                            (procodtalwayson << CSR_PROCODTALWAYSON_LSB) |
                            (procodtalwaysoff << CSR_PROCODTALWAYSOFF_LSB));
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TINITENG | C0 |
-                              CSR_SEQ0BGPR4_ADDR)),
-                  seq0bgpr4);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TINITENG | C0 |
+                                     CSR_SEQ0BGPR4_ADDR)),
+                         seq0bgpr4);
   }
 }
 #endif /* STM32MP_DDR3_TYPE || STM32MP_DDR4_TYPE */
@@ -380,22 +380,22 @@ static void dbytedllmodecntrl_program(int32_t *twotckrxdqspre)
                                     (twotcktxdqspre << CSR_TWOTCKTXDQSPRE_LSB) |
                                     (twotckrxdqspre[pstate] << CSR_TWOTCKRXDQSPRE_LSB));
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_DQSPREAMBLECONTROL_ADDR)),
-                  dqspreamblecontrol);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_DQSPREAMBLECONTROL_ADDR)),
+                         dqspreamblecontrol);
 
     dbytedllmodecntrl = (uint16_t)(dllrxpreamblemode << CSR_DLLRXPREAMBLEMODE_LSB);
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (TMASTER | CSR_DBYTEDLLMODECNTRL_ADDR)),
-                  dbytedllmodecntrl);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (TMASTER | CSR_DBYTEDLLMODECNTRL_ADDR)),
+                         dbytedllmodecntrl);
 
     dllgainctl = (uint16_t)(dllgainiv | (dllgaintv << CSR_DLLGAINTV_LSB));
     dlllockparam = (uint16_t)(disdllseedsel | (disdllgainivseed << CSR_DISDLLGAINIVSEED_LSB) |
                               (lcdlseed0 << CSR_LCDLSEED0_LSB));
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_DLLLOCKPARAM_ADDR)),
-                  dlllockparam);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_DLLLOCKPARAM_ADDR)),
+                         dlllockparam);
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_DLLGAINCTL_ADDR)),
-                  dllgainctl);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_DLLGAINCTL_ADDR)),
+                         dllgainctl);
   }
 }
 
@@ -458,8 +458,8 @@ static void procodttimectl_program(int32_t *twotckrxdqspre)
       }
     }
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_PROCODTTIMECTL_ADDR)),
-                  procodttimectl);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_PROCODTTIMECTL_ADDR)),
+                         procodttimectl);
   }
 }
 
@@ -514,9 +514,9 @@ static int32_t txodtdrvstren_program(void)
         int32_t b_addr;
 
         b_addr = lane << 8;
-        mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TDBYTE | c_addr | b_addr |
-                                                      CSR_TXODTDRVSTREN_ADDR)),
-                      txodtdrvstren);
+        mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TDBYTE | c_addr | b_addr |
+                                                             CSR_TXODTDRVSTREN_ADDR)),
+                             txodtdrvstren);
       }
     }
   }
@@ -576,9 +576,9 @@ static int32_t tximpedancectrl1_program(void)
         int32_t b_addr;
 
         b_addr = lane << 8;
-        mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TDBYTE | c_addr | b_addr |
-                                                      CSR_TXIMPEDANCECTRL1_ADDR)),
-                      tximpedancectrl1);
+        mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TDBYTE | c_addr | b_addr |
+                                                             CSR_TXIMPEDANCECTRL1_ADDR)),
+                             tximpedancectrl1);
       }
     }
   }
@@ -625,8 +625,8 @@ static int32_t atximpedance_program(void)
     int32_t c_addr;
 
     c_addr = anib << 12;
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (TANIB | c_addr | CSR_ATXIMPEDANCE_ADDR)),
-                  atximpedance);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (TANIB | c_addr | CSR_ATXIMPEDANCE_ADDR)),
+                         atximpedance);
   }
 
   return 0;
@@ -673,7 +673,7 @@ static void dfimode_program(void)
   dfimode = 0x5U;
 #endif /* STM32MP_LPDDR4_TYPE */
 
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (TMASTER | CSR_DFIMODE_ADDR)), dfimode);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (TMASTER | CSR_DFIMODE_ADDR)), dfimode);
 }
 
 /*
@@ -698,7 +698,7 @@ static void dficamode_program(void)
   dficamode = 4U;
 #endif /* STM32MP_LPDDR4_TYPE */
 
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (TMASTER | CSR_DFICAMODE_ADDR)), dficamode);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (TMASTER | CSR_DFICAMODE_ADDR)), dficamode);
 }
 
 /*
@@ -722,7 +722,7 @@ static void caldrvstr0_program(void)
   caldrvstrpd50 = caldrvstrpu50;
   caldrvstr0 = (caldrvstrpu50 << CSR_CALDRVSTRPU50_LSB) | caldrvstrpd50;
 
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (TMASTER | CSR_CALDRVSTR0_ADDR)), caldrvstr0);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (TMASTER | CSR_CALDRVSTR0_ADDR)), caldrvstr0);
 }
 
 /*
@@ -760,8 +760,8 @@ static void caluclkinfo_program(void)
       caluclkticksper1us = 24U;
     }
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_CALUCLKINFO_ADDR)),
-                  caluclkticksper1us);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_CALUCLKINFO_ADDR)),
+                         caluclkticksper1us);
   }
 }
 
@@ -786,6 +786,7 @@ static void calibration_program(void)
 
   calrate = (uint16_t)((calonce << CSR_CALONCE_LSB) | (calinterval << CSR_CALINTERVAL_LSB));
 
+  /* Not shadowed: CalRate starts the calibration engine */
   mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (TMASTER | CSR_CALRATE_ADDR)), calrate);
 }
 
@@ -863,8 +864,8 @@ static void vrefinglobal_program(void)
 
     vrefinglobal = (uint16_t)((globalvrefindac << CSR_GLOBALVREFINDAC_LSB) |
                                globalvrefinsel);
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_VREFINGLOBAL_ADDR)),
-                  vrefinglobal);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_VREFINGLOBAL_ADDR)),
+                         vrefinglobal);
 
     dqdqsrcvcntrl = (uint16_t)((gaincurradj_defval << CSR_GAINCURRADJ_LSB) |
                                (majormodedbyte << CSR_MAJORMODEDBYTE_LSB) |
@@ -883,9 +884,9 @@ static void vrefinglobal_program(void)
         int32_t b_addr;
 
         b_addr = lane << 8;
-        mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TDBYTE | c_addr | b_addr |
-                                                      CSR_DQDQSRCVCNTRL_ADDR)),
-                      dqdqsrcvcntrl);
+        mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TDBYTE | c_addr | b_addr |
+                                                             CSR_DQDQSRCVCNTRL_ADDR)),
+                             dqdqsrcvcntrl);
       }
     }
   }
@@ -909,8 +910,8 @@ static void dfifreqratio_program(void)
 
     dfifreqratio = (uint16_t)userinputbasic.dfifreqratio[pstate];
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_DFIFREQRATIO_ADDR)),
-                  dfifreqratio);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_DFIFREQRATIO_ADDR)),
+                         dfifreqratio);
   }
 }
 
@@ -958,8 +959,8 @@ static void tristatemodeca_program(void)
                                 (ddr2tmode << CSR_DDR2TMODE_LSB) |
                                 (disdynadrtri << CSR_DISDYNADRTRI_LSB));
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_TRISTATEMODECA_ADDR)),
-                  tristatemodeca);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_TRISTATEMODECA_ADDR)),
+                         tristatemodeca);
   }
 }
 
@@ -1004,12 +1005,12 @@ static void dfixlat_program(void)
        */
       dfifreqxlat_dat = pllbypass_dat + 0x5555U;
 
-      mmio_write_16(reg, dfifreqxlat_dat);
+      mmio_write_16_shadow(reg, dfifreqxlat_dat);
     }
     else if (loopvector == 7U)
     {
       /* LP3-entry DfiFreq = 1F */
-      mmio_write_16(reg, 0xF000U);
+      mmio_write_16_shadow(reg, 0xF000U);
     }
     else
     {
@@ -1017,7 +1018,7 @@ static void dfixlat_program(void)
        * Everything else = skip retrain  (could also map to 0000 since retrain
        * code is excluded, but this is cleaner).
        */
-      mmio_write_16(reg, 0x5555U);
+      mmio_write_16_shadow(reg, 0x5555U);
     }
 #elif STM32MP_LPDDR4_TYPE
     if (loopvector == 0U)
@@ -1027,7 +1028,7 @@ static void dfixlat_program(void)
        * StartVec 1 (pll_bypassed).
        */
       dfifreqxlat_dat = pllbypass_dat + skipddc_dat + 0x0000U;
-      mmio_write_16(reg, dfifreqxlat_dat);
+      mmio_write_16_shadow(reg, dfifreqxlat_dat);
     }
     else if (loopvector == 2U)
     {
@@ -1035,12 +1036,12 @@ static void dfixlat_program(void)
        * Retrain only DfiFreq = 08,09,0A,0B)  Use StartVec 4 (1, and maybe 2,3,
        * used by verif).
        */
-      mmio_write_16(reg, 0x4444U);
+      mmio_write_16_shadow(reg, 0x4444U);
     }
     else if (loopvector == 3U)
     {
       /* Phymstr type state change, StartVec 8 */
-      mmio_write_16(reg, 0x8888U);
+      mmio_write_16_shadow(reg, 0x8888U);
     }
     else if (loopvector == 4U)
     {
@@ -1049,17 +1050,17 @@ static void dfixlat_program(void)
        * StartVec 6 (pll_bypassed).
        */
       dfifreqxlat_dat = pllbypass_dat + 0x5555U;
-      mmio_write_16(reg, dfifreqxlat_dat);
+      mmio_write_16_shadow(reg, dfifreqxlat_dat);
     }
     else if (loopvector == 7U)
     {
       /* LP3-entry DfiFreq = 1F */
-      mmio_write_16(reg, 0xF000U);
+      mmio_write_16_shadow(reg, 0xF000U);
     }
     else
     {
       /* Everything else */
-      mmio_write_16(reg, 0x0000U);
+      mmio_write_16_shadow(reg, 0x0000U);
     }
 #endif /* STM32MP_LPDDR4_TYPE */
   }
@@ -1130,10 +1131,10 @@ static void dqdqsrcvcntrl1_program(void)
     c_addr = index * C1;
     if (ddrphy_phyinit_isdbytedisabled(index))
     {
-      mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (c_addr | TDBYTE | CSR_DBYTEMISCMODE_ADDR)),
-                    regdata);
-      mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (c_addr | TDBYTE | CSR_DQDQSRCVCNTRL1_ADDR)),
-                    regdata1);
+      mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (c_addr | TDBYTE | CSR_DBYTEMISCMODE_ADDR)),
+                           regdata);
+      mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (c_addr | TDBYTE | CSR_DQDQSRCVCNTRL1_ADDR)),
+                           regdata1);
     }
     else
     {
@@ -1146,8 +1147,8 @@ static void dqdqsrcvcntrl1_program(void)
       if (lp4dbird == 0)
 #endif /* STM32MP_LPDDR4_TYPE */
       {
-        mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (c_addr | TDBYTE | CSR_DQDQSRCVCNTRL1_ADDR)),
-                      regdata2);
+        mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (c_addr | TDBYTE | CSR_DQDQSRCVCNTRL1_ADDR)),
+                             regdata2);
       } /* DBI */
     } /* DbyteDisable */
   } /* for each dbyte */
@@ -1179,8 +1180,8 @@ static void masterx4config_program(void)
 
   masterx4config = (uint16_t)(x4tg << CSR_X4TG_LSB);
 
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (TMASTER | CSR_MASTERX4CONFIG_ADDR)),
-                masterx4config);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (TMASTER | CSR_MASTERX4CONFIG_ADDR)),
+                       masterx4config);
 }
 
 #if !STM32MP_DDR3_TYPE
@@ -1211,8 +1212,8 @@ static void dmipinpresent_program(void)
     dmipinpresent = (uint16_t)userinputadvanced.lp4dbird[pstate];
 #endif /* STM32MP_LPDDR4_TYPE */
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_DMIPINPRESENT_ADDR)),
-                  dmipinpresent);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (p_addr | TMASTER | CSR_DMIPINPRESENT_ADDR)),
+                         dmipinpresent);
   }
 }
 #endif /* !STM32MP_DDR3_TYPE */
@@ -1320,12 +1321,12 @@ static void aforcetricont_acx4anibdis_program(void)
     {
       acx4anibdis = acx4anibdis | (0x1U << anib);
     }
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (TANIB | c_addr | CSR_AFORCETRICONT_ADDR)),
-                  aforcetricont);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (TANIB | c_addr | CSR_AFORCETRICONT_ADDR)),
+                         aforcetricont);
   }
 
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + 4 * (TMASTER | CSR_ACX4ANIBDIS_ADDR)),
-                acx4anibdis);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + 4 * (TMASTER | CSR_ACX4ANIBDIS_ADDR)),
+                       acx4anibdis);
 }
 
 /*
@@ -0,0 +1,255 @@
+/**
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2020 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/*
+ * This file provides a write-through shadow of the PHY CSR space used during
+ * the PHY initialization steps.  The CSR programming helpers of steps C and I
+ * (and of the skip training path) write through mmio_write_16_shadow(): a
+ * write whose value is already held by the CSR is dropped, and the CSR read
+ * needed by the 16-bit read-modify-write is served from the shadow whenever
+ * the CSR has already been accessed in the current programming window.
+ *
+ * The shadow is only trusted inside a window opened by
+ * ddrphy_phyinit_csrshadow_enable(true): any write done outside the shadowed
+ * helpers (training firmware, PIE code load, user custom writes) may change
+ * the CSR content, so opening a new window invalidates the elision data while
+ * keeping the last programmed values available for dump.
+ *
+ * Only plain configuration CSRs go through the shadow: a CSR whose write
+ * starts an action (CalRate/CalRun) must always be written with
+ * mmio_write_16().
+ */
+
+#include "stm32mp2xx_hal_ddr_ddrphy_phyinit.h"
+
+/*
+ * CSRSHADOW_HASH_BITS log2 of the number of CSRs held by the shadow
+ *
+ * Entries are allocated by open addressing on the CSR address. When no slot
+ * is free in the probe window, the home slot is recycled: the shadow being
+ * write-through, losing an entry only costs the elision of a later write.
+ */
+#ifndef CSRSHADOW_HASH_BITS
+#define CSRSHADOW_HASH_BITS  9U
+#endif /* CSRSHADOW_HASH_BITS */
+#define CSRSHADOW_NB_ENTRIES (1U << CSRSHADOW_HASH_BITS)
+#define CSRSHADOW_MAX_PROBE  8U
+#define CSRSHADOW_FREE       0xFFFFFFFFU
+
+typedef struct {
+  uint32_t address; /* CSR address (PHY address space) */
+  uint32_t data;    /* Last 32-bit APB word written or read */
+  uint16_t gen;     /* Programming window in which data was captured */
+} csrshadow_entry_t;
+
+static csrshadow_entry_t csrshadow[CSRSHADOW_NB_ENTRIES];
+static bool csrshadow_valid;    /* Table content initialized */
+static bool csrshadow_en;       /* Elision allowed (programming window open) */
+static uint16_t csrshadow_gen;  /* Current programming window */
+static uint32_t csrshadow_issued;
+static uint32_t csrshadow_elided;
+
+static uint32_t csrshadow_hash(uint32_t csr_addr)
+{
+  return (csr_addr * 0x9E3779B1U) >> (32U - CSRSHADOW_HASH_BITS); /* Fibonacci hash */
+}
+
+static csrshadow_entry_t *csrshadow_lookup(uint32_t csr_addr, bool alloc)
+{
+  uint32_t home = csrshadow_hash(csr_addr) & (CSRSHADOW_NB_ENTRIES - 1U);
+  uint32_t i;
+
+  for (i = 0U; i < CSRSHADOW_MAX_PROBE; i++)
+  {
+    csrshadow_entry_t *entry = &csrshadow[(home + i) & (CSRSHADOW_NB_ENTRIES - 1U)];
+
+    if (entry->address == csr_addr)
+    {
+      return entry;
+    }
+
+    if (entry->address == CSRSHADOW_FREE)
+    {
+      if (alloc)
+      {
+        entry->address = csr_addr;
+        entry->gen = (uint16_t)(csrshadow_gen - 1U); /* Not trusted yet */
+        return entry;
+      }
+
+      return NULL;
+    }
+  }
+
+  if (alloc)
+  {
+    csrshadow[home].address = csr_addr;
+    csrshadow[home].gen = (uint16_t)(csrshadow_gen - 1U);
+    return &csrshadow[home];
+  }
+
+  return NULL;
+}
+
+/*
+ * Clears the shadow content and the write counters.
+ *
+ * To be called once per PHY initialization, the PHY CSRs being reset.
+ *
+ * \return void
+ */
+void ddrphy_phyinit_csrshadow_reset(void)
+{
+  uint32_t i;
+
+  for (i = 0U; i < CSRSHADOW_NB_ENTRIES; i++)
+  {
+    csrshadow[i].address = CSRSHADOW_FREE;
+  }
+
+  csrshadow_valid = true;
+  csrshadow_en = false;
+  csrshadow_gen = 0U;
+  csrshadow_issued = 0U;
+  csrshadow_elided = 0U;
+}
+
+/*
+ * Opens or closes a shadowed programming window.
+ *
+ * Opening a window invalidates the values captured in previous windows for
+ * elision purpose, as the CSRs may have been changed in between.
+ *
+ * \return void
+ */
+void ddrphy_phyinit_csrshadow_enable(bool enable)
+{
+  if (!csrshadow_valid)
+  {
+    ddrphy_phyinit_csrshadow_reset();
+  }
+
+  if (enable)
+  {
+    csrshadow_gen++;
+  }
+
+  csrshadow_en = enable;
+}
+
+/*
+ * Writes a 16-bit PHY CSR through the shadow.
+ *
+ * Same interface as mmio_write_16(). The write is skipped when the CSR
+ * already holds the value.
+ *
+ * \return void
+ */
+void mmio_write_16_shadow(uintptr_t addr, uint16_t value)
+{
+  csrshadow_entry_t *entry;
+  uint32_t data;
+
+  if (!csrshadow_en)
+  {
+    mmio_write_16(addr, value);
+    csrshadow_issued++;
+    return;
+  }
+
+  entry = csrshadow_lookup((uint32_t)((addr - DDRPHYC_BASE) / 4U), true);
+
+  if (entry->gen == csrshadow_gen)
+  {
+    data = entry->data;
+  }
+  else
+  {
+    data = READ_REG(*(volatile uint32_t *)addr);
+    entry->gen = csrshadow_gen;
+  }
+
+  if ((uint16_t)data == value)
+  {
+    entry->data = data;
+    csrshadow_elided++;
+    return;
+  }
+
+  data &= 0xFFFF0000U;
+  data |= (uint32_t)value;
+  WRITE_REG(*(volatile uint32_t *)addr, data);
+  entry->data = data;
+  csrshadow_issued++;
+}
+
+/*
+ * Reads the last value written or read through the shadow for a CSR.
+ *
+ * \return 0 when the CSR is held by the shadow, -1 otherwise.
+ */
+int32_t ddrphy_phyinit_csrshadow_read(uint32_t csr_addr, uint16_t *value)
+{
+  csrshadow_entry_t *entry;
+
+  if (!csrshadow_valid)
+  {
+    return -1;
+  }
+
+  entry = csrshadow_lookup(csr_addr, false);
+  if (entry == NULL)
+  {
+    return -1;
+  }
+
+  *value = (uint16_t)entry->data;
+
+  return 0;
+}
+
+/*
+ * Gets the shadow entry at a given table index, for sequential dump.
+ *
+ * \return 0 when the entry is used, 1 when it is free, -1 beyond the table.
+ */
+int32_t ddrphy_phyinit_csrshadow_getentry(uint32_t index, uint32_t *csr_addr, uint16_t *value)
+{
+  if (index >= CSRSHADOW_NB_ENTRIES)
+  {
+    return -1;
+  }
+
+  if (!csrshadow_valid || (csrshadow[index].address == CSRSHADOW_FREE))
+  {
+    return 1;
+  }
+
+  *csr_addr = csrshadow[index].address;
+  *value = (uint16_t)csrshadow[index].data;
+
+  return 0;
+}
+
+/*
+ * Gets the number of CSR writes issued on APB and elided by the shadow since
+ * the last ddrphy_phyinit_csrshadow_reset().
+ *
+ * \return void
+ */
+void ddrphy_phyinit_csrshadow_getstats(uint32_t *issued, uint32_t *elided)
+{
+  *issued = csrshadow_issued;
+  *elided = csrshadow_elided;
+}
@@ -37,9 +37,9 @@ static void dfiwrrddatacsconfig_program(void)
   dfiwrdatacspolarity = 0x1U;
   dfirddatacspolarity = 0x1U;
 
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TMASTER | C0 | CSR_DFIWRRDDATACSCONFIG_ADDR))),
-                ((dfiwrdatacspolarity << CSR_DFIWRDATACSPOLARITY_LSB) |
-                 (dfirddatacspolarity << CSR_DFIRDDATACSPOLARITY_LSB)));
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (TMASTER | C0 | CSR_DFIWRRDDATACSCONFIG_ADDR))),
+                       ((dfiwrdatacspolarity << CSR_DFIWRDATACSPOLARITY_LSB) |
+                        (dfirddatacspolarity << CSR_DFIRDDATACSPOLARITY_LSB)));
 }
 #endif /* STM32MP_LPDDR4_TYPE */
 
@@ -108,17 +108,17 @@ static void seq0bdly_program(void)
 
     pscount[3] = (uint16_t)(dlllock_x10 / (10 * 4));
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | C0 | TMASTER | CSR_SEQ0BDLY0_ADDR))),
-                  (uint16_t)pscount[0]);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | C0 | TMASTER | CSR_SEQ0BDLY0_ADDR))),
+                         (uint16_t)pscount[0]);
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | C0 | TMASTER | CSR_SEQ0BDLY1_ADDR))),
-                  (uint16_t)pscount[1]);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | C0 | TMASTER | CSR_SEQ0BDLY1_ADDR))),
+                         (uint16_t)pscount[1]);
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | C0 | TMASTER | CSR_SEQ0BDLY2_ADDR))),
-                  (uint16_t)pscount[2]);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | C0 | TMASTER | CSR_SEQ0BDLY2_ADDR))),
+                         (uint16_t)pscount[2]);
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | C0 | TMASTER | CSR_SEQ0BDLY3_ADDR))),
-                  (uint16_t)pscount[3]);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | C0 | TMASTER | CSR_SEQ0BDLY3_ADDR))),
+                         (uint16_t)pscount[3]);
   }
 }
 
@@ -137,38 +137,38 @@ static void seq0bdisableflag_program(__unused bool skip_training)
 static void seq0bdisableflag_program(bool skip_training)
 #endif /* STM32MP_LPDDR4_TYPE */
 {
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG0_ADDR))),
-                0x0000U);
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG1_ADDR))),
-                0x0173U);
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG2_ADDR))),
-                0x0060U);
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG3_ADDR))),
-                0x6110U);
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG4_ADDR))),
-                0x2152U);
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG5_ADDR))),
-                0xDFBDU);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG0_ADDR))),
+                       0x0000U);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG1_ADDR))),
+                       0x0173U);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG2_ADDR))),
+                       0x0060U);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG3_ADDR))),
+                       0x6110U);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG4_ADDR))),
+                       0x2152U);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG5_ADDR))),
+                       0xDFBDU);
 
 #if STM32MP_DDR3_TYPE || STM32MP_DDR4_TYPE
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG6_ADDR))),
-                0xFFFFU);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG6_ADDR))),
+                       0xFFFFU);
 #elif STM32MP_LPDDR4_TYPE
   if (skip_training || (userinputadvanced.disableretraining != 0) ||
       (userinputbasic.frequency[0] < 333))
   {
     /* Disabling DRAM drift compensation */
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG6_ADDR))),
-                  0xFFFFU);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG6_ADDR))),
+                         0xFFFFU);
   }
   else
   {
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG6_ADDR))),
-                  0x2060U);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG6_ADDR))),
+                         0x2060U);
   }
 #endif /* STM32MP_LPDDR4_TYPE */
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG7_ADDR))),
-                0x6152U);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (TINITENG | CSR_SEQ0BDISABLEFLAG7_ADDR))),
+                       0x6152U);
 }
 
 #if STM32MP_LPDDR4_TYPE
@@ -203,10 +203,10 @@ static void ppttrainsetup_program(void)
         (userinputadvanced.phymstrtraininterval[pstate] << CSR_PHYMSTRTRAININTERVAL_LSB) |
         (userinputadvanced.phymstrmaxreqtoack[pstate] << CSR_PHYMSTRMAXREQTOACK_LSB));
 
-      mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TMASTER | CSR_PPTTRAINSETUP_ADDR))),
-                    ppttrainsetup);
-      mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TMASTER | CSR_PPTTRAINSETUP2_ADDR))),
-                    0x0003U);
+      mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TMASTER | CSR_PPTTRAINSETUP_ADDR))),
+                           ppttrainsetup);
+      mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TMASTER | CSR_PPTTRAINSETUP2_ADDR))),
+                           0x0003U);
     }
   }
 }
@@ -238,13 +238,13 @@ static void acsmplayback_program(void)
 
     for (vec = 0U; vec < 3U; vec++)
     {
-      mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TACSM |
-                                (CSR_ACSMPLAYBACK0X0_ADDR + vec * 2)))),
-                    acsmplayback[0][vec]);
+      mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TACSM |
+                                       (CSR_ACSMPLAYBACK0X0_ADDR + vec * 2)))),
+                           acsmplayback[0][vec]);
 
-      mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TACSM |
-                                (CSR_ACSMPLAYBACK1X0_ADDR + vec * 2)))),
-                    acsmplayback[1][vec]);
+      mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TACSM |
+                                       (CSR_ACSMPLAYBACK1X0_ADDR + vec * 2)))),
+                           acsmplayback[1][vec]);
     }
   }
 }
@@ -265,7 +265,7 @@ static void traininghwreg_program(void)
    *   - Fields: AcsmCkeEnb
    */
   regdata = (0xFU << CSR_ACSMCKEENB_LSB);
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (C0 | TACSM | CSR_ACSMCTRL13_ADDR))), regdata);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (C0 | TACSM | CSR_ACSMCTRL13_ADDR))), regdata);
 
   /*
    * - Register: AcsmCtrl1
@@ -273,7 +273,7 @@ static void traininghwreg_program(void)
    *             Need 19 iterations @ 0.25ui increments to cover 4.5UI
    */
   regdata = (0xEU << CSR_ACSMREPCNT_LSB);
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (C0 | TACSM | CSR_ACSMCTRL1_ADDR))), regdata);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (C0 | TACSM | CSR_ACSMCTRL1_ADDR))), regdata);
 
   /*
    * - Register: TsmByte1, TsmByte2
@@ -288,10 +288,10 @@ static void traininghwreg_program(void)
 
     /* for each chiplet */
     c_addr = (uint32_t)byte * C1;
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (c_addr | TDBYTE | CSR_TSMBYTE1_ADDR))),
-                  0x1U);   /* [15:8] gstep; [7:0]bstep; */
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (c_addr | TDBYTE | CSR_TSMBYTE2_ADDR))),
-                  0x1U);   /* [15:0] good_bar; */
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (c_addr | TDBYTE | CSR_TSMBYTE1_ADDR))),
+                         0x1U);   /* [15:8] gstep; [7:0]bstep; */
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (c_addr | TDBYTE | CSR_TSMBYTE2_ADDR))),
+                         0x1U);   /* [15:0] good_bar; */
 
     regdata = (CSR_DTSMSTATICCMPR_MASK | CSR_DTSMSTATICCMPRVAL_MASK);
 
@@ -301,10 +301,10 @@ static void traininghwreg_program(void)
      *     - DtsmStaticCmpr
      *     - DtsmStaticCmprVal
      */
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (c_addr | TDBYTE | CSR_TSMBYTE3_ADDR))),
-                  regdata);
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (c_addr | TDBYTE | CSR_TSMBYTE5_ADDR))),
-                  0x1U); /* [15:0] bad_bar; */
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (c_addr | TDBYTE | CSR_TSMBYTE3_ADDR))),
+                         regdata);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (c_addr | TDBYTE | CSR_TSMBYTE5_ADDR))),
+                         0x1U); /* [15:0] bad_bar; */
 
     /*
      * - Register: TrainingParam
@@ -320,8 +320,8 @@ static void traininghwreg_program(void)
                (0x3U << CSR_INCDECRATE_LSB));
     regdata = (userinputadvanced.disableretraining != 0) ?
               regdata : (regdata | CSR_TRAINENRXEN_MASK);
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (c_addr | TDBYTE | CSR_TRAININGPARAM_ADDR))),
-                  regdata);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (c_addr | TDBYTE | CSR_TRAININGPARAM_ADDR))),
+                         regdata);
 
     /*
      * - Register: Tsm0
@@ -329,8 +329,8 @@ static void traininghwreg_program(void)
      *     - DtsmEnb
      */
     regdata = 0x1U << CSR_DTSMENB_LSB;
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (c_addr | I0 | TDBYTE | CSR_TSM0_ADDR))),
-                  regdata);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (c_addr | I0 | TDBYTE | CSR_TSM0_ADDR))),
+                         regdata);
 
     /*
      * - Register: Tsm2
@@ -341,8 +341,8 @@ static void traininghwreg_program(void)
     for (vec = 1; vec <= I_MAX; vec++)
     {
       i_addr = (uint32_t)vec * I1;
-      mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (c_addr | i_addr | TDBYTE | CSR_TSM2_ADDR))),
-                    regdata);
+      mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (c_addr | i_addr | TDBYTE | CSR_TSM2_ADDR))),
+                           regdata);
     } /* for vec */
   } /* for byte */
 }
@@ -369,6 +369,7 @@ static void calrate_program(void)
   calrate = (0x1U << CSR_CALRUN_LSB) | (calonce << CSR_CALONCE_LSB) |
             (calinterval << CSR_CALINTERVAL_LSB);
 
+  /* Not shadowed: the CalRun write triggers the calibration */
   mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TMASTER | CSR_CALRATE_ADDR))), calrate);
 }
 
@@ -103,12 +103,12 @@ static void dfimrl_program(void)
       uint32_t c_addr;
 
       c_addr = (uint32_t)byte << 12;
-      mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | CSR_DFIMRL_ADDR))),
-                    dfimrl);
+      mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | CSR_DFIMRL_ADDR))),
+                           dfimrl);
     }
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TMASTER | CSR_HWTMRL_ADDR))),
-                  dfimrl);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TMASTER | CSR_HWTMRL_ADDR))),
+                         dfimrl);
   }
 }
 
@@ -195,25 +195,25 @@ static void txdqsdlytg_program(uint16_t *txdqsdly)
 #if STM32MP_DDR3_TYPE || STM32MP_DDR4_TYPE
         if ((mb_ddr_1d[pstate].cspresent & 0x1) >> 0)
         {
-          mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | u_addr |
-                                                        CSR_TXDQSDLYTG0_ADDR))),
-                        txdqsdly[pstate]);
+          mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | u_addr |
+                                                               CSR_TXDQSDLYTG0_ADDR))),
+                               txdqsdly[pstate]);
         }
 #elif STM32MP_LPDDR4_TYPE
         if ((((mb_ddr_1d[pstate].cspresentcha & 0x1U) >> 0) |
              ((mb_ddr_1d[pstate].cspresentchb & 0x1U) >> 0)) != 0U)
         {
-          mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | u_addr |
-                                                        CSR_TXDQSDLYTG0_ADDR))),
-                        txdqsdly[pstate]);
+          mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | u_addr |
+                                                               CSR_TXDQSDLYTG0_ADDR))),
+                               txdqsdly[pstate]);
         }
 
         if ((((mb_ddr_1d[pstate].cspresentcha & 0x2U) >> 1) |
              ((mb_ddr_1d[pstate].cspresentchb & 0x2U) >> 1)) != 0U)
         {
-          mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | u_addr |
-                                                        CSR_TXDQSDLYTG1_ADDR))),
-                        txdqsdly[pstate]);
+          mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | u_addr |
+                                                               CSR_TXDQSDLYTG1_ADDR))),
+                               txdqsdly[pstate]);
         }
 #endif /* STM32MP_LPDDR4_TYPE */
       }
@@ -290,25 +290,25 @@ static void txdqdlytg_program(uint16_t *txdqsdly)
 #if STM32MP_DDR3_TYPE || STM32MP_DDR4_TYPE
         if (((mb_ddr_1d[pstate].cspresent & 0x1) >> 0) != 0U)
         {
-          mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | r_addr |
-                                                        CSR_TXDQDLYTG0_ADDR))),
-                        txdqdly);
+          mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | r_addr |
+                                                               CSR_TXDQDLYTG0_ADDR))),
+                               txdqdly);
         }
 #elif STM32MP_LPDDR4_TYPE
         if ((((mb_ddr_1d[pstate].cspresentcha & 0x1U) >> 0) |
              ((mb_ddr_1d[pstate].cspresentchb & 0x1U) >> 0)) != 0U)
         {
-          mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | r_addr |
-                                                        CSR_TXDQDLYTG0_ADDR))),
-                        txdqdly);
+          mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | r_addr |
+                                                               CSR_TXDQDLYTG0_ADDR))),
+                               txdqdly);
         }
 
         if ((((mb_ddr_1d[pstate].cspresentcha & 0x2U) >> 1) |
              ((mb_ddr_1d[pstate].cspresentchb & 0x2U) >> 1)) != 0U)
         {
-          mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | r_addr |
-                                                        CSR_TXDQDLYTG1_ADDR))),
-                        txdqdly);
+          mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | r_addr |
+                                                               CSR_TXDQDLYTG1_ADDR))),
+                               txdqdly);
         }
 #endif /* STM32MP_LPDDR4_TYPE */
       }
@@ -412,25 +412,25 @@ static void rxendly_program(void)
 #if STM32MP_DDR3_TYPE || STM32MP_DDR4_TYPE
         if (((mb_ddr_1d[pstate].cspresent & 0x1U) >> 0) != 0U)
         {
-          mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | u_addr |
-                                                        CSR_RXENDLYTG0_ADDR))),
-                        rxendly);
+          mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | u_addr |
+                                                               CSR_RXENDLYTG0_ADDR))),
+                               rxendly);
         }
 #elif STM32MP_LPDDR4_TYPE
         if ((((mb_ddr_1d[pstate].cspresentcha & 0x1U) >> 0) |
              ((mb_ddr_1d[pstate].cspresentchb & 0x1U) >> 0)) != 0U)
         {
-          mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | u_addr |
-                                                        CSR_RXENDLYTG0_ADDR))),
-                        rxendly);
+          mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | u_addr |
+                                                               CSR_RXENDLYTG0_ADDR))),
+                               rxendly);
         }
 
         if ((((mb_ddr_1d[pstate].cspresentcha & 0x2U) >> 1) |
              ((mb_ddr_1d[pstate].cspresentchb & 0x2U) >> 1)) != 0U)
         {
-          mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | u_addr |
-                                                        CSR_RXENDLYTG1_ADDR))),
-                        rxendly);
+          mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr | u_addr |
+                                                               CSR_RXENDLYTG1_ADDR))),
+                               rxendly);
         }
 #endif /* STM32MP_LPDDR4_TYPE */
       }
@@ -601,16 +601,16 @@ static void seq0bgpr_program(void)
 
     /* Program Seq0b_GPRx */
     regdata = (uint16_t)((rl - 5 + extradly) << CSR_ACSMRCASLAT_LSB);
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (ps | C0 | TINITENG | R2 | CSR_SEQ0BGPR1_ADDR))),
-                  regdata);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (ps | C0 | TINITENG | R2 | CSR_SEQ0BGPR1_ADDR))),
+                         regdata);
 
     regdata = (uint16_t)((wl - 5 + extradly) << CSR_ACSMWCASLAT_LSB);
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (ps | C0 | TINITENG | R2 | CSR_SEQ0BGPR2_ADDR))),
-                  regdata);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (ps | C0 | TINITENG | R2 | CSR_SEQ0BGPR2_ADDR))),
+                         regdata);
 
     regdata = (uint16_t)((rl - 5 + extradly + 4 + 8) << CSR_ACSMRCASLAT_LSB);
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (ps | C0 | TINITENG | R2 | CSR_SEQ0BGPR3_ADDR))),
-                  regdata);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (ps | C0 | TINITENG | R2 | CSR_SEQ0BGPR3_ADDR))),
+                         regdata);
   } /* for each p_addr */
 }
 
@@ -636,7 +636,7 @@ static void hwtlpcsen_program(void)
 
   /* Channel A - 1'b01 if signal-rank, 2'b11 if dual-rank */
   hwtlpcsena = (uint16_t)userinputbasic.numrank_dfi0 | 0x1U;
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TMASTER | CSR_HWTLPCSENA_ADDR))), hwtlpcsena);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (TMASTER | CSR_HWTLPCSENA_ADDR))), hwtlpcsena);
 
   /*
    * Channel B - 1'b01 if signal-rank, 2'b11 if dual-rank
@@ -645,21 +645,21 @@ static void hwtlpcsen_program(void)
   if (userinputbasic.dfi1exists == 1 && userinputbasic.numactivedbytedfi1 == 0)
   {
     hwtlpcsenb = (uint16_t)userinputbasic.numrank_dfi0 | 0x1U;
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TMASTER | CSR_HWTLPCSENB_ADDR))),
-                  hwtlpcsenb);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (TMASTER | CSR_HWTLPCSENB_ADDR))),
+                         hwtlpcsenb);
   }
   else if (userinputbasic.dfi1exists == 1 && userinputbasic.numactivedbytedfi1 > 0)
   {
     hwtlpcsenb = (uint16_t)userinputbasic.numrank_dfi1 | 0x1U;
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TMASTER | CSR_HWTLPCSENB_ADDR))),
-                  hwtlpcsenb);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (TMASTER | CSR_HWTLPCSENB_ADDR))),
+                         hwtlpcsenb);
   }
   else
   {
     /* Disable Channel B */
     hwtlpcsenb = 0x0U;
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TMASTER | CSR_HWTLPCSENB_ADDR))),
-                  hwtlpcsenb);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (TMASTER | CSR_HWTLPCSENB_ADDR))),
+                         hwtlpcsenb);
   }
 }
 
@@ -718,15 +718,15 @@ static void pptdqscntinvtrntg_program(void)
         c_addr = (uint32_t)byte << 12;
         if (rank == 0)
         {
-          mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr |
-                                                        CSR_PPTDQSCNTINVTRNTG0_ADDR))),
-                        pptdqscntinvtrntg0);
+          mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr |
+                                                               CSR_PPTDQSCNTINVTRNTG0_ADDR))),
+                               pptdqscntinvtrntg0);
         }
         else if (rank == 1)
         {
-          mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr |
-                                                        CSR_PPTDQSCNTINVTRNTG1_ADDR))),
-                        pptdqscntinvtrntg1);
+          mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TDBYTE | c_addr |
+                                                               CSR_PPTDQSCNTINVTRNTG1_ADDR))),
+                               pptdqscntinvtrntg1);
         }
       }
     }
@@ -793,8 +793,8 @@ static void pptctlstatic_program(void)
                          pptenrxenbackoff << CSR_PPTENRXENBACKOFF_LSB |
                          docbytetg0 << CSR_DOCBYTESELTG0_LSB | docbytetg1 << CSR_DOCBYTESELTG1_LSB);
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (c_addr | TDBYTE | CSR_PPTCTLSTATIC_ADDR))),
-                  regdata);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (c_addr | TDBYTE | CSR_PPTCTLSTATIC_ADDR))),
+                         regdata);
   }
 }
 #endif /* STM32MP_LPDDR4_TYPE */
@@ -838,7 +838,7 @@ static void hwtcamode_program(void)
                          (hwtd4camode << CSR_HWTD4CAMODE_LSB) |
                          (hwtlp3camode << CSR_HWTLP3CAMODE_LSB));
 
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TMASTER | CSR_HWTCAMODE_ADDR))), hwtcamode);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (TMASTER | CSR_HWTCAMODE_ADDR))), hwtcamode);
 }
 
 /*
@@ -913,16 +913,16 @@ static void dllgainctl_dlllockparam_program(void)
                               (CSR_DLLGAINTV_MASK & (dllgaintv << CSR_DLLGAINTV_LSB)) |
                               (CSR_DLLGAINIV_MASK & (dllgainiv << CSR_DLLGAINIV_LSB)));
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TMASTER | CSR_DLLGAINCTL_ADDR))),
-                  wddllgainctl);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TMASTER | CSR_DLLGAINCTL_ADDR))),
+                         wddllgainctl);
 
 
     wddlllockparam = (uint16_t)((CSR_LCDLSEED0_MASK & ((uint16_t)lcdlseed << CSR_LCDLSEED0_LSB)) |
                                 (CSR_DISDLLGAINIVSEED_MASK & 0xFFFFU) |
                                 (CSR_DISDLLSEEDSEL_MASK & 0x0000U));
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TMASTER | CSR_DLLLOCKPARAM_ADDR))),
-                  wddlllockparam);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TMASTER | CSR_DLLLOCKPARAM_ADDR))),
+                         wddlllockparam);
   }
 }
 
@@ -938,7 +938,7 @@ static void acsmctrl23_program(void)
   uint16_t regdata;
 
   regdata = (0x0FU << CSR_ACSMCSMASK_LSB | 0x1U << CSR_ACSMCSMODE_LSB);
-  mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (C0 | TACSM | CSR_ACSMCTRL23_ADDR))), regdata);
+  mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (C0 | TACSM | CSR_ACSMCTRL23_ADDR))), regdata);
 }
 
 /*
@@ -983,10 +983,10 @@ static void pllforcecal_plldacvalin_program(void)
     pllctrl3_gpr = pllctrl3_startup | (uint16_t)((force_cal << CSR_PLLFORCECAL_LSB) |
                                                  (pllencal << CSR_PLLENCAL_LSB));
 
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (TMASTER | CSR_PLLCTRL3_ADDR))),
-                  pllctrl3_startup);
-    mmio_write_16((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TINITENG | CSR_SEQ0BGPR6_ADDR))),
-                  pllctrl3_gpr);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (TMASTER | CSR_PLLCTRL3_ADDR))),
+                         pllctrl3_startup);
+    mmio_write_16_shadow((uintptr_t)(DDRPHYC_BASE + (4U * (p_addr | TINITENG | CSR_SEQ0BGPR6_ADDR))),
+                         pllctrl3_gpr);
   }
 }
 
@@ -41,12 +41,34 @@
  * Array of Address/value pairs used to store register values for the purpose
  * of retention restore.
  */
-#define RETREG_AREA ((MAX_NUM_RET_REGS + 1) * sizeof(reg_addr_val_t))
+#define RETREG_LIST_AREA ((MAX_NUM_RET_REGS + 1) * sizeof(reg_addr_val_t))
+
+/*
+ * Compact restore stream, built from the tracked list when registers are
+ * saved, and stored in place of the address/value list when it fits in its
+ * area. The first word of the retention area then holds
+ * RETREG_PACK_MAGIC | number of words of the stream, instead of the number
+ * of registers.
+ *
+ * Registers are grouped, in tracked order, in runs of registers with a
+ * constant address delta:
+ *  - start address
+ *  - address delta (16 MSB) | number of registers in the run (16 LSB)
+ *  - register values, 2 per word, first register in the 16 LSB
+ */
+#define RETREG_PACK_MAGIC   0x52500000U
+#define RETREG_PACK_MASK    0xFFFF0000U
+#define RETREG_PACK_WORDS   (RETREG_LIST_AREA / sizeof(uint32_t))
+
+#define RETREG_AREA (sizeof(int32_t) + RETREG_LIST_AREA)
 #define RETREG_BASE (RETRAM_BASE + RETRAM_SIZE - RETREG_AREA)
 
 static int32_t *retregsize = (int32_t *)(RETREG_BASE);
 static reg_addr_val_t *retreglist = (reg_addr_val_t *)(RETREG_BASE + sizeof(int32_t));
 
+/* Tracked registers, the retention area only receives the saved values */
+static reg_addr_val_t trackedregs[MAX_NUM_RET_REGS + 1];
+
 static int32_t numregsaved; /* Current Number of registers saved. */
 static int32_t tracken = 1; /* Enabled tracking of registers */
 
@@ -97,7 +119,7 @@ int32_t ddrphy_phyinit_trackreg(uint32_t adr)
   /* Search register address within the array */
   for (regindx = 0; regindx < numregsaved; regindx++)
   {
-    if (retreglist[regindx].address == adr)
+    if (trackedregs[regindx].address == adr)
     {
       /* Register found */
       return 0;
@@ -113,12 +135,126 @@ int32_t ddrphy_phyinit_trackreg(uint32_t adr)
     return -1;
   }
 
-  retreglist[regindx].address = adr;
+  trackedregs[regindx].address = adr;
   numregsaved++;
 
   return 0;
 }
 
+/*
+ * Builds the compact restore stream in the address/value list area.
+ *
+ * \return 0 on success, -1 if the stream does not fit in the area.
+ */
+static int32_t packregs(void)
+{
+  uint32_t *stream = (uint32_t *)retreglist;
+  uint32_t nbwords = 0U;
+  int32_t i = 0;
+
+  while (i < numregsaved)
+  {
+    uint32_t delta = 0U;
+    uint32_t nbregs = 1U;
+    uint32_t k;
+
+    if ((i + 1) < numregsaved)
+    {
+      delta = trackedregs[i + 1].address - trackedregs[i].address;
+    }
+
+    if ((delta != 0U) && (delta <= 0xFFFFU))
+    {
+      while (((i + (int32_t)nbregs) < numregsaved) && (nbregs < 0xFFFFU) &&
+             ((trackedregs[i + (int32_t)nbregs].address -
+               trackedregs[i + (int32_t)nbregs - 1].address) == delta))
+      {
+        nbregs++;
+      }
+    }
+    else
+    {
+      delta = 0U;
+    }
+
+    if ((nbwords + 2U + ((nbregs + 1U) / 2U)) > RETREG_PACK_WORDS)
+    {
+      return -1;
+    }
+
+    stream[nbwords++] = trackedregs[i].address;
+    stream[nbwords++] = (delta << 16) | nbregs;
+
+    for (k = 0U; k < nbregs; k += 2U)
+    {
+      uint32_t data = trackedregs[i + (int32_t)k].value;
+
+      if ((k + 1U) < nbregs)
+      {
+        data |= (uint32_t)trackedregs[i + (int32_t)k + 1].value << 16;
+      }
+
+      stream[nbwords++] = data;
+    }
+
+    i += (int32_t)nbregs;
+  }
+
+  *retregsize = (int32_t)(RETREG_PACK_MAGIC | nbwords);
+
+  return 0;
+}
+
+/*
+ * Replays the compact restore stream.
+ *
+ * PHY CSRs are 16-bit registers on a 32-bit APB word, so each register is
+ * restored with a single write instead of a read-modify-write. Runs are
+ * unrolled by 4 registers.
+ *
+ * \return void
+ */
+static void unpackregs(void)
+{
+  const uint32_t *stream = (const uint32_t *)retreglist;
+  const uint32_t *end = &stream[(uint32_t)*retregsize & ~RETREG_PACK_MASK];
+
+  while (stream < end)
+  {
+    uintptr_t addr = (uintptr_t)(DDRPHYC_BASE + (4U * stream[0]));
+    uintptr_t step = (uintptr_t)(4U * (stream[1] >> 16));
+    uint32_t nbregs = stream[1] & 0xFFFFU;
+    const uint32_t *data = &stream[2];
+
+    stream += 2U + ((nbregs + 1U) / 2U);
+
+    while (nbregs >= 4U)
+    {
+      mmio_write_32(addr, data[0] & 0xFFFFU);
+      mmio_write_32(addr + step, data[0] >> 16);
+      mmio_write_32(addr + (2U * step), data[1] & 0xFFFFU);
+      mmio_write_32(addr + (3U * step), data[1] >> 16);
+      addr += 4U * step;
+      data += 2;
+      nbregs -= 4U;
+    }
+
+    if (nbregs >= 2U)
+    {
+      mmio_write_32(addr, data[0] & 0xFFFFU);
+      mmio_write_32(addr + step, data[0] >> 16);
+      addr += 2U * step;
+      data++;
+      nbregs -= 2U;
+    }
+
+    if (nbregs != 0U)
+    {
+      mmio_write_32(addr, data[0] & 0xFFFFU);
+    }
+  }
+}
+
 /*
  * Register interface function used to track, save and restore retention registers.
  *
@@ -165,11 +301,20 @@ int32_t ddrphy_phyinit_reginterface(reginstr myreginstr, __unused uint32_t adr,
     {
       uint16_t data;
 
-      data = mmio_read_16((uintptr_t)(DDRPHYC_BASE + (4U * retreglist[regindx].address)));
-      retreglist[regindx].value = data;
+      data = mmio_read_16((uintptr_t)(DDRPHYC_BASE + (4U * trackedregs[regindx].address)));
+      trackedregs[regindx].value = data;
     }
 
-    *retregsize = numregsaved;
+    if (packregs() != 0)
+    {
+      /* Stream larger than the list: save the address/value list */
+      for (regindx = 0; regindx < numregsaved; regindx++)
+      {
+        retreglist[regindx] = trackedregs[regindx];
+      }
+
+      *retregsize = numregsaved;
+    }
 
     return 0;
   }
@@ -177,6 +322,14 @@ int32_t ddrphy_phyinit_reginterface(reginstr myreginstr, __unused uint32_t adr,
   {
     int32_t regindx;
 
+    if ((((uint32_t)*retregsize & RETREG_PACK_MASK) == RETREG_PACK_MAGIC) &&
+        (((uint32_t)*retregsize & ~RETREG_PACK_MASK) <= RETREG_PACK_WORDS))
+    {
+      unpackregs();
+
+      return 0;
+    }
+
     /*
      * write PHY registers based on Address, Data value pairs stores in
      * retreglist
@@ -50,8 +50,16 @@ int32_t ddrphy_phyinit_sequence(bool skip_training, bool reten)
   /* (B) Start Clocks and Reset the PHY */
   /* call ddrphy_phyinit_usercustom_b_startclockresetphy() if needed */
 
+  /*
+   * PHY CSRs are in reset state: start a new CSR shadow, used to skip the
+   * redundant writes of steps C and I.
+   */
+  ddrphy_phyinit_csrshadow_reset();
+
   /* (C) Initialize PHY Configuration */
+  ddrphy_phyinit_csrshadow_enable(true);
   ret = ddrphy_phyinit_c_initphyconfig();
+  ddrphy_phyinit_csrshadow_enable(false);
   if (ret != 0)
   {
     return ret;
@@ -76,7 +84,9 @@ int32_t ddrphy_phyinit_sequence(bool skip_training, bool reten)
 
   if (skip_train) {
     /* Skip running training firmware entirely */
+    ddrphy_phyinit_csrshadow_enable(true);
     ddrphy_phyinit_progcsrskiptrain();
+    ddrphy_phyinit_csrshadow_enable(false);
 #ifndef USE_STM32MP257CXX_EMU
   }
   else
@@ -126,7 +136,9 @@ int32_t ddrphy_phyinit_sequence(bool skip_training, bool reten)
   }
 
   /* (I) Load PHY Init Engine Image */
+  ddrphy_phyinit_csrshadow_enable(true);
   ddrphy_phyinit_i_loadpieimage(skip_train);
+  ddrphy_phyinit_csrshadow_enable(false);
 
   /*
    * Customize any CSR write desired to override values programmed by firmware or
@@ -14,6 +14,7 @@
 
 #include "stm32mp2xx_hal.h"
 #include "stm32mp2xx_hal_ddr_ddrphy_phyinit_usercustom.h"
+#include "stm32mp2xx_hal_ddr_timer.h"
 
 /* Firmware major messages */
 #define FW_MAJ_MSG_TRAINING_SUCCESS 0x0000007U
@@ -24,60 +25,90 @@
 #define PHYINIT_DELAY_10US    10UL
 #define PHYINIT_TIMEOUT_US_1S 1000000UL
 
-static void phyinit_udelay(uint64_t delay_us)
-{
-  __IO uint64_t wait_loop_index = 0U;
+/*
+ * Time a new mailbox message is busy polled before the core goes idle: the
+ * firmware posts streaming messages back to back, training steps take longer.
+ */
+#define PHYINIT_SPIN_US       10UL
 
-  wait_loop_index = (delay_us * ((uint64_t)SystemCoreClock / (1000000UL * 2UL)));
+#if defined(__AARCH64__) && !defined(DDR_HOST_SIM)
+/*
+ * Generic timer event stream used to wake the core from WFE while waiting for
+ * a mailbox message: one event each 2^(PHYINIT_EVNTI + 1) counter ticks,
+ * i.e. 16us with STGEN running on HSI at 64MHz.
+ */
+#define PHYINIT_EVNTI         9UL
+#define CNTKCTL_EVNTEN        (1UL << 2)
+#define CNTKCTL_EVNTI_SHIFT   4U
+#define CNTKCTL_EVNTI_MASK    (0xFUL << CNTKCTL_EVNTI_SHIFT)
 
-#ifdef USE_STM32MP257CXX_EMU
-  wait_loop_index /= 100;
-#endif /* USE_STM32MP257CXX_EMU */
+static uint64_t cntkctl_save;
 
-  while(wait_loop_index != 0UL)
-  {
-    wait_loop_index--;
-  }
-}
-
-static __IO uint64_t phyinit_timeout_init_us(uint64_t timeout_us)
+static void phyinit_event_stream_start(void)
 {
-  __IO uint64_t wait_loop_index = 0U;
+  uint64_t cntkctl;
 
-  wait_loop_index = timeout_us * ((uint64_t)SystemCoreClock / (1000000UL * 2UL));
+  __asm volatile("mrs %0, cntkctl_el1" : "=r" (cntkctl));
+  cntkctl_save = cntkctl;
 
-#ifdef USE_STM32MP257CXX_EMU
-  wait_loop_index *= 10;
-#endif /* USE_STM32MP257CXX_EMU */
+  cntkctl &= ~CNTKCTL_EVNTI_MASK;
+  cntkctl |= (PHYINIT_EVNTI << CNTKCTL_EVNTI_SHIFT) | CNTKCTL_EVNTEN;
+  __asm volatile("msr cntkctl_el1, %0\n\tisb" : : "r" (cntkctl));
+}
 
-  return wait_loop_index;
+static void phyinit_event_stream_stop(void)
+{
+  __asm volatile("msr cntkctl_el1, %0\n\tisb" : : "r" (cntkctl_save));
 }
 
-static bool phyinit_timeout_elapsed(__IO uint64_t timeout)
+static void phyinit_wait_event(void)
 {
-  if (timeout == 0U)
-  {
-    return true;
-  }
+  __asm volatile("wfe" : : : "memory");
+}
+#else /* __AARCH64__ && !DDR_HOST_SIM */
+static void phyinit_event_stream_start(void)
+{
+}
 
-  return false;
+static void phyinit_event_stream_stop(void)
+{
 }
 
-static int32_t wait_uctwriteprotshadow(bool state)
+static void phyinit_wait_event(void)
+{
+}
+#endif /* __AARCH64__ && !DDR_HOST_SIM */
+
+/*
+ * Waits for the mailbox write protect shadow to reach a given state.
+ *
+ * When idle is set, the wait is for a new firmware message: after a short
+ * busy poll, HAL_DDR_TrainingIdleCallback() is called and the core waits for
+ * the next timer event between two mailbox reads.
+ *
+ * \return 0 on success, -1 on timeout.
+ */
+static int32_t wait_uctwriteprotshadow(bool state, bool idle)
 {
   uint16_t read_data;
   uint16_t value = state ? 1U : 0U;
-  __IO uint64_t timeout = phyinit_timeout_init_us(PHYINIT_TIMEOUT_US_1S);
+  uint64_t timeout = ddr_timer_timeout_init_us(PHYINIT_TIMEOUT_US_1S);
+  uint64_t spin = ddr_timer_timeout_init_us(PHYINIT_SPIN_US);
 
   do
   {
     read_data = mmio_read_16((uintptr_t)(DDRPHYC_BASE + ((4U * (TAPBONLY |
                                                                 CSR_UCTSHADOWREGS_ADDR)))));
-    timeout--;
-    if (phyinit_timeout_elapsed(timeout))
+    if (ddr_timer_timeout_elapsed(timeout))
     {
       return -1;
     }
+
+    if (idle && ((read_data & 1U) != value) && ddr_timer_timeout_elapsed(spin))
+    {
+      HAL_DDR_TrainingIdleCallback();
+      phyinit_wait_event();
+    }
   } while ((read_data & 1U) != value);
 
   return 0;
@@ -90,9 +121,9 @@ static int32_t ack_message_receipt(void)
   /* Acknowledge the receipt of the message */
   mmio_write_16((uintptr_t)(DDRPHYC_BASE + ((4U * (TAPBONLY | CSR_DCTWRITEPROT_ADDR)))), 0U);
 
-  phyinit_udelay(PHYINIT_DELAY_1US);
+  ddr_timer_delay_us(PHYINIT_DELAY_1US);
 
-  ret = wait_uctwriteprotshadow(true);
+  ret = wait_uctwriteprotshadow(true, false);
   if (ret != 0)
   {
     return ret;
@@ -101,7 +132,7 @@ static int32_t ack_message_receipt(void)
   /* Complete the 4-phase protocol */
   mmio_write_16((uintptr_t)(DDRPHYC_BASE + ((4U * (TAPBONLY | CSR_DCTWRITEPROT_ADDR)))), 1U);
 
-  phyinit_udelay(PHYINIT_DELAY_1US);
+  ddr_timer_delay_us(PHYINIT_DELAY_1US);
 
   return 0;
 }
@@ -111,7 +142,7 @@ static int32_t get_major_message(uint32_t *msg)
   uint32_t message_number;
   int32_t ret;
 
-  ret = wait_uctwriteprotshadow(false);
+  ret = wait_uctwriteprotshadow(false, true);
   if (ret != 0)
   {
     return ret;
@@ -137,7 +168,7 @@ static int32_t get_streaming_message(uint32_t *msg)
   uint32_t stream_word_upper_part;
   int32_t ret;
 
-  ret = wait_uctwriteprotshadow(false);
+  ret = wait_uctwriteprotshadow(false, true);
   if (ret != 0)
   {
     return ret;
@@ -186,11 +217,14 @@ int32_t ddrphy_phyinit_usercustom_g_waitfwdone(void)
 
   VERBOSE("%s Start\n", __func__);
 
+  phyinit_event_stream_start();
+
   do
   {
     ret = get_major_message(&fw_major_message);
     if (ret != 0)
     {
+      phyinit_event_stream_stop();
       return ret;
     }
 
@@ -205,6 +239,7 @@ int32_t ddrphy_phyinit_usercustom_g_waitfwdone(void)
       ret = get_streaming_message(&read_data);
       if (ret != 0)
       {
+        phyinit_event_stream_stop();
         return ret;
       }
 
@@ -215,6 +250,7 @@ int32_t ddrphy_phyinit_usercustom_g_waitfwdone(void)
         ret = get_streaming_message(&read_data);
         if (ret != 0)
         {
+          phyinit_event_stream_stop();
           return ret;
         }
 
@@ -224,7 +260,9 @@ int32_t ddrphy_phyinit_usercustom_g_waitfwdone(void)
   } while ((fw_major_message != FW_MAJ_MSG_TRAINING_SUCCESS) &&
            (fw_major_message != FW_MAJ_MSG_TRAINING_FAILED));
 
-  phyinit_udelay(PHYINIT_DELAY_10US);
+  phyinit_event_stream_stop();
+
+  ddr_timer_delay_us(PHYINIT_DELAY_10US);
 
   if (fw_major_message == FW_MAJ_MSG_TRAINING_FAILED)
   {
@@ -0,0 +1,283 @@
+#!/usr/bin/env python3
+# ******************************************************************************
+# @file      ddr_config_load.py
+# @author    MCD Application Team
+# @brief     Builds the DDR configuration blob loaded by the "load" command of
+#            the STM32MP2 DDR tool, and optionally sends it with XMODEM.
+#*****************************************************************************
+# @attention
+#
+# Copyright (c) 2023 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+#*****************************************************************************
+#
+# The input is a DDR settings header: a template of the DDR tool project
+# (stm32mp2xx-*-template.h) or the output of the "save" command.
+# The blob layout follows HAL_DDR_ConfigTypeDef as declared in
+# stm32mp2xx_hal_ddr.h, see ddr_tool_config.h for the format.
+#
+# Usage:
+#   ddr_config_load.py settings.h -o ddr_config.bin
+#   ddr_config_load.py settings.h -p /dev/ttyACM0 -b 115200   (requires pyserial)
+import os
+import re
+import sys
+import time
+import struct
+import zlib
+import argparse
+
+CONFIG_MAGIC = 0x43524444
+CONFIG_VERSION = 1
+CONFIG_HEADER_SIZE = 64
+CONFIG_NAME_SIZE = 36
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+HAL_INC_DIR = os.path.join(SCRIPT_DIR, '..', '..', 'Drivers', 'STM32MP2xx_HAL_Driver', 'Inc')
+HAL_DDR_HEADER = os.path.join(HAL_INC_DIR, 'stm32mp2xx_hal_ddr.h')
+HAL_RCC_HEADER = os.path.join(HAL_INC_DIR, 'stm32mp2xx_hal_rcc_ex.h')
+
+# Settings macro prefix of each HAL_DDR_ConfigTypeDef member
+MEMBER_PREFIX = {
+    'c_reg': 'DDR_',
+    'c_timing': 'DDR_',
+    'c_map': 'DDR_',
+    'c_perf': 'DDR_',
+    'p_uib': 'DDR_UIB_',
+    'p_uia': 'DDR_UIA_',
+    'p_uim': 'DDR_UIM_',
+    'p_uis': 'DDR_UIS_',
+    'p_pll': 'DDR_PLL_',
+}
+
+
+def _strip_comments(text):
+    text = re.sub(r'/\*.*?\*/', ' ', text, flags=re.S)
+    return re.sub(r'//[^\n]*', '', text)
+
+
+def read_defines(filename):
+    """Returns the object-like macros of a header as strings"""
+    defines = {}
+    with open(filename) as f:
+        text = _strip_comments(f.read())
+    for line in text.splitlines():
+        m = re.match(r'\s*#\s*define\s+(\w+)\s+(.+?)\s*$', line)
+        if m:
+            defines[m.group(1)] = m.group(2)
+    return defines
+
+
+def evaluate(expr, symbols, depth=0):
+    """Evaluates a C integer expression, resolving the macros of symbols"""
+    if depth > 16:
+        raise ValueError("recursive macro in %s" % expr)
+
+    def ident(m):
+        name = m.group(0)
+        if name not in symbols:
+            raise ValueError("undefined symbol %s" % name)
+        return "(%d)" % evaluate(symbols[name], symbols, depth + 1)
+
+    expr = re.sub(r'\b(0[xX][0-9a-fA-F]+|\d+)[uUlL]+\b', r'\1', expr)
+    expr = re.sub(r'\b(?!and\b|or\b|not\b)[A-Za-z_]\w*\b', ident, expr)
+    expr = re.sub(r'\b0+(\d)', r'\1', expr)
+    return int(eval(expr, {"__builtins__": {}}))
+
+
+def preprocess(text, defines):
+    """Minimal #if/#ifdef/#ifndef/#else/#endif handling"""
+    out = []
+    stack = []
+    for line in text.splitlines():
+        m = re.match(r'\s*#\s*(ifdef|ifndef|if|else|endif)\b\s*(.*)', line)
+        if not m:
+            if all(stack):
+                out.append(line)
+            continue
+        directive, arg = m.group(1), m.group(2).strip()
+        if directive == 'ifdef':
+            stack.append(arg in defines)
+        elif directive == 'ifndef':
+            stack.append(arg not in defines)
+        elif directive == 'if':
+            arg = re.sub(r'defined\s*\(?\s*(\w+)\s*\)?',
+                         lambda d: '1' if d.group(1) in defines else '0', arg)
+            arg = arg.replace('&&', ' and ').replace('||', ' or ')
+            arg = re.sub(r'!(?!=)', ' not ', arg)
+            try:
+                stack.append(evaluate(arg, defines) != 0)
+            except ValueError:
+                stack.append(False)
+        elif directive == 'else':
+            stack[-1] = not stack[-1]
+        else:
+            stack.pop()
+    return "\n".join(out)
+
+
+def config_layout(hal_header, defines):
+    """Returns the (member, field, index) list of the blob body"""
+    symbols = dict(read_defines(hal_header))
+    symbols.update(defines)
+
+    with open(hal_header) as f:
+        text = preprocess(_strip_comments(f.read()), symbols)
+
+    structs = {}
+    for m in re.finditer(r'typedef\s+struct\s*\{(.*?)\}\s*(\w+)\s*;', text, re.S):
+        fields = []
+        for decl in m.group(1).split(';'):
+            d = re.match(r'\s*(?:const\s+)?[\w\s]+?\s+\**(\w+)\s*(?:\[(.+)\])?\s*$', decl)
+            if d:
+                nb = evaluate(d.group(2), symbols) if d.group(2) else None
+                fields.append((decl.split()[0], d.group(1), nb))
+        structs[m.group(2)] = fields
+
+    layout = []
+    for struct_type, member, _ in structs['HAL_DDR_ConfigTypeDef']:
+        if member == 'info':
+            continue
+        for ftype, field, nb in structs[struct_type]:
+            if ftype not in ('uint32_t', 'int32_t'):
+                raise ValueError("%s.%s is not a 32-bit field" % (member, field))
+            if nb is None:
+                layout.append((member, field, None))
+            else:
+                for i in range(nb):
+                    layout.append((member, field, i))
+    return layout
+
+
+def build_blob(settings, layout, symbols):
+    words = []
+    for member, field, index in layout:
+        name = MEMBER_PREFIX[member] + field.upper()
+        if index is not None:
+            name += "_%d" % index
+        if name in settings:
+            value = evaluate(settings[name], symbols)
+        elif index:
+            # Only the first P-state is set by the HAL initializer
+            value = 0
+        else:
+            raise ValueError("%s missing in the settings" % name)
+        words.append(value & 0xFFFFFFFF)
+
+    name = settings.get('DDR_MEM_NAME', '""').strip().strip('"').encode('ascii')
+    name = name[:CONFIG_NAME_SIZE - 1].ljust(CONFIG_NAME_SIZE, b'\0')
+    speed = evaluate(settings['DDR_MEM_SPEED'], symbols)
+    size = evaluate(settings['DDR_MEM_SIZE'], symbols)
+
+    body = struct.pack('<%dI' % len(words), *words)
+    header = struct.pack('<IHHIIQ', CONFIG_MAGIC, CONFIG_VERSION, CONFIG_HEADER_SIZE,
+                         len(words), speed, size) + name
+    crc = zlib.crc32(body, zlib.crc32(header)) & 0xFFFFFFFF
+    return header + struct.pack('<I', crc) + body
+
+
+def crc16_xmodem(data):
+    crc = 0
+    for dat in data:
+        crc ^= dat << 8
+        for _ in range(8):
+            if crc & 0x8000:
+                crc = ((crc << 1) ^ 0x1021) & 0xFFFF
+            else:
+                crc = (crc << 1) & 0xFFFF
+    return crc
+
+
+def xmodem_send(port, data, timeout=60):
+    """Sends data with XMODEM-1K, once the receiver requested CRC mode"""
+    deadline = time.time() + timeout
+    read_timeout = port.timeout
+    while True:
+        c = port.read(1)
+        if c == b'C':
+            # The receiver request is followed by silence, unlike a 'C' of text
+            port.timeout = 0.2
+            c = port.read(1)
+            port.timeout = read_timeout
+            if not c:
+                break
+        if c:
+            sys.stdout.write(c.decode('ascii', 'replace'))
+        if time.time() > deadline:
+            raise IOError("receiver not ready")
+
+    data = data + b'\x1A' * (-len(data) % 1024)
+    for blk in range(len(data) // 1024):
+        chunk = data[blk * 1024:(blk + 1) * 1024]
+        seq = (blk + 1) & 0xFF
+        frame = bytes([0x02, seq, 0xFF - seq]) + chunk + struct.pack('>H', crc16_xmodem(chunk))
+        for _ in range(10):
+            port.write(frame)
+            answer = port.read(1)
+            if answer == b'\x06':
+                break
+            if answer == b'\x18':
+                raise IOError("transfer cancelled by the receiver")
+        else:
+            raise IOError("block %d not acknowledged" % (blk + 1))
+
+    for _ in range(10):
+        port.write(b'\x04')
+        if port.read(1) == b'\x06':
+            return
+    raise IOError("end of transfer not acknowledged")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Build and send a DDR tool configuration")
+    parser.add_argument('settings', help='DDR settings header (template or "save" output)')
+    parser.add_argument('-o', '--out_file', help='configuration blob to write')
+    parser.add_argument('-p', '--port', help='serial port of the DDR tool console')
+    parser.add_argument('-b', '--baudrate', type=int, default=115200,
+                        help='serial port baud rate')
+    parser.add_argument('--hal', default=HAL_DDR_HEADER, help='stm32mp2xx_hal_ddr.h')
+    parser.add_argument('--single-axi-port', action='store_true',
+                        help='tool built with STM32MP_DDR_DUAL_AXI_PORT=0')
+    args = parser.parse_args()
+
+    defines = {
+        'DDRC': '1',
+        'DDRPHYC': '1',
+        'DDR_INTERACTIVE': '1',
+        'STM32MP_DDR_DUAL_AXI_PORT': '0' if args.single_axi_port else '1',
+    }
+    symbols = read_defines(HAL_RCC_HEADER) if os.path.exists(HAL_RCC_HEADER) else {}
+    settings = read_defines(args.settings)
+    symbols.update(settings)
+
+    layout = config_layout(args.hal, defines)
+    blob = build_blob(settings, layout, symbols)
+    print("%s: %d words, %d bytes" % (args.settings, len(layout), len(blob)))
+
+    if args.out_file:
+        with open(args.out_file, 'wb') as f:
+            f.write(blob)
+
+    if args.port:
+        try:
+            import serial
+        except ImportError:
+            sys.exit("pyserial is required to send the configuration")
+        port = serial.Serial(args.port, args.baudrate, timeout=1)
+        port.reset_input_buffer()
+        port.write(b'load\r')
+        xmodem_send(port, blob)
+        time.sleep(0.5)
+        sys.stdout.write(port.read(port.in_waiting or 1).decode('ascii', 'replace'))
+        print()
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,201 @@
+#!/usr/bin/env python3
+# ******************************************************************************
+# @file      ddr_replay.py
+# @author    MCD Application Team
+# @brief     Scripted replay of DDR tool console commands, with end-to-end
+#            command latency measurement: host build (ddr_tool_host) or board.
+#*****************************************************************************
+# @attention
+#
+# Copyright (c) 2023 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+#*****************************************************************************
+#
+# Each command of the script (one per line, '#' for comments) is sent after
+# the "DDR>" prompt; its latency is the time from the command sent to the next
+# prompt. The replay ends at the end of the script or when the tool exits.
+#
+# Usage:
+#   ddr_replay.py commands.txt                          runs DDR_Tool/Host/ddr_tool_host
+#   ddr_replay.py commands.txt -x ./ddr_tool_host -n 20 script replayed 20 times
+#   ddr_replay.py commands.txt -p /dev/ttyACM0          board (requires pyserial)
+#   ddr_replay.py commands.txt -o capture.log           console output kept
+import os
+import sys
+import time
+import select
+import argparse
+import subprocess
+
+PROMPT = b'DDR>'
+DEFAULT_TOOL = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                            '..', '..', 'DDR_Tool', 'Host', 'ddr_tool_host')
+
+
+class ProcessConsole:
+    """Console of the host build, on the process stdin/stdout"""
+
+    def __init__(self, tool):
+        self.proc = subprocess.Popen([tool], stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+        self.fd = self.proc.stdout.fileno()
+
+    def write(self, data):
+        self.proc.stdin.write(data)
+        self.proc.stdin.flush()
+
+    def read(self, timeout):
+        """Returns the available output, None at the end of the tool"""
+        if not select.select([self.fd], [], [], timeout)[0]:
+            return b''
+        data = os.read(self.fd, 4096)
+        return data if data else None
+
+    def close(self):
+        if self.proc.poll() is None:
+            self.proc.stdin.close()
+            try:
+                self.proc.wait(5)
+            except subprocess.TimeoutExpired:
+                self.proc.kill()
+
+
+class SerialConsole:
+    """Console of the board, or of the host build on a pseudo terminal"""
+
+    def __init__(self, port, baudrate):
+        try:
+            import serial
+        except ImportError:
+            sys.exit("pyserial is required to use a serial port")
+        self.port = serial.Serial(port, baudrate, timeout=0)
+
+    def write(self, data):
+        self.port.write(data)
+
+    def read(self, timeout):
+        if not select.select([self.port.fileno()], [], [], timeout)[0]:
+            return b''
+        return self.port.read(4096)
+
+    def close(self):
+        self.port.close()
+
+
+class Replay:
+
+    def __init__(self, console, timeout, capture):
+        self.console = console
+        self.timeout = timeout
+        self.capture = capture
+        self.output = b''
+
+    def wait_prompt(self):
+        """Waits for the next prompt, returns False when the tool ended"""
+        deadline = time.monotonic() + self.timeout
+        while True:
+            index = self.output.find(PROMPT)
+            if index >= 0:
+                self.output = self.output[index + len(PROMPT):]
+                return True
+            remaining = deadline - time.monotonic()
+            if remaining <= 0:
+                raise TimeoutError("no prompt within %.1f s" % self.timeout)
+            data = self.console.read(remaining)
+            if data is None:
+                return False
+            if self.capture:
+                self.capture.write(data)
+            # Keep the end of a prompt split between two reads
+            self.output = self.output[-(len(PROMPT) - 1):] + data
+
+    def run(self, commands, loops):
+        latencies = {}
+        total = 0.0
+        count = 0
+
+        if not self.wait_prompt():
+            return latencies, total, count
+
+        for _ in range(loops):
+            for command in commands:
+                start = time.perf_counter()
+                self.console.write(command.encode('ascii') + b'\r')
+                alive = self.wait_prompt()
+                elapsed = time.perf_counter() - start
+                latencies.setdefault(command.split()[0], []).append(elapsed)
+                total += elapsed
+                count += 1
+                if not alive:
+                    return latencies, total, count
+
+        return latencies, total, count
+
+
+def read_script(filename):
+    commands = []
+    with open(filename, 'r') as f:
+        for line in f:
+            line = line.split('#', 1)[0].strip()
+            if line:
+                commands.append(line)
+    return commands
+
+
+def percentile(values, ratio):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(ratio * len(values)))]
+
+
+def print_report(latencies, total, count):
+    print("%-10s %6s %10s %10s %10s %10s" % ("command", "count", "mean ms", "p50 ms",
+                                             "p95 ms", "max ms"))
+    for name, values in sorted(latencies.items()):
+        print("%-10s %6d %10.3f %10.3f %10.3f %10.3f" % (
+            name, len(values), 1000.0 * sum(values) / len(values),
+            1000.0 * percentile(values, 0.5), 1000.0 * percentile(values, 0.95),
+            1000.0 * max(values)))
+    if count:
+        print("%d commands in %.3f s, %.1f commands/s" % (count, total, count / total))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Replay DDR tool commands and measure their latency")
+    parser.add_argument('script', help='console commands, one per line')
+    parser.add_argument('-x', '--tool', default=DEFAULT_TOOL, help='host build of the DDR tool')
+    parser.add_argument('-p', '--port', help='serial port of the DDR tool console, instead of -x')
+    parser.add_argument('-b', '--baudrate', type=int, default=115200,
+                        help='serial port baud rate')
+    parser.add_argument('-n', '--loops', type=int, default=1, help='number of script replays')
+    parser.add_argument('-t', '--timeout', type=float, default=60.0,
+                        help='maximum time of a command in s')
+    parser.add_argument('-o', '--out_file', help='console output to write')
+    args = parser.parse_args()
+
+    commands = read_script(args.script)
+    if args.port:
+        console = SerialConsole(args.port, args.baudrate)
+    else:
+        console = ProcessConsole(args.tool)
+
+    capture = open(args.out_file, 'wb') if args.out_file else None
+    try:
+        latencies, total, count = Replay(console, args.timeout, capture).run(commands, args.loops)
+    except TimeoutError as e:
+        print("error: %s" % e)
+        return 1
+    finally:
+        console.close()
+        if capture:
+            capture.close()
+
+    print_report(latencies, total, count)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
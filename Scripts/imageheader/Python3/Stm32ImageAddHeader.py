@@ -33,6 +33,25 @@ def _stm32image_checksum(image):
     return checksum & 0xffffffff
 
 
+def stm32image_update_checksum(image):
+    """Recomputes the checksum of an image with STM32 header (bytearray)
+    after a change of the binary, returns the header size"""
+    if image[0:4] != b'STM\x32':
+        raise ValueError("no STM32 header")
+    header_major_ver = image[74]
+    if header_major_ver == 1:
+        header_size = 256
+    else:
+        post_headers_length, = struct.unpack_from('<I', image, 104)
+        header_size = 128 + post_headers_length
+    image_length, = struct.unpack_from('<I', image, 76)
+    if header_size + image_length > len(image):
+        raise ValueError("image truncated")
+    checksum = _stm32image_checksum(image[header_size:header_size + image_length])
+    struct.pack_into('<I', image, 68, checksum)
+    return header_size
+
+
 def display_array( name, offset, data ):
     newdata = bytearray(data)
     mystr = ""
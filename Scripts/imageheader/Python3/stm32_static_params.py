@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+# ******************************************************************************
+# @file      stm32_static_params.py
+# @author    MCD Application Team
+# @brief     Python script to patch the DDR settings of a STM32 image
+#*****************************************************************************
+# @attention
+#
+# Copyright (c) 2023 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+#*****************************************************************************
+#
+# Rewrites tab_static_param[] (.STATIC_PARAMS section, firmware built with
+# STM32MP_GATHER_DDRCTRL_SETTING_IN_STATIC_ARRAY) of a .stm32 image with the
+# values of a DDR settings header (template or "save" command output), then
+# recomputes the STM32 header checksum.
+#
+# The table is located in the image by its current content, given either by
+# the elf file of the image or by the settings header used for the build.
+#
+# Usage:
+#   stm32_static_params.py -i in.stm32 -o out.stm32 -s new-settings.h -e fw.elf
+#   stm32_static_params.py -i in.stm32 -o out.stm32 -s new-settings.h -c build-settings.h
+import os
+import re
+import struct
+import argparse
+import Stm32ImageAddHeader
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+HAL_DDR_SOURCE = os.path.join(SCRIPT_DIR, '..', '..', '..', 'Drivers',
+                              'STM32MP2xx_HAL_Driver', 'Src', 'stm32mp2xx_hal_ddr.c')
+
+
+def read_defines(filename):
+    defines = {}
+    with open(filename) as f:
+        text = re.sub(r'/\*.*?\*/', ' ', f.read(), flags=re.S)
+    for line in text.splitlines():
+        m = re.match(r'\s*#\s*define\s+(\w+)\s+(.+?)\s*(//.*)?$', line)
+        if m:
+            defines[m.group(1)] = m.group(2)
+    return defines
+
+
+def evaluate(expr, symbols, depth=0):
+    if depth > 16:
+        raise ValueError("recursive macro in %s" % expr)
+
+    def ident(m):
+        if m.group(0) not in symbols:
+            raise ValueError("undefined symbol %s" % m.group(0))
+        return "(%d)" % evaluate(symbols[m.group(0)], symbols, depth + 1)
+
+    expr = re.sub(r'\b(0[xX][0-9a-fA-F]+|\d+)[uUlL]+\b', r'\1', expr)
+    expr = re.sub(r'\b[A-Za-z_]\w*\b', ident, expr)
+    expr = re.sub(r'\b0+(\d)', r'\1', expr)
+    return int(eval(expr, {"__builtins__": {}}))
+
+
+def static_param_names(source, dual_axi_port):
+    """Returns the macro names of tab_static_param[], in order"""
+    with open(source) as f:
+        text = f.read()
+    m = re.search(r'tab_static_param\[\]\s*=\s*\{(.*?)\};', text, re.S)
+    if not m:
+        raise ValueError("tab_static_param[] not found in %s" % source)
+
+    names = []
+    keep = [True]
+    for line in m.group(1).splitlines():
+        line = re.sub(r'/\*.*?\*/', '', line).strip()
+        if line.startswith('#if'):
+            keep.append(dual_axi_port if 'STM32MP_DDR_DUAL_AXI_PORT' in line else True)
+        elif line.startswith('#else'):
+            keep[-1] = not keep[-1]
+        elif line.startswith('#endif'):
+            keep.pop()
+        elif all(keep):
+            names += [n for n in re.findall(r'\w+', line)]
+    return names
+
+
+def static_param_table(names, settings_file):
+    settings = read_defines(settings_file)
+    values = []
+    for name in names:
+        if name not in settings:
+            raise ValueError("%s missing in %s" % (name, settings_file))
+        values.append(evaluate(settings[name], settings) & 0xFFFFFFFF)
+    return struct.pack('<%dI' % len(values), *values)
+
+
+def elf_static_params(elf_file):
+    from elftools.elf.elffile import ELFFile
+    with open(elf_file, 'rb') as f:
+        section = ELFFile(f).get_section_by_name('.STATIC_PARAMS')
+        if section is None:
+            raise ValueError("no .STATIC_PARAMS section in %s "
+                             "(STM32MP_GATHER_DDRCTRL_SETTING_IN_STATIC_ARRAY not set)" % elf_file)
+        return section.data()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Patch the DDR settings of a STM32 image")
+    parser.add_argument('-i', '--in_file', help='input STM32 image', required=True)
+    parser.add_argument('-o', '--out_file', help='output STM32 image', required=True)
+    parser.add_argument('-s', '--settings', help='new DDR settings header', required=True)
+    parser.add_argument('-e', '--elf_file', help='elf file of the input image')
+    parser.add_argument('-c', '--current', help='DDR settings header of the input image')
+    parser.add_argument('--source', default=HAL_DDR_SOURCE, help='stm32mp2xx_hal_ddr.c')
+    parser.add_argument('--single-axi-port', action='store_true',
+                        help='firmware built with STM32MP_DDR_DUAL_AXI_PORT=0')
+    args = parser.parse_args()
+
+    if not args.elf_file and not args.current:
+        parser.error("the elf file (-e) or the current settings (-c) are required")
+
+    names = static_param_names(args.source, not args.single_axi_port)
+    new_table = static_param_table(names, args.settings)
+
+    if args.elf_file:
+        old_table = elf_static_params(args.elf_file)
+    else:
+        old_table = static_param_table(names, args.current)
+
+    if len(old_table) != len(new_table):
+        raise ValueError("tab_static_param[] of %d bytes in the image, %d expected"
+                         % (len(old_table), len(new_table)))
+
+    with open(args.in_file, 'rb') as f:
+        image = bytearray(f.read())
+
+    offset = image.find(old_table)
+    if offset < 0:
+        raise ValueError("tab_static_param[] not found in %s" % args.in_file)
+    if image.find(old_table, offset + 1) >= 0:
+        raise ValueError("tab_static_param[] found several times in %s" % args.in_file)
+
+    header_size = Stm32ImageAddHeader.stm32image_update_checksum(image)
+    if offset < header_size:
+        raise ValueError("tab_static_param[] found in the STM32 header")
+    if any(image[4:68]):
+        print("Warning: image signature no more valid")
+
+    image[offset:offset + len(new_table)] = new_table
+    Stm32ImageAddHeader.stm32image_update_checksum(image)
+
+    with open(args.out_file, 'wb') as f:
+        f.write(image)
+
+    for i, name in enumerate(names):
+        old, = struct.unpack_from('<I', old_table, 4 * i)
+        new, = struct.unpack_from('<I', new_table, 4 * i)
+        if old != new:
+            print("%-32s 0x%08X -> 0x%08X" % (name, old, new))
+
+    print("tab_static_param[] at offset 0x%X (%d words) patched" % (offset, len(names)))
+    print("Checksum    : 0x%08X" % struct.unpack_from('<I', image, 68))
+    print("%s generated" % args.out_file)
+    return 0
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+# ******************************************************************************
+# @file      log_trace.py
+# @author    MCD Application Team
+# @brief     Decoder of the binary log trace (__LOG_TRACE_IO_).
+#            Rebuilds the log_* messages from a dump of system_log_trace and
+#            from the elf file holding the format strings (.log_fmt section).
+#*****************************************************************************
+# @attention
+#
+# Copyright (c) 2023 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+#*****************************************************************************
+#
+# Dump of the trace, e.g. with gdb:
+#   dump binary value trace.bin system_log_trace
+#
+# Usage:
+#   log_trace.py -e <elf file> -d trace.bin
+import re
+import sys
+import struct
+import argparse
+from elftools.elf.elffile import ELFFile
+
+LOG_TRACE_MAGIC = 0x4C4F4754
+LOG_TRACE_FMT_MASK = 0x00FFFFFF
+
+LEVELS = {1: "ERR  ", 2: "WARN ", 3: "INFO ", 4: "DBG  "}
+
+CONVERSION = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|j|t|L)?([diouxXcsp%])')
+
+
+class TraceElf:
+
+    def __init__(self, elf_file):
+        self.segments = []
+        with open(elf_file, 'rb') as f:
+            elf = ELFFile(f)
+            self.elfclass = elf.elfclass
+            section = elf.get_section_by_name('.log_fmt')
+            if section is None:
+                raise ValueError("no .log_fmt section in %s" % elf_file)
+            self.fmt_addr = section['sh_addr']
+            self.fmt_data = section.data()
+            # Loaded sections, to resolve %s arguments
+            for sect in elf.iter_sections():
+                if sect['sh_flags'] & 0x2 and sect['sh_type'] != 'SHT_NOBITS':
+                    self.segments.append((sect['sh_addr'], sect.data()))
+
+    def format_string(self, fmt_id):
+        offset = (fmt_id - self.fmt_addr) & LOG_TRACE_FMT_MASK
+        end = self.fmt_data.find(b'\0', offset)
+        if offset >= len(self.fmt_data) or end < 0:
+            return None
+        return self.fmt_data[offset:end].decode('ascii', 'replace')
+
+    def string_at(self, addr):
+        for base, data in self.segments:
+            if base <= addr < base + len(data):
+                end = data.find(b'\0', addr - base)
+                return data[addr - base:end].decode('ascii', 'replace')
+        return "<str@0x%x>" % addr
+
+
+def format_message(elf, fmt, args):
+    long_size = 64 if elf.elfclass == 64 else 32
+    args = list(args)
+
+    def convert(m):
+        flags, length, conv = m.groups()
+        if conv == '%':
+            return '%'
+        if not args:
+            return '<missing>'
+        value = args.pop(0)
+        if conv == 's':
+            return ('%' + flags + 's') % elf.string_at(value)
+        if conv == 'p':
+            return '0x%x' % value
+        if length in ('l', 'z', 'j', 't'):
+            bits = long_size
+        elif length == 'll':
+            bits = 64
+        elif length == 'h':
+            bits = 16
+        elif length == 'hh':
+            bits = 8
+        else:
+            bits = 32
+        value &= (1 << bits) - 1
+        if conv in 'di' and value >> (bits - 1):
+            value -= 1 << bits
+        if conv == 'c':
+            return chr(value & 0xFF)
+        return ('%' + flags + (conv if conv != 'u' else 'd')) % value
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def decode(elf, dump):
+    magic, size, head, tail = struct.unpack_from('<4I', dump, 0)
+    if magic != LOG_TRACE_MAGIC:
+        raise ValueError("not a log trace dump (magic 0x%08X)" % magic)
+    words = struct.unpack_from('<%dI' % size, dump, 16)
+
+    pos = tail
+    while pos != head:
+        header = words[pos % size]
+        tick = words[(pos + 1) % size]
+        nargs = (header >> 24) & 0xF
+        level = header >> 28
+        args = []
+        for i in range(nargs):
+            lo = words[(pos + 2 + 2 * i) % size]
+            hi = words[(pos + 3 + 2 * i) % size]
+            args.append(lo | (hi << 32))
+        pos = (pos + 2 + 2 * nargs) & 0xFFFFFFFF
+
+        fmt = elf.format_string(header & LOG_TRACE_FMT_MASK)
+        if fmt is None:
+            text = "<unknown format 0x%06X> %s\n" % (header & LOG_TRACE_FMT_MASK,
+                                                      " ".join("0x%x" % a for a in args))
+        else:
+            text = format_message(elf, fmt, args)
+        yield "[%05d.%03d][%s]%s" % (tick // 1000, tick % 1000,
+                                      LEVELS.get(level, "?    "), text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the binary log trace")
+    parser.add_argument('-e', '--elf_file', help='elf file of the firmware', required=True)
+    parser.add_argument('-d', '--dump_file', help='dump of system_log_trace', required=True)
+    args = parser.parse_args()
+
+    elf = TraceElf(args.elf_file)
+    with open(args.dump_file, 'rb') as f:
+        dump = f.read()
+
+    for text in decode(elf, dump):
+        sys.stdout.write(text.replace('\r', ''))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,251 @@
+#!/usr/bin/env python3
+# ******************************************************************************
+# @file      ddr_record.py
+# @author    MCD Application Team
+# @brief     Decoder of the DDR tool records ("record on" console command).
+#            Extracts the framed CBOR records from a console capture or a
+#            serial port and prints them as JSON lines.
+#*****************************************************************************
+# @attention
+#
+# Copyright (c) 2023 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+#*****************************************************************************
+#
+# Frame (see ddr_tool_record.h):
+#   | 0xA5 | 0x5A | type | seq (LE16) | len (LE16) | CBOR payload | crc (LE16) |
+# crc is the CRC-16/CCITT (poly 0x1021, init 0xFFFF) of type..payload.
+#
+# Usage:
+#   ddr_record.py capture.bin
+#   ddr_record.py -p /dev/ttyACM0 -b 115200 --text     (requires pyserial)
+import sys
+import json
+import struct
+import argparse
+
+SOF = b'\xA5\x5A'
+HEADER_SIZE = 7
+CRC_SIZE = 2
+MAX_PAYLOAD = 256
+
+RECORD_TYPES = {
+    1: "cmd",
+    2: "test",
+    3: "error",
+    4: "reg",
+}
+
+
+def crc16_ccitt(data):
+    crc = 0xFFFF
+    for dat in data:
+        crc ^= dat << 8
+        for _ in range(8):
+            if crc & 0x8000:
+                crc = ((crc << 1) ^ 0x1021) & 0xFFFF
+            else:
+                crc = (crc << 1) & 0xFFFF
+    return crc
+
+
+class CborError(Exception):
+    pass
+
+
+def _cbor_decode(data, pos):
+    if pos >= len(data):
+        raise CborError("truncated item")
+    major = data[pos] >> 5
+    info = data[pos] & 0x1F
+    pos += 1
+
+    if info < 24:
+        arg = info
+    elif info <= 27:
+        nb = 1 << (info - 24)
+        if pos + nb > len(data):
+            raise CborError("truncated argument")
+        arg = int.from_bytes(data[pos:pos + nb], 'big')
+        pos += nb
+    else:
+        raise CborError("unsupported additional info %d" % info)
+
+    if major == 0:
+        return arg, pos
+    if major == 1:
+        return -1 - arg, pos
+    if major in (2, 3):
+        if pos + arg > len(data):
+            raise CborError("truncated string")
+        raw = bytes(data[pos:pos + arg])
+        pos += arg
+        return (raw.decode('ascii', 'replace') if major == 3 else raw.hex()), pos
+    if major == 4:
+        items = []
+        for _ in range(arg):
+            item, pos = _cbor_decode(data, pos)
+            items.append(item)
+        return items, pos
+    if major == 5:
+        items = {}
+        for _ in range(arg):
+            key, pos = _cbor_decode(data, pos)
+            val, pos = _cbor_decode(data, pos)
+            items[key] = val
+        return items, pos
+    raise CborError("unsupported major type %d" % major)
+
+
+def cbor_decode(data):
+    item, pos = _cbor_decode(data, 0)
+    if pos != len(data):
+        raise CborError("%d trailing bytes" % (len(data) - pos))
+    return item
+
+
+class RecordParser:
+    """Splits a byte stream in console text and records"""
+
+    def __init__(self, on_record, on_text=None, on_error=None):
+        self.buf = bytearray()
+        self.on_record = on_record
+        self.on_text = on_text
+        self.on_error = on_error
+        self.last_seq = None
+        self.stats = {"records": 0, "crc_errors": 0, "lost": 0}
+
+    def _text(self, data):
+        if self.on_text is not None and data:
+            self.on_text(bytes(data))
+
+    def _error(self, msg):
+        if self.on_error is not None:
+            self.on_error(msg)
+
+    def feed(self, data):
+        self.buf += data
+
+        while True:
+            idx = self.buf.find(SOF)
+            if idx < 0:
+                # Keep a possible first SOF byte for the next chunk
+                keep = 1 if self.buf[-1:] == SOF[:1] else 0
+                self._text(self.buf[:len(self.buf) - keep])
+                del self.buf[:len(self.buf) - keep]
+                return
+
+            self._text(self.buf[:idx])
+            del self.buf[:idx]
+
+            if len(self.buf) < HEADER_SIZE:
+                return
+
+            rtype, seq, length = struct.unpack_from('<BHH', self.buf, 2)
+            if length > MAX_PAYLOAD:
+                # Not a frame, SOF pattern in text
+                self._text(self.buf[:1])
+                del self.buf[:1]
+                continue
+
+            size = HEADER_SIZE + length + CRC_SIZE
+            if len(self.buf) < size:
+                return
+
+            frame = self.buf[:size]
+            crc, = struct.unpack_from('<H', frame, HEADER_SIZE + length)
+            if crc != crc16_ccitt(frame[2:HEADER_SIZE + length]):
+                self.stats["crc_errors"] += 1
+                self._error("CRC error on frame seq %d" % seq)
+                self._text(self.buf[:1])
+                del self.buf[:1]
+                continue
+
+            del self.buf[:size]
+            self._frame(rtype, seq, frame[HEADER_SIZE:HEADER_SIZE + length])
+
+    def _frame(self, rtype, seq, payload):
+        if self.last_seq is not None:
+            lost = (seq - self.last_seq - 1) & 0xFFFF
+            if lost:
+                self.stats["lost"] += lost
+                self._error("%d record(s) lost before seq %d" % (lost, seq))
+        self.last_seq = seq
+
+        try:
+            data = cbor_decode(payload)
+        except CborError as err:
+            self._error("seq %d: invalid payload (%s)" % (seq, err))
+            return
+
+        self.stats["records"] += 1
+        self.on_record({"seq": seq,
+                        "type": RECORD_TYPES.get(rtype, rtype),
+                        "data": data})
+
+
+def _open_input(args):
+    if args.port:
+        try:
+            import serial
+        except ImportError:
+            sys.exit("pyserial is required to read from a serial port")
+        port = serial.Serial(args.port, args.baudrate, timeout=0.1)
+        return lambda: port.read(4096), False
+    if args.file == '-':
+        stream = sys.stdin.buffer
+    else:
+        stream = open(args.file, 'rb')
+    return lambda: stream.read(4096), True
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the DDR tool records")
+    parser.add_argument('file', nargs='?', default='-',
+                        help='console capture, - for stdin (default)')
+    parser.add_argument('-p', '--port', help='serial port to read from')
+    parser.add_argument('-b', '--baudrate', type=int, default=115200,
+                        help='serial port baud rate')
+    parser.add_argument('-o', '--out_file', help='JSON lines output file')
+    parser.add_argument('-t', '--text', action='store_true',
+                        help='also print the console text on stderr')
+    args = parser.parse_args()
+
+    out = open(args.out_file, 'w') if args.out_file else sys.stdout
+
+    def on_record(record):
+        out.write(json.dumps(record) + "\n")
+        out.flush()
+
+    def on_text(data):
+        sys.stderr.write(data.decode('ascii', 'replace'))
+
+    def on_error(msg):
+        sys.stderr.write("\n[ddr_record] %s\n" % msg)
+
+    rec = RecordParser(on_record, on_text if args.text else None, on_error)
+    read, stop_on_eof = _open_input(args)
+
+    try:
+        while True:
+            data = read()
+            if not data:
+                if stop_on_eof:
+                    break
+                continue
+            rec.feed(data)
+    except KeyboardInterrupt:
+        pass
+
+    sys.stderr.write("[ddr_record] %(records)d records, %(crc_errors)d CRC errors, "
+                     "%(lost)d lost\n" % rec.stats)
+    return 1 if rec.stats["crc_errors"] or rec.stats["lost"] else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+# ******************************************************************************
+# @file      ddr_snapshot.py
+# @author    MCD Application Team
+# @brief     Decoder of the DDR register snapshots ("snap export" command of
+#            the STM32MP2 DDR tool).
+#*****************************************************************************
+# @attention
+#
+# Copyright (c) 2023 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+#*****************************************************************************
+#
+# The export is an Intel HEX image of the snapshot blob, see
+# HAL_DDR_Snapshot_Export(), read from a console capture.
+# Slots: 0 to 3 = DDR tool steps, 4 = user, now, cfg (static configuration).
+#
+# Usage:
+#   ddr_snapshot.py capture.log                       prints all the snapshots
+#   ddr_snapshot.py capture.log -d 0 3                registers changed from 0 to 3
+#   ddr_snapshot.py capture.log -c other.log -s 3     slot 3 of two captures
+#   ddr_snapshot.py capture.log -o snapshot.bin       writes the binary blob
+import sys
+import struct
+import argparse
+
+SNAPSHOT_MAGIC = 0x53524444
+SNAPSHOT_NO_CONFIG = 0x01
+SLOT_NAMES = ['0', '1', '2', '3', 'user', 'now', 'cfg']
+
+
+def read_ihex(filename):
+    """Returns the data of the Intel HEX records found in a console capture"""
+    data = bytearray()
+    base = 0
+    with open(filename, 'r', errors='replace') as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith(':'):
+                continue
+            record = bytes.fromhex(line[1:])
+            if sum(record) & 0xFF:
+                raise ValueError("checksum error: %s" % line)
+            length, addr, rtype = record[0], (record[1] << 8) | record[2], record[3]
+            if rtype == 0x00:
+                addr += base
+                if addr != len(data):
+                    raise ValueError("record at 0x%X missing or out of order" % len(data))
+                data += record[4:4 + length]
+            elif rtype == 0x04:
+                base = ((record[4] << 8) | record[5]) << 16
+            elif rtype == 0x01:
+                return bytes(data)
+    raise ValueError("no complete snapshot export in %s" % filename)
+
+
+class Snapshot:
+
+    def __init__(self, blob):
+        magic, version, nb_slots, nb_regs, valid = struct.unpack_from('<IHHII', blob, 0)
+        if magic != SNAPSHOT_MAGIC:
+            raise ValueError("not a DDR snapshot (magic 0x%08X)" % magic)
+        if version != 1:
+            raise ValueError("unsupported snapshot version %d" % version)
+
+        self.nb_slots = nb_slots
+        self.valid = valid
+        offset = 16
+        self.ticks = struct.unpack_from('<%dI' % nb_slots, blob, offset)
+        offset += 4 * nb_slots
+
+        self.regs = []
+        for _ in range(nb_regs):
+            flags, length = struct.unpack_from('<BB', blob, offset)
+            offset += 2
+            name = blob[offset:offset + length].decode('ascii')
+            offset += length
+            values = list(struct.unpack_from('<%dI' % nb_slots, blob, offset))
+            offset += 4 * nb_slots
+            if flags & SNAPSHOT_NO_CONFIG:
+                values[-1] = None
+            self.regs.append((name, values))
+
+    def slot(self, name):
+        index = SLOT_NAMES.index(name)
+        if not self.valid & (1 << index):
+            raise ValueError("snapshot %s not taken" % name)
+        return index
+
+    def values(self, slot):
+        index = self.slot(slot)
+        return {name: values[index] for name, values in self.regs}
+
+
+def print_diff(ref, new, label_ref, label_new):
+    changed = 0
+    for name in ref:
+        if name not in new or ref[name] is None or new[name] is None:
+            continue
+        if ref[name] != new[name]:
+            print("%-32s 0x%08X -> 0x%08X" % (name, ref[name], new[name]))
+            changed += 1
+    print("%s -> %s: %d changed" % (label_ref, label_new, changed))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode DDR register snapshots")
+    parser.add_argument('capture', help='console capture with the "snap export" output')
+    parser.add_argument('-d', '--diff', nargs=2, metavar=('A', 'B'), choices=SLOT_NAMES,
+                        help='registers changed from snapshot A to B')
+    parser.add_argument('-c', '--compare', help='other capture (e.g. other boot)')
+    parser.add_argument('-s', '--slot', default='3', choices=SLOT_NAMES,
+                        help='snapshot compared with -c (default: 3)')
+    parser.add_argument('-o', '--out_file', help='binary blob to write')
+    args = parser.parse_args()
+
+    blob = read_ihex(args.capture)
+    snap = Snapshot(blob)
+
+    if args.out_file:
+        with open(args.out_file, 'wb') as f:
+            f.write(blob)
+
+    if args.diff:
+        print_diff(snap.values(args.diff[0]), snap.values(args.diff[1]),
+                   args.diff[0], args.diff[1])
+    elif args.compare:
+        other = Snapshot(read_ihex(args.compare))
+        print_diff(snap.values(args.slot), other.values(args.slot),
+                   args.capture, args.compare)
+    else:
+        slots = [i for i in range(snap.nb_slots) if snap.valid & (1 << i)]
+        print("%-32s %s" % ("register", " ".join("%10s" % SLOT_NAMES[i] for i in slots)))
+        for name, values in snap.regs:
+            print("%-32s %s" % (name, " ".join(
+                "%10s" % ("-" if values[i] is None else "0x%08X" % values[i]) for i in slots)))
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())